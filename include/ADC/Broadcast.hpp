@@ -0,0 +1,143 @@
+#pragma once
+
+#include "ADC/Continuous.hpp"
+#include "EventLoop.hpp"
+#include "Testing.hpp"
+
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace esp {
+    namespace adc {
+        class ADCBroadcast;
+        using ADCBroadcastPtr = std::shared_ptr<ADCBroadcast>;
+
+        class ADCBroadcastConsumer;
+        using ADCBroadcastConsumerPtr = std::shared_ptr<ADCBroadcastConsumer>;
+
+        // What happens when the producer needs the frame slot a consumer hasn't finished with.
+        enum class ADCSlowConsumerPolicy : uint8_t {
+            // The consumer's oldest unread frames are released and counted as dropped.
+            Drop,
+            // The producer waits for the consumer, so the driver's pool absorbs the backlog and may overflow.
+            Block,
+            // The consumer never holds frames back.  Once lapped it resumes at the newest frame, and a frame overwritten while it was
+            // acquired is reported when it is released.
+            Lag,
+        };
+
+        struct ADCBroadcastConfig {
+            // Frames of the ADCContinuous conversion frame size held in the shared ring.
+            size_t frameCount;
+            uint32_t memoryCapabilities = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+
+            TaskInfo taskInfo;
+            uint32_t readTimeoutMs = 100;
+        };
+
+        struct ADCBroadcastConsumerConfig {
+            ADCSlowConsumerPolicy policy = ADCSlowConsumerPolicy::Drop;
+        };
+
+        // Fans one ADCContinuous out to any number of consumers.  A drain task reads conversion frames straight into a shared ring and
+        // every consumer walks the ring with its own cursor, borrowing frames in place, so memory use doesn't grow with the number of
+        // consumers.  A slot is reused only once every Drop and Block consumer has moved past the frame it holds.
+        class ADCBroadcast : public std::enable_shared_from_this<ADCBroadcast> {
+        public:
+            // Construct an ADCBroadcast by requesting one from an ADCContinuous.
+            ~ADCBroadcast();
+
+            // Consumers start at the next frame to be published.
+            ADCBroadcastConsumerPtr addConsumer(const ADCBroadcastConsumerConfig& config, esp_err_t& err);
+
+            void start(esp_err_t& err);
+            void stop(esp_err_t& err);
+
+            size_t frameSize() const { return _frameSize; }
+
+            uint64_t framesPublished() const;
+
+            PRIVATE_UNLESS_TESTING
+            // Publish a frame as if the drain task had read it.  Returns ESP_ERR_TIMEOUT if a Block consumer holds the slot it needs.
+            void publish(std::span<const uint8_t> frame, esp_err_t& err);
+
+        private:
+            ADCBroadcast(ADCContinuousPtr adc, const ADCBroadcastConfig& config, esp_err_t& err);
+
+            struct Slot {
+                // Bumped each time the slot is claimed for a new frame, so Lag consumers can tell their frame was overwritten.
+                uint32_t sequence = 0;
+                size_t size = 0;
+            };
+
+            static void _drainTask(void* userInfo);
+            void _drain();
+
+            uint8_t* _claim(esp_err_t& err);
+            void _commit(size_t size);
+
+            void _removeConsumer(ADCBroadcastConsumer* consumer);
+
+            ADCContinuousPtr _adc;
+            ADCBroadcastConfig _config;
+            size_t _frameSize = 0;
+
+            uint8_t* _ring = nullptr;
+            std::unique_ptr<Slot[]> _slots;
+
+            mutable std::mutex _mutex;
+            std::condition_variable _published;
+            std::condition_variable _released;
+            uint64_t _framesPublished = 0;
+            std::vector<ADCBroadcastConsumer*> _consumers;
+
+            TaskHandle_t _task = nullptr;
+            TaskHandle_t _stoppingTask = nullptr;
+            std::atomic<bool> _running = false;
+
+            static constexpr char _loggingTag[] = "esp::ADCBroadcast";
+
+            friend class ADCContinuous;
+            friend class ADCBroadcastConsumer;
+        };
+
+        class ADCBroadcastConsumer {
+        public:
+            // Construct an ADCBroadcastConsumer by requesting one from an ADCBroadcast.
+            ~ADCBroadcastConsumer();
+
+            // Wait for the next frame and borrow it in place until release.
+            std::span<const uint8_t> acquire(uint32_t timeoutMs, esp_err_t& err);
+
+            // Return the borrowed frame.  Lag consumers get ESP_ERR_INVALID_STATE if it was overwritten while they held it.
+            void release(esp_err_t& err);
+
+            // Frames this consumer skipped because it fell behind.
+            uint64_t framesDropped() const;
+
+        private:
+            ADCBroadcastConsumer(ADCBroadcastPtr broadcast, const ADCBroadcastConsumerConfig& config, uint64_t cursor);
+
+            ADCBroadcastPtr _broadcast;
+            ADCBroadcastConsumerConfig _config;
+
+            // Guarded by the broadcast's mutex.
+            uint64_t _cursor;
+            uint64_t _framesDropped = 0;
+            bool _holding = false;
+            uint32_t _heldSequence = 0;
+
+            static constexpr char _loggingTag[] = "esp::ADCBroadcastConsumer";
+
+            friend class ADCBroadcast;
+        };
+    }  // namespace adc
+}  // namespace esp
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ADC/Types.hpp"
+
+#include <esp_err.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace esp {
+    namespace adc {
+        // A lossless block codec for 16 bit channel streams.  Each block picks the best of no prediction, delta or linear prediction and then
+        // Rice codes the residuals, or falls back to packing the samples at the narrowest width that holds them.  Every block carries its
+        // own warm-up samples and first sample index, so blocks decode independently of each other.  Indices and times are kept exactly: a
+        // block whose samples don't sit on a uniform step, after dropped conversions for instance, carries the differences after its values.
+        class ADCCodec {
+        public:
+            static constexpr size_t kHeaderSize = 25;
+            // Up to 32 bits each for the index gap and time residual of every sample in an irregular block.
+            static constexpr size_t kMaximumTimingBytesPerSample = 8;
+            // Encoded blocks never exceed maximumBlockSize, which must fit the 16 bit block length in the header.
+            static constexpr size_t kMaximumSamplesPerBlock = (UINT16_MAX - kHeaderSize) / (2 + kMaximumTimingBytesPerSample);
+
+            static constexpr size_t maximumBlockSize(size_t samples) { return kHeaderSize + (2 + kMaximumTimingBytesPerSample) * samples; }
+
+            // Encode samples as a single block, returning the number of bytes written to output.  Fails with ESP_ERR_INVALID_ARG if an index gap
+            // or a time's distance from the block's step doesn't fit in 32 bits.
+            static size_t encodeBlock(std::span<const ADCSample> samples, std::span<uint8_t> output, esp_err_t& err);
+
+            // Decode the block at the start of input, returning the number of bytes it occupied.
+            static size_t decodeBlock(std::span<const uint8_t> input, std::span<ADCSample> samples, size_t& samplesDecoded, esp_err_t& err);
+
+            // The number of samples in the block at the start of input, without decoding it.
+            static size_t blockSamples(std::span<const uint8_t> input, esp_err_t& err);
+
+        private:
+            enum class Mode : uint8_t {
+                Verbatim = 0,
+                Order0,
+                Order1,
+                Order2
+            };
+
+            static constexpr char _loggingTag[] = "esp::adc::ADCCodec";
+        };
+
+        using ADCEncoderBlockCallback = void(*)(std::span<const uint8_t> block, void* userInfo);
+
+        struct ADCEncoderConfig {
+            size_t samplesPerBlock = 256;
+            ADCEncoderBlockCallback onBlock = nullptr;
+        };
+
+        // A pipeline stage that collects a channel stream into blocks and hands each encoded block to a callback.
+        class ADCEncoder {
+        public:
+            ADCEncoder(const ADCEncoderConfig& config, void* userInfo, esp_err_t& err);
+
+            void process(std::span<const ADCSample> samples, esp_err_t& err);
+
+            // Encode any partially filled block.
+            void flush(esp_err_t& err);
+
+            uint64_t samplesEncoded() const { return _samplesEncoded; }
+
+            uint64_t bytesEncoded() const { return _bytesEncoded; }
+
+        private:
+            ADCEncoderConfig _config;
+            void* _userInfo;
+
+            std::vector<ADCSample> _pending;
+            std::vector<uint8_t> _block;
+
+            uint64_t _samplesEncoded = 0;
+            uint64_t _bytesEncoded = 0;
+
+            static constexpr char _loggingTag[] = "esp::adc::ADCEncoder";
+        };
+    }  // namespace adc
+}  // namespace esp
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "ADC/Filter.hpp"
+#include "ADC/Monitor.hpp"
 #include "ADC/Types.hpp"
 #include "Interrupt.hpp"
 
 #include <esp_adc/adc_continuous.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <ranges>
@@ -18,6 +21,14 @@ namespace esp {
         class ADCContinuous;
         using ADCContinuousPtr = std::shared_ptr<ADCContinuous>;
 
+        struct ADCBroadcastConfig;
+        class ADCBroadcast;
+        using ADCBroadcastPtr = std::shared_ptr<ADCBroadcast>;
+
+        struct ADCHistoryConfig;
+        class ADCHistory;
+        using ADCHistoryPtr = std::shared_ptr<ADCHistory>;
+
         using ADCContinuousConversionCallback = InterruptResult(*)(const uint8_t* conversionData, size_t count, void* userInfo);
         using ADCContinuousPoolOverflowCallback = InterruptResult(*)(void* userInfo);
 
@@ -63,6 +74,8 @@ namespace esp {
         public:
             ~ADCContinuous();
 
+            const ADCContinuousConfig& config() const { return _config; }
+
             esp_err_t setEventCallbacks(const ADCContinuousEventCallbacks& callbacks, void* userInfo);
 
             esp_err_t start();
@@ -70,6 +83,7 @@ namespace esp {
 
             template <size_t bufferSize>
             std::vector<uint8_t> read(uint32_t timeoutMs, esp_err_t& err);
+            size_t read(uint8_t* buffer, size_t bufferSize, uint32_t timeoutMs, esp_err_t& err);
             template <size_t maxSamples>
             std::vector<adc_continuous_data_t> readParsed(uint32_t timeoutMs, esp_err_t& err);
             template <std::ranges::viewable_range R>
@@ -78,19 +92,46 @@ namespace esp {
 
             esp_err_t flush();
 
+            // Counted from the driver's interrupts whatever callbacks are set, so a reader can tell how much conversion data it lost.  Every
+            // frame is counted as it's converted, whether or not it fits in the pool.
+            uint32_t framesConverted() const { return _framesConverted.load(std::memory_order_acquire); }
+            uint32_t poolOverflows() const { return _poolOverflows.load(std::memory_order_acquire); }
+
+            // The broadcast drain task becomes the only reader of this unit's conversion data.
+            ADCBroadcastPtr addBroadcast(const ADCBroadcastConfig& config, esp_err_t& err);
+
+            // The history drain task becomes the only reader of this unit's conversion data.
+            ADCHistoryPtr addHistory(const ADCHistoryConfig& config, esp_err_t& err);
+
+#if SOC_ADC_DIG_IIR_FILTER_SUPPORTED
+            ADCIIRFilterPtr addIIRFilter(const ADCIIRFilterConfig& config, esp_err_t& err);
+#endif
+#if SOC_ADC_MONITOR_SUPPORTED
+            ADCMonitorPtr addMonitor(const ADCMonitorConfig& config, esp_err_t& err);
+#endif
+
         private:
             ADCContinuous(const ADCContinuousConfig& config, esp_err_t& err);
 
+            ADCContinuousConfig _config;
             adc_continuous_handle_t _handle;
             ADCContinuousEventCallbacks _callbacks;
             std::pair<ADCContinuous*, void*> _userInfo;
             uint32_t _maxStoreBufSize = 1024;
             uint32_t _convFrameSize = 512;
             bool _started = false;
+            std::atomic<uint32_t> _framesConverted = 0;
+            std::atomic<uint32_t> _poolOverflows = 0;
 
             static constexpr char _loggingTag[] = "esp::ADCContinuous";
 
             friend class esp::ESP32;
+#if SOC_ADC_DIG_IIR_FILTER_SUPPORTED
+            friend class ADCIIRFilter;
+#endif
+#if SOC_ADC_MONITOR_SUPPORTED
+            friend class ADCMonitor;
+#endif
             friend bool _onConversionComplete(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* data, void* userData);
             friend bool _onPoolOverflow(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* data, void* userData);
         };
@@ -110,6 +151,15 @@ namespace esp {
             return rawData;
         }
 
+        inline size_t ADCContinuous::read(uint8_t* buffer, size_t bufferSize, uint32_t timeoutMs, esp_err_t& err) {
+            uint32_t bytesRead = 0;
+            err = adc_continuous_read(_handle, buffer, bufferSize, &bytesRead, timeoutMs);
+            if (err != ESP_OK) {
+                return 0;
+            }
+            return bytesRead;
+        }
+
         template <size_t maxSamples>
         std::vector<adc_continuous_data_t> ADCContinuous::readParsed(uint32_t timeoutMs, esp_err_t& err) {
             std::vector<adc_continuous_data_t> parsedData(maxSamples);
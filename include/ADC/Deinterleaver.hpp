@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ADC/Continuous.hpp"
+#include "ADC/Types.hpp"
+
+#include <soc/soc_caps.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace esp {
+    namespace adc {
+        struct ADCDeinterleaverConfig {
+            // The number of samples each channel stream can hold for a single call to process.
+            size_t maximumSamplesPerChannel;
+
+            // In the dual unit conversion modes, ADC2 samples are stamped with the time of the most recent ADC1 conversion plus this offset.
+            int32_t unit2OffsetNanoseconds = 0;
+
+            // Resample the ADC2 streams onto the time grid of the first ADC1 channel in the pattern.
+            bool interpolateUnit2 = false;
+        };
+
+        class ADCDeinterleaver {
+        public:
+            ADCDeinterleaver(const ADCContinuousConfig& adcConfig, const ADCDeinterleaverConfig& config, esp_err_t& err);
+
+            // Split a raw conversion frame, as delivered to onConversionComplete or returned by ADCContinuous::read, into per-channel streams.
+            void process(std::span<const uint8_t> frame, esp_err_t& err);
+            void process(std::span<const adc_continuous_data_t> parsedData, esp_err_t& err);
+
+            // The samples produced for a channel by the last call to process.
+            std::span<const ADCSample> samples(adc_unit_t unit, adc_channel_t channel) const;
+            std::span<ADCSample> samples(adc_unit_t unit, adc_channel_t channel);
+
+            // Restart the sample indices and time base, for example after ADCContinuous::stop or flush.
+            void reset();
+
+            uint64_t droppedSamples() const { return _droppedSamples; }
+
+            uint64_t unknownSamples() const { return _unknownSamples; }
+
+        private:
+            struct Stream {
+                adc_unit_t unit;
+                adc_channel_t channel;
+                std::vector<ADCSample> samples;
+                uint64_t nextIndex = 0;
+
+                // Interpolation state for ADC2 streams.
+                bool hasPrevious = false;
+                uint64_t previousTime = 0;
+                uint32_t previousValue = 0;
+                uint64_t nextGridIndex = 0;
+            };
+
+            void _beginFrame();
+            void _push(adc_unit_t unit, adc_channel_t channel, uint32_t value, bool valid, esp_err_t& err);
+            void _append(Stream& stream, uint64_t index, uint64_t time, uint32_t value, esp_err_t& err);
+            void _interpolate(Stream& stream, uint64_t time, uint32_t value, esp_err_t& err);
+
+            uint64_t _slotTime(uint64_t slot) const;
+            uint64_t _gridTime(uint64_t gridIndex) const;
+
+            static constexpr int8_t kNoStream = -1;
+
+            std::vector<Stream> _streams;
+            std::array<std::array<int8_t, SOC_ADC_MAX_CHANNEL_NUM>, SOC_ADC_PERIPH_NUM> _streamForChannel;
+
+            ConversionMode _conversionMode;
+            uint32_t _samplingFrequencyHz;
+            ADCDeinterleaverConfig _config;
+
+            // ADC2 streams are interpolated onto the first ADC1 slot of each pattern cycle.
+            uint64_t _slotsPerCycle = 1;
+
+            uint64_t _nextSlot = 0;
+            uint64_t _unit1Time = 0;
+            uint64_t _droppedSamples = 0;
+            uint64_t _unknownSamples = 0;
+
+            static constexpr char _loggingTag[] = "esp::ADCDeinterleaver";
+        };
+    }  // namespace adc
+}  // namespace esp
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ADC/Types.hpp"
+
+#include <esp_err.h>
+#include <soc/soc_caps.h>
+#if SOC_ADC_DIG_IIR_FILTER_SUPPORTED
+#include <esp_adc/adc_filter.h>
+#endif
+
+#include <memory>
+#include <span>
+
+namespace esp {
+    namespace adc {
+        class ADCContinuous;
+        using ADCContinuousPtr = std::shared_ptr<ADCContinuous>;
+
+        enum class IIRFilterCoefficient : uint8_t {
+            K2 = ADC_DIGI_IIR_FILTER_COEFF_2,
+            K4 = ADC_DIGI_IIR_FILTER_COEFF_4,
+            K8 = ADC_DIGI_IIR_FILTER_COEFF_8,
+            K16 = ADC_DIGI_IIR_FILTER_COEFF_16,
+            K64 = ADC_DIGI_IIR_FILTER_COEFF_64,
+        };
+
+        uint32_t iirFilterDivisor(IIRFilterCoefficient coefficient);
+
+        struct ADCIIRFilterConfig {
+            adc_unit_t unit;
+            adc_channel_t channel;
+            IIRFilterCoefficient coefficient;
+        };
+
+#if SOC_ADC_DIG_IIR_FILTER_SUPPORTED
+        class ADCIIRFilter;
+        using ADCIIRFilterPtr = std::shared_ptr<ADCIIRFilter>;
+
+        // A hardware IIR filter in the ADC digital controller.  Filters must be added and enabled while the ADCContinuous is stopped.
+        class ADCIIRFilter {
+        public:
+            // Construct an ADCIIRFilter by requesting one from an ADCContinuous.
+            ~ADCIIRFilter();
+
+            const ADCIIRFilterConfig& config() const { return _config; }
+
+            void enable(esp_err_t& err);
+            void disable(esp_err_t& err);
+
+        private:
+            ADCIIRFilter(ADCContinuousPtr adc, const ADCIIRFilterConfig& config, esp_err_t& err);
+
+            ADCContinuousPtr _adc;
+            ADCIIRFilterConfig _config;
+            adc_iir_filter_handle_t _filter = nullptr;
+            bool _enabled = false;
+
+            static constexpr char _loggingTag[] = "esp::ADCIIRFilter";
+
+            friend class ADCContinuous;
+        };
+#endif
+
+        // A software model of the hardware filter's recurrence, out = ((k - 1) * out + in) / k, for host testing and for channels without a
+        // hardware filter.  Unlike the peripheral it seeds its state from the first sample.
+        class ADCIIRFilterModel {
+        public:
+            ADCIIRFilterModel(IIRFilterCoefficient coefficient) : _divisor(iirFilterDivisor(coefficient)) {}
+
+            uint32_t push(uint32_t value);
+
+            void process(std::span<ADCSample> samples);
+
+            void reset() { _primed = false; }
+
+        private:
+            uint32_t _divisor;
+            uint32_t _state = 0;
+            bool _primed = false;
+        };
+    }  // namespace adc
+}  // namespace esp
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "ADC/Continuous.hpp"
+#include "EventLoop.hpp"
+
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sdkconfig.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace esp {
+    namespace adc {
+        class ADCHistory;
+        using ADCHistoryPtr = std::shared_ptr<ADCHistory>;
+
+#if defined(CONFIG_ESP32S3_DATA_CACHE_LINE_SIZE)
+        static constexpr size_t kCacheLineSize = CONFIG_ESP32S3_DATA_CACHE_LINE_SIZE;
+#else
+        static constexpr size_t kCacheLineSize = 64;
+#endif
+
+        struct ADCHistoryConfig {
+            // Bytes of raw conversion data per history block, rounded up to a whole number of cache lines.
+            size_t blockSize;
+            size_t blockCount;
+
+            // Where the history ring lives.  The staging block that the drain task reads into is always in internal RAM.
+            uint32_t memoryCapabilities = MALLOC_CAP_SPIRAM;
+
+            TaskInfo taskInfo;
+            uint32_t readTimeoutMs = 100;
+        };
+
+        // Drains an ADCContinuous into a large ring of history blocks, normally in PSRAM, while the driver's DMA pool stays in internal RAM.
+        // Each block is filled in an internal staging block and copied into the ring in one aligned bulk copy.  Sample times are derived from
+        // the sampling frequency, counting from the moment the drain starts.  Conversions lost when the pool overflows are counted from the
+        // unit's converted frames, and the next block starts that much later, leaving a gap in history rather than shifting later times.
+        class ADCHistory {
+        public:
+            // Construct an ADCHistory by requesting one from an ADCContinuous.
+            ~ADCHistory();
+
+            void start(esp_err_t& err);
+            void stop(esp_err_t& err);
+
+            size_t blockSize() const { return _blockSize; }
+
+            // The range of times currently held in history.
+            std::pair<std::chrono::microseconds, std::chrono::microseconds> availableRange() const;
+
+            // Copy the raw conversion data for [from, to) into buffer without pausing acquisition, returning the number of bytes copied.
+            // Blocks overwritten while being read are skipped and reported with ESP_ERR_INVALID_STATE.  Conversions lost from the range are
+            // skipped and reported with ESP_ERR_NOT_FOUND.
+            size_t read(std::chrono::microseconds from, std::chrono::microseconds to, std::span<uint8_t> buffer, esp_err_t& err) const;
+
+            uint64_t blocksWritten() const { return _blocksWritten.load(std::memory_order_acquire); }
+
+            // Conversions missing from history since start, those lost to pool overflows along with any the drain task threw away to
+            // find its place again afterwards.
+            uint64_t droppedConversions() const { return _droppedConversions.load(std::memory_order_relaxed); }
+
+        private:
+            ADCHistory(ADCContinuousPtr adc, const ADCHistoryConfig& config, esp_err_t& err);
+
+            struct Block {
+                // Odd while the drain task is writing the block.
+                std::atomic<uint32_t> sequence = 0;
+                std::atomic<uint64_t> index = UINT64_MAX;
+                // Where the first conversion falls in time, counting the conversions dropped before it.
+                std::atomic<uint64_t> firstConversion = 0;
+            };
+
+            static void _drainTask(void* userInfo);
+            void _drain();
+            void _commitBlock();
+            // The drain task's count of frames the unit has converted since start, extended to 64 bits.
+            uint64_t _frames();
+            // Read and throw away everything in the pool, then start the next block where the unit has got to.
+            void _resynchronise();
+            // If the unit had converted more than the drain task has read by the time frames were counted, with the pool empty since, drop
+            // the staging block and start the next one where the unit has got to.  Returns true if it did.
+            bool _reanchor(uint64_t frames, size_t filled);
+
+            std::chrono::microseconds _conversionTime(uint64_t conversion) const;
+            uint64_t _conversionAt(std::chrono::microseconds time) const;
+
+            ADCContinuousPtr _adc;
+            ADCHistoryConfig _config;
+
+            size_t _blockSize = 0;
+            size_t _conversionsPerBlock = 0;
+            size_t _conversionsPerFrame = 0;
+            uint32_t _samplingFrequencyHz = 0;
+
+            uint8_t* _staging = nullptr;
+            uint8_t* _ring = nullptr;
+            std::unique_ptr<Block[]> _blocks;
+
+            std::atomic<uint64_t> _blocksWritten = 0;
+            std::atomic<uint64_t> _droppedConversions = 0;
+            std::chrono::microseconds _startTime{0};
+
+            // Only touched by the drain task once started.
+            uint64_t _stagingConversion = 0;
+            uint64_t _framesConverted = 0;
+            uint32_t _framesSeen = 0;
+            uint32_t _overflowsSeen = 0;
+
+            TaskHandle_t _task = nullptr;
+            TaskHandle_t _stoppingTask = nullptr;
+            std::atomic<bool> _running = false;
+
+            static constexpr char _loggingTag[] = "esp::ADCHistory";
+
+            friend class ADCContinuous;
+        };
+    }  // namespace adc
+}  // namespace esp
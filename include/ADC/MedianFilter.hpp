@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ADC/Types.hpp"
+
+#include <esp_err.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace esp {
+    namespace adc {
+        struct ADCMedianFilterConfig {
+            size_t windowSize;
+
+            // When set, a sample further than this from the window median is replaced by the median and every other sample passes through unchanged.
+            // When unset, every sample is replaced by the window median.
+            std::optional<uint32_t> spikeThreshold;
+        };
+
+        // A sliding window median over one channel stream.  The window is kept as a max-heap of the lower half and a min-heap of the upper half
+        // sharing a single array with the median at its centre, so each sample costs O(log n) and nothing is allocated after construction.
+        class ADCMedianFilter {
+        public:
+            ADCMedianFilter(const ADCMedianFilterConfig& config, esp_err_t& err);
+
+            uint32_t push(uint32_t value);
+
+            // Filter a channel stream in place, for example one produced by ADCDeinterleaver.
+            void process(std::span<ADCSample> samples);
+
+            uint32_t median() const;
+
+            void reset();
+
+            uint64_t rejectedSamples() const { return _rejectedSamples; }
+
+        private:
+            bool _less(int32_t i, int32_t j) const { return _values[_heap[i]] < _values[_heap[j]]; }
+
+            bool _exchangeIfLess(int32_t i, int32_t j);
+            void _minSortDown(int32_t i);
+            void _maxSortDown(int32_t i);
+            bool _minSortUp(int32_t i);
+            bool _maxSortUp(int32_t i);
+
+            int32_t _minCount() const { return (_count - 1) / 2; }
+
+            int32_t _maxCount() const { return _count / 2; }
+
+            ADCMedianFilterConfig _config;
+
+            std::vector<uint32_t> _values;
+            std::vector<int32_t> _positions;
+            std::vector<int32_t> _heapStorage;
+            int32_t* _heap = nullptr;  // Points at the middle of _heapStorage; negative indices are the max-heap, positive the min-heap.
+
+            int32_t _windowSize = 0;
+            int32_t _next = 0;
+            int32_t _count = 0;
+
+            uint64_t _rejectedSamples = 0;
+
+            static constexpr char _loggingTag[] = "esp::ADCMedianFilter";
+        };
+    }  // namespace adc
+}  // namespace esp
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ADC/Types.hpp"
+#include "Interrupt.hpp"
+
+#include <esp_err.h>
+#include <soc/soc_caps.h>
+#if SOC_ADC_MONITOR_SUPPORTED
+#include <esp_adc/adc_monitor.h>
+#endif
+
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace esp {
+    namespace adc {
+        class ADCContinuous;
+        using ADCContinuousPtr = std::shared_ptr<ADCContinuous>;
+
+        using ADCMonitorCallback = InterruptResult(*)(void* userInfo);
+
+        struct ADCMonitorEventCallbacks {
+            ADCMonitorCallback onAboveHighThreshold = nullptr;
+            ADCMonitorCallback onBelowLowThreshold = nullptr;
+        };
+
+        struct ADCMonitorConfig {
+            adc_unit_t unit;
+            adc_channel_t channel;
+            std::optional<uint32_t> highThreshold;
+            std::optional<uint32_t> lowThreshold;
+        };
+
+#if SOC_ADC_MONITOR_SUPPORTED
+        class ADCMonitor;
+        using ADCMonitorPtr = std::shared_ptr<ADCMonitor>;
+
+        bool _onAboveHighThreshold(adc_monitor_handle_t handle, const adc_monitor_evt_data_t* data, void* userData);
+        bool _onBelowLowThreshold(adc_monitor_handle_t handle, const adc_monitor_evt_data_t* data, void* userData);
+
+        // A hardware threshold monitor in the ADC digital controller.  Monitors must be added and enabled while the ADCContinuous is stopped.
+        class ADCMonitor {
+        public:
+            // Construct an ADCMonitor by requesting one from an ADCContinuous.
+            ~ADCMonitor();
+
+            const ADCMonitorConfig& config() const { return _config; }
+
+            void setEventCallbacks(const ADCMonitorEventCallbacks& callbacks, void* userInfo, esp_err_t& err);
+
+            void enable(esp_err_t& err);
+            void disable(esp_err_t& err);
+
+        private:
+            ADCMonitor(ADCContinuousPtr adc, const ADCMonitorConfig& config, esp_err_t& err);
+
+            ADCContinuousPtr _adc;
+            ADCMonitorConfig _config;
+            adc_monitor_handle_t _monitor = nullptr;
+            bool _enabled = false;
+
+            ADCMonitorEventCallbacks _callbacks;
+            std::pair<ADCMonitor*, void*> _userInfo;
+
+            static constexpr char _loggingTag[] = "esp::ADCMonitor";
+
+            friend class ADCContinuous;
+            friend bool _onAboveHighThreshold(adc_monitor_handle_t handle, const adc_monitor_evt_data_t* data, void* userData);
+            friend bool _onBelowLowThreshold(adc_monitor_handle_t handle, const adc_monitor_evt_data_t* data, void* userData);
+        };
+#endif
+
+        // A software model of the threshold monitor for host testing, calling the same callbacks once for every sample beyond a threshold.
+        class ADCMonitorModel {
+        public:
+            ADCMonitorModel(const ADCMonitorConfig& config) : _config(config) {}
+
+            void setEventCallbacks(const ADCMonitorEventCallbacks& callbacks, void* userInfo);
+
+            InterruptResult push(uint32_t value);
+
+            InterruptResult process(std::span<const ADCSample> samples);
+
+        private:
+            ADCMonitorConfig _config;
+            ADCMonitorEventCallbacks _callbacks;
+            void* _userInfo = nullptr;
+        };
+    }  // namespace adc
+}  // namespace esp
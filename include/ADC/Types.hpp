@@ -2,6 +2,8 @@
 
 #include <hal/adc_types.h>
 
+#include <cstdint>
+
 namespace esp {
     namespace adc {
         enum class Attenuation : uint8_t {
@@ -19,5 +21,12 @@ namespace esp {
             Bits12 = ADC_BITWIDTH_12,
             Bits13 = ADC_BITWIDTH_13,
         };
+
+        // A single conversion result on one channel, tagged with its position in that channel's stream.
+        struct ADCSample {
+            uint64_t index;
+            uint64_t timeNanoseconds;
+            uint32_t value;
+        };
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "GPIO.hpp"
+#include "Testing.hpp"
+
+#include <esp_cpu.h>
+#include <freertos/FreeRTOS.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace esp {
+    class BitBangSerial;
+    using BitBangSerialPtr = std::shared_ptr<BitBangSerial>;
+
+    enum class BitOrder : uint8_t {
+        MSBFirst = 0,
+        LSBFirst
+    };
+
+    struct BitBangSerialConfig {
+        gpio_num_t clock;
+        // Either data pin may be GPIO_NUM_NC.  Giving the same pin for both makes a 3 wire half duplex link with the pin open drain, which
+        // is released between words and while reading.
+        gpio_num_t dataOut = GPIO_NUM_NC;
+        gpio_num_t dataIn = GPIO_NUM_NC;
+        // The clock's idle level, as SPI's CPOL.
+        Level clockPolarity = Level::Low;
+        // As SPI's CPHA: when false data is sampled on the leading clock edge, when true on the trailing one.
+        bool clockPhase = false;
+        BitOrder bitOrder = BitOrder::MSBFirst;
+        // 1 to 32 bits.
+        uint8_t wordSize = 8;
+        // 0 toggles the clock as fast as the pins allow.  Interrupts are masked for a whole word, so a word must take no longer than
+        // BitBangSerial::kMaxMaskedMicros: at least 80 kHz for 8 bit words, or 320 kHz for 32 bit ones.
+        uint32_t clockHz = 1'000'000;
+    };
+
+    // A synchronous serial engine bit-banged over GPIO registers, for peripherals that fit neither the SPI nor the I2C peripheral.  Bit
+    // timing comes from deadlines on the CPU cycle counter, so time spent on the pins is absorbed rather than adding to each half period.
+    // Interrupts are masked for one word at a time, so a long block keeps the bit timing without locking the core out for the whole block.
+    class BitBangSerial {
+    public:
+        // The longest a word may keep interrupts masked, checked against wordSize and clockHz.
+        static constexpr uint32_t kMaxMaskedMicros = 100;
+
+        const BitBangSerialConfig& config() const { return _config; }
+
+        // Clock out each word of out while clocking in a word for each entry of in.  Either may be empty, but if both are given they
+        // must be the same size.  All ones are clocked out when out is empty, releasing a half duplex data line for the peripheral to drive.
+        template <std::unsigned_integral Word>
+        void transfer(std::span<const Word> out, std::span<Word> in, esp_err_t& err);
+
+        uint32_t transferWord(uint32_t word);
+
+        PRIVATE_UNLESS_TESTING
+        static constexpr uint32_t kReleasedWord = UINT32_MAX;
+
+        static bool _isHalfDuplex(const BitBangSerialConfig& config) { return config.dataOut != GPIO_NUM_NC && config.dataOut == config.dataIn; }
+
+        // Clock one word through a port providing setClock, setData, sample, cycles, beginWord and endWord, with each clock half
+        // period lasting halfPeriodCycles.  A half duplex data line is left released.
+        template <typename Port>
+        static uint32_t shiftWord(Port& port, const BitBangSerialConfig& config, uint32_t halfPeriodCycles, uint32_t word);
+
+    private:
+        BitBangSerial(const BitBangSerialConfig& config, std::vector<GPIOPtr> gpios, esp_err_t& err);
+
+        static uint32_t _setReg(uint32_t pin);
+        static uint32_t _clearReg(uint32_t pin);
+
+        // The GPIO registers for the configured pins.
+        struct RegisterPort {
+            uint32_t clockSetReg;
+            uint32_t clockClearReg;
+            uint32_t clockMask;
+            uint32_t dataSetReg;
+            uint32_t dataClearReg;
+            uint32_t dataMask = 0;
+            uint32_t sampleReg;
+            uint32_t sampleShift = 0;
+            bool hasDataIn = false;
+            portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+
+            void setClock(Level level);
+            void setData(Level level);
+            Level sample() const;
+            uint32_t cycles() const { return esp_cpu_get_cycle_count(); }
+            void beginWord() { portENTER_CRITICAL(&lock); }
+            void endWord() { portEXIT_CRITICAL(&lock); }
+        };
+
+        BitBangSerialConfig _config;
+        std::vector<GPIOPtr> _gpios;
+        RegisterPort _port;
+        uint32_t _halfPeriodCycles = 0;
+
+        static constexpr char _loggingTag[] = "esp::BitBangSerial";
+
+        friend class ESP32;
+    };
+
+    //
+    // IMPLEMENTATION
+    //
+    template <std::unsigned_integral Word>
+    void BitBangSerial::transfer(std::span<const Word> out, std::span<Word> in, esp_err_t& err) {
+        if (_config.wordSize > sizeof(Word) * 8) {
+            err = ESP_ERR_INVALID_ARG;
+            return;
+        }
+        if (!out.empty() && !in.empty() && out.size() != in.size()) {
+            err = ESP_ERR_INVALID_SIZE;
+            return;
+        }
+
+        const size_t words = std::max(out.size(), in.size());
+        for (size_t i = 0; i < words; i++) {
+            const uint32_t word = shiftWord(_port, _config, _halfPeriodCycles, out.empty() ? kReleasedWord : out[i]);
+            if (!in.empty()) {
+                in[i] = static_cast<Word>(word);
+            }
+        }
+        err = ESP_OK;
+    }
+
+    inline uint32_t BitBangSerial::transferWord(uint32_t word) {
+        return shiftWord(_port, _config, _halfPeriodCycles, word);
+    }
+
+    template <typename Port>
+    inline uint32_t BitBangSerial::shiftWord(Port& port, const BitBangSerialConfig& config, uint32_t halfPeriodCycles, uint32_t word) {
+        const Level idle = config.clockPolarity;
+        const Level active = idle == Level::Low ? Level::High : Level::Low;
+        const uint32_t bits = config.wordSize;
+        uint32_t received = 0;
+
+        port.beginWord();
+        uint32_t deadline = port.cycles();
+        auto waitHalfPeriod = [&]() {
+            deadline += halfPeriodCycles;
+            while (static_cast<int32_t>(port.cycles() - deadline) < 0) {
+            }
+        };
+
+        for (uint32_t i = 0; i < bits; i++) {
+            const uint32_t bit = config.bitOrder == BitOrder::MSBFirst ? bits - 1 - i : i;
+            const Level out = ((word >> bit) & 1) != 0 ? Level::High : Level::Low;
+            Level in;
+            if (!config.clockPhase) {
+                port.setData(out);
+                waitHalfPeriod();
+                port.setClock(active);
+                in = port.sample();
+                waitHalfPeriod();
+                port.setClock(idle);
+            } else {
+                port.setClock(active);
+                port.setData(out);
+                waitHalfPeriod();
+                port.setClock(idle);
+                in = port.sample();
+                waitHalfPeriod();
+            }
+            if (in == Level::High) {
+                received |= 1u << bit;
+            }
+        }
+        if (_isHalfDuplex(config)) {
+            port.setData(Level::High);
+        }
+        port.endWord();
+
+        return received;
+    }
+
+    inline void BitBangSerial::RegisterPort::setClock(Level level) {
+        REG_WRITE(level == Level::High ? clockSetReg : clockClearReg, clockMask);
+    }
+
+    inline void BitBangSerial::RegisterPort::setData(Level level) {
+        if (dataMask != 0) {
+            REG_WRITE(level == Level::High ? dataSetReg : dataClearReg, dataMask);
+        }
+    }
+
+    inline Level BitBangSerial::RegisterPort::sample() const {
+        if (!hasDataIn) {
+            return Level::Low;
+        }
+        return ((REG_READ(sampleReg) >> sampleShift) & 1) != 0 ? Level::High : Level::Low;
+    }
+}  // namespace esp
@@ -0,0 +1,316 @@
+#pragma once
+
+#include "EventLoop.hpp"
+#include "Timer.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#include <chrono>
+#include <coroutine>
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <unordered_set>
+#include <utility>
+
+namespace esp {
+    class CoroutineExecutor;
+    using CoroutineExecutorPtr = std::shared_ptr<CoroutineExecutor>;
+
+    template <typename T = void>
+    class Coroutine;
+
+    struct CoroutineExecutorConfig {
+        TaskInfo taskInfo = {.name = "coroutines", .stackSize = 4096};
+        // How many spawns can be waiting for the executor at once.
+        size_t queueSize = 16;
+        // Whether deadlines wake the executor from the esp_timer task or straight from its ISR.
+        TimerDispatchMethod dispatchMethod = TimerDispatchMethod::Task;
+    };
+
+    namespace priv {
+        // A point in time a suspended coroutine is waiting for, registered with the executor running it.  Destroying it unregisters it,
+        // so destroying a suspended coroutine's frame cancels its wait.  It is its own node in the executor's heap, so arming and
+        // cancelling allocate nothing.
+        class Deadline {
+        public:
+            explicit Deadline(std::chrono::microseconds at) : _at(at) {}
+            Deadline(const Deadline& other) = delete;
+            Deadline& operator=(const Deadline& other) = delete;
+            ~Deadline() { cancel(); }
+
+            std::chrono::microseconds at() const { return _at; }
+            bool fired() const { return _fired; }
+
+            // False when not called from an executor's task.
+            bool arm(std::coroutine_handle<> handle);
+            void cancel();
+
+        private:
+            std::chrono::microseconds _at;
+            CoroutineExecutor* _executor = nullptr;
+            std::coroutine_handle<> _handle;
+            // Breaks ties between equal times, so they wake in the order they were armed.
+            uint64_t _order = 0;
+            // Pairing heap links: the first child, the next sibling, and the previous sibling or, for a first child, the parent.
+            Deadline* _child = nullptr;
+            Deadline* _next = nullptr;
+            Deadline* _previous = nullptr;
+            bool _armed = false;
+            bool _fired = false;
+
+            friend class esp::CoroutineExecutor;
+        };
+
+        struct FinalAwaiter {
+            bool await_ready() const noexcept { return false; }
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept;
+            void await_resume() const noexcept {}
+        };
+
+        struct PromiseBase {
+            // Resumed when the coroutine finishes, if something awaited it.
+            std::coroutine_handle<> continuation;
+            // Set on coroutines spawned on an executor, which destroys them when they finish.
+            CoroutineExecutor* executor = nullptr;
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            // Built without exceptions.
+            void unhandled_exception() const { std::abort(); }
+        };
+
+        template <typename T>
+        struct Promise : PromiseBase {
+            std::optional<T> value;
+
+            Coroutine<T> get_return_object();
+            void return_value(T result) { value.emplace(std::move(result)); }
+            T result() { return std::move(*value); }
+        };
+
+        template <>
+        struct Promise<void> : PromiseBase {
+            Coroutine<void> get_return_object();
+            void return_void() const {}
+            void result() const {}
+        };
+
+        template <typename T>
+        class TimeoutAwaitable;
+    }  // namespace priv
+
+    // A lazily started coroutine.  It runs when awaited, or when spawned on an executor, and destroying it destroys its frame along
+    // with anything it is waiting on.
+    template <typename T>
+    class Coroutine {
+    public:
+        using promise_type = priv::Promise<T>;
+
+        Coroutine(Coroutine&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+        Coroutine& operator=(Coroutine&& other) noexcept;
+        ~Coroutine();
+
+        bool done() const { return _handle == nullptr || _handle.done(); }
+
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept;
+        T await_resume() { return _handle.promise().result(); }
+
+    private:
+        explicit Coroutine(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+        std::coroutine_handle<promise_type> _handle;
+
+        friend promise_type;
+        friend class CoroutineExecutor;
+        friend class priv::TimeoutAwaitable<T>;
+    };
+
+    // Runs coroutines on a single task.  Sleeping coroutines are kept in one deadline ordered heap, with a single esp::Timer set for
+    // the earliest, so each waiting coroutine costs only its frame rather than a task and its stack.
+    class CoroutineExecutor {
+    public:
+        ~CoroutineExecutor();
+
+        const CoroutineExecutorConfig& config() const { return _config; }
+
+        // Start coroutine on the executor's task, which owns it from then on.  Not from an ISR.  ESP_ERR_NO_MEM if called from a
+        // coroutine while the queue is full.
+        void spawn(Coroutine<void> coroutine, esp_err_t& err);
+
+        // The executor running the calling task, or nullptr.
+        static CoroutineExecutor* current() { return _current; }
+
+    private:
+        CoroutineExecutor(const CoroutineExecutorConfig& config, esp_err_t& err);
+
+        enum class MessageKind : uint8_t {
+            Wake = 0,
+            Spawn,
+            Stop
+        };
+
+        struct Message {
+            MessageKind kind;
+            void* address;
+        };
+
+        void _insert(priv::Deadline* deadline);
+        void _remove(priv::Deadline* deadline);
+        static bool _before(const priv::Deadline* a, const priv::Deadline* b);
+        // Make the later of two roots the first child of the earlier, returning the earlier.
+        static priv::Deadline* _meld(priv::Deadline* a, priv::Deadline* b);
+        // Meld a list of siblings into one heap, in pairs left to right and then the pairs right to left.
+        static priv::Deadline* _mergePairs(priv::Deadline* first);
+
+        void _runExpired();
+        void _armTimer();
+        void _finished(std::coroutine_handle<> handle);
+
+        static void _onTimer(Timer& timer, void* userInfo);
+        static void _executorTask(void* userInfo);
+
+        CoroutineExecutorConfig _config;
+        TimerPtr _timer;
+        QueueHandle_t _queue = nullptr;
+        TaskHandle_t _task = nullptr;
+        TaskHandle_t _stoppingTask = nullptr;
+
+        // Only touched on the executor's task.  The root of the deadline heap, which is the earliest.
+        priv::Deadline* _earliest = nullptr;
+        // Counts every deadline armed, for their tie breaking order.
+        uint64_t _deadlinesArmed = 0;
+        std::unordered_set<void*> _roots;
+        std::chrono::microseconds _armedAt{0};
+
+        static inline thread_local CoroutineExecutor* _current = nullptr;
+
+        static constexpr char _loggingTag[] = "esp::CoroutineExecutor";
+
+        friend class ESP32;
+        friend class priv::Deadline;
+        friend struct priv::FinalAwaiter;
+    };
+
+    // Suspends the awaiting coroutine for at least duration.  Must be awaited on an executor's task.
+    class SleepAwaitable {
+    public:
+        explicit SleepAwaitable(std::chrono::microseconds deadline) : _deadline(deadline) {}
+
+        bool await_ready() const { return _deadline.at() <= Timer::now(); }
+        bool await_suspend(std::coroutine_handle<> handle) { return _deadline.arm(handle); }
+        void await_resume() const {}
+
+    private:
+        priv::Deadline _deadline;
+    };
+
+    inline SleepAwaitable sleepFor(std::chrono::microseconds duration) {
+        return SleepAwaitable(Timer::now() + duration);
+    }
+
+    inline SleepAwaitable sleepUntil(std::chrono::microseconds time) {
+        return SleepAwaitable(time);
+    }
+
+    namespace priv {
+        template <typename T>
+        class TimeoutAwaitable {
+        public:
+            TimeoutAwaitable(Coroutine<T> operation, std::chrono::microseconds deadline)
+                : _operation(std::move(operation)), _deadline(deadline) {}
+
+            bool await_ready() const { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller);
+            std::expected<T, esp_err_t> await_resume();
+
+        private:
+            Coroutine<T> _operation;
+            Deadline _deadline;
+        };
+    }  // namespace priv
+
+    // Runs operation until it finishes or timeout passes, whichever is first.  On a timeout the operation is destroyed, cancelling
+    // whatever it was waiting on, and the result is ESP_ERR_TIMEOUT.
+    template <typename T>
+    Coroutine<std::expected<T, esp_err_t>> withTimeout(Coroutine<T> operation, std::chrono::microseconds timeout) {
+        co_return co_await priv::TimeoutAwaitable<T>(std::move(operation), Timer::now() + timeout);
+    }
+
+    //
+    // IMPLEMENTATION
+    //
+    template <typename T>
+    Coroutine<T>& Coroutine<T>::operator=(Coroutine&& other) noexcept {
+        if (&other != this) {
+            if (_handle != nullptr) {
+                _handle.destroy();
+            }
+            _handle = std::exchange(other._handle, nullptr);
+        }
+        return *this;
+    }
+
+    template <typename T>
+    Coroutine<T>::~Coroutine() {
+        if (_handle != nullptr) {
+            _handle.destroy();
+        }
+    }
+
+    template <typename T>
+    std::coroutine_handle<> Coroutine<T>::await_suspend(std::coroutine_handle<> caller) noexcept {
+        _handle.promise().continuation = caller;
+        return _handle;
+    }
+
+    namespace priv {
+        template <typename Promise>
+        std::coroutine_handle<> FinalAwaiter::await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            PromiseBase& promise = handle.promise();
+            if (promise.continuation != nullptr) {
+                return promise.continuation;
+            }
+            if (promise.executor != nullptr) {
+                promise.executor->_finished(handle);
+            }
+            return std::noop_coroutine();
+        }
+
+        template <typename T>
+        Coroutine<T> Promise<T>::get_return_object() {
+            return Coroutine<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+        }
+
+        inline Coroutine<void> Promise<void>::get_return_object() {
+            return Coroutine<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+        }
+
+        template <typename T>
+        std::coroutine_handle<> TimeoutAwaitable<T>::await_suspend(std::coroutine_handle<> caller) {
+            // Off an executor there's nothing to time out with, so the operation just runs.
+            _deadline.arm(caller);
+            return _operation.await_suspend(caller);
+        }
+
+        template <typename T>
+        std::expected<T, esp_err_t> TimeoutAwaitable<T>::await_resume() {
+            if (!_operation.done()) {
+                _operation = Coroutine<T>(nullptr);
+                return std::unexpected(ESP_ERR_TIMEOUT);
+            }
+
+            _deadline.cancel();
+            if constexpr (std::is_void_v<T>) {
+                return {};
+            } else {
+                return _operation.await_resume();
+            }
+        }
+    }  // namespace priv
+}  // namespace esp
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Enums.hpp"
+#include "GPIO.hpp"
+#include "Testing.hpp"
+#include "Timer.hpp"
+
+#include <soc/soc_caps.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace esp {
+    class DebounceGroup;
+    using DebounceGroupPtr = std::shared_ptr<DebounceGroup>;
+
+    // Called once for every clean edge, with the input's index in DebounceGroupConfig::inputs.
+    using DebounceCallback = void(*)(size_t input, Level level, void* userInfo);
+
+    struct DebounceGroupConfig {
+        std::vector<GPIOPtr> inputs;
+        DebounceCallback callback = nullptr;
+        void* userInfo = nullptr;
+        std::string name = "debounce";
+    };
+
+    // Debounces a set of inputs on one periodic timer instead of an interrupt and timer per input.  Each tick reads the input registers
+    // once and runs 2 bit vertical counters across every pin in a bank at the same time, so an input changes state once it has read the
+    // same for 4 consecutive ticks.  The cost per tick is the same however much the inputs bounce.
+    class DebounceGroup {
+    public:
+        static constexpr size_t kSamplesToSettle = 4;
+
+        const DebounceGroupConfig& config() const { return _config; }
+
+        void start(std::chrono::microseconds samplePeriod, esp_err_t& err);
+        void stop(esp_err_t& err);
+
+        Level level(size_t input) const;
+
+        PRIVATE_UNLESS_TESTING
+        // Run one tick against the given input register values.
+        void sample(std::span<const uint32_t> levels);
+
+    private:
+        DebounceGroup(const DebounceGroupConfig& config, esp_err_t& err);
+
+        static void _onTick(Timer& timer, void* userInfo);
+
+#if SOC_GPIO_PIN_COUNT > 32
+        static constexpr size_t kNumBanks = 2;
+#else
+        static constexpr size_t kNumBanks = 1;
+#endif
+
+        DebounceGroupConfig _config;
+        TimerPtr _timer;
+
+        std::array<uint32_t, kNumBanks> _masks = {};
+        std::array<uint32_t, kNumBanks> _states = {};
+        std::array<uint32_t, kNumBanks> _counts0 = {};
+        std::array<uint32_t, kNumBanks> _counts1 = {};
+        std::array<uint8_t, kNumBanks * 32> _inputForPin = {};
+
+        static constexpr char _loggingTag[] = "esp::DebounceGroup";
+
+        friend class ESP32;
+    };
+}  // namespace esp
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GPIO.hpp"
+
+#include <soc/soc_caps.h>
+#if SOC_DEDICATED_GPIO_SUPPORTED
+#include <driver/dedic_gpio.h>
+#include <hal/dedic_gpio_cpu_ll.h>
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace esp {
+    class DedicatedGPIOBundle;
+    using DedicatedGPIOBundlePtr = std::shared_ptr<DedicatedGPIOBundle>;
+
+    struct DedicatedGPIOBundleConfig {
+        // Bit i of every bundle value is pins[i].
+        std::vector<gpio_num_t> pins;
+        bool input = false;
+        bool output = true;
+        bool invertInput = false;
+        bool invertOutput = false;
+    };
+
+    // A bundle of pins routed to the CPU's dedicated GPIO channels, so write and read are single instructions rather than driver calls.
+    // The channels belong to the core that created the bundle, and the bundle must only be used from that core.  Targets without dedicated
+    // GPIO, such as the Linux target, get a software model that keeps the same interface.
+    class DedicatedGPIOBundle {
+    public:
+        ~DedicatedGPIOBundle();
+
+        const DedicatedGPIOBundleConfig& config() const { return _config; }
+
+        size_t width() const { return _config.pins.size(); }
+
+        // Drive the pins selected by mask to the matching bits of value.
+        void write(uint32_t mask, uint32_t value);
+
+        uint32_t read() const;
+
+    private:
+        DedicatedGPIOBundle(const DedicatedGPIOBundleConfig& config, std::vector<GPIOPtr> gpios, esp_err_t& err);
+
+        DedicatedGPIOBundleConfig _config;
+        std::vector<GPIOPtr> _gpios;
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+        dedic_gpio_bundle_handle_t _bundle = nullptr;
+        uint32_t _outputShift = 0;
+        uint32_t _inputShift = 0;
+#else
+        uint32_t _levels = 0;
+#endif
+        uint32_t _widthMask = 0;
+
+        static constexpr char _loggingTag[] = "esp::DedicatedGPIOBundle";
+
+        friend class ESP32;
+    };
+
+    //
+    // IMPLEMENTATION
+    //
+    __attribute__((always_inline)) inline void DedicatedGPIOBundle::write(uint32_t mask, uint32_t value) {
+#if SOC_DEDICATED_GPIO_SUPPORTED
+        dedic_gpio_cpu_ll_write_mask((mask & _widthMask) << _outputShift, value << _outputShift);
+#else
+        mask &= _widthMask;
+        _levels = (_levels & ~mask) | (value & mask);
+#endif
+    }
+
+    __attribute__((always_inline)) inline uint32_t DedicatedGPIOBundle::read() const {
+#if SOC_DEDICATED_GPIO_SUPPORTED
+        return (dedic_gpio_cpu_ll_read_in() >> _inputShift) & _widthMask;
+#else
+        return _levels;
+#endif
+    }
+}  // namespace esp
@@ -9,12 +9,25 @@
 
 #include "ADC/Continuous.hpp"
 #include "ADC/Oneshot.hpp"
+#include "BitBangSerial.hpp"
+#include "Coroutine.hpp"
+#include "DedicatedGPIO.hpp"
+#include "Debounce.hpp"
 #include "GPIO.hpp"
+#include "GPIOBus.hpp"
+#include "GPIOFastInterrupts.hpp"
+#include "GPIOInterruptDispatcher.hpp"
+#include "GPTimerScheduler.hpp"
 #include "MCPWM/MCPWM.hpp"
+#include "PCNT/PulseCounter.hpp"
+#include "PeriodicExecutor.hpp"
 #include "Timer.hpp"
+#include "TimerWheel.hpp"
 
 #include <memory>
+#include <span>
 #include <unordered_set>
+#include <vector>
 
 namespace esp {
     class ESP32;
@@ -40,11 +53,34 @@ namespace esp {
         adc::ADCOneshotPtr<adc::Calibrated> adcOneshot(adc::ADCCalibrationPtr calibration, esp_err_t& err);
         adc::ADCContinuousPtr adcContinuous(const adc::ADCContinuousConfig& config, esp_err_t& err);
 
+        // Only before the first pin sets an interrupt, which is when the service is installed.
+        void setGPIOISRServiceConfig(const GPIOISRServiceConfig& config, esp_err_t& err);
+        const GPIOISRServiceConfig& gpioISRServiceConfig() const;
+
         GPIOPtr gpio(GPIOConfig gpioConfig, esp_err_t& err);
+        // Like gpio for each config, but pins sharing settings are configured together in one driver call.  Returned in the same order.
+        std::vector<GPIOPtr> gpios(std::span<const GPIOConfig> gpioConfigs, esp_err_t& err);
+        GPIOBusPtr gpioBus(const GPIOBusConfig& config, esp_err_t& err);
+        DedicatedGPIOBundlePtr dedicatedGPIOBundle(const DedicatedGPIOBundleConfig& config, esp_err_t& err);
+        BitBangSerialPtr bitBangSerial(const BitBangSerialConfig& config, esp_err_t& err);
 
         mcpwm::MCPWM& mcpwm() { return _mcpwm; }
 
+        pcnt::PulseCounterPtr pulseCounter(const pcnt::PulseCounterConfig& config, esp_err_t& err);
+
         std::expected<TimerPtr, esp_err_t> timer(const TimerConfig& config);
+        // Calls function, with its captures stored inside the timer, in place of config's callback and userInfo.
+        std::expected<TimerPtr, esp_err_t> timer(const TimerConfig& config, TimerFunction function);
+        TimerWheelPtr timerWheel(const TimerWheelConfig& config, esp_err_t& err);
+        PeriodicClockPtr periodicClock(const PeriodicClockConfig& config, esp_err_t& err);
+        PeriodicExecutorPtr periodicExecutor(const PeriodicExecutorConfig& config, esp_err_t& err);
+        GPTimerSchedulerPtr gpTimerScheduler(const GPTimerSchedulerConfig& config, esp_err_t& err);
+        CoroutineExecutorPtr coroutineExecutor(const CoroutineExecutorConfig& config, esp_err_t& err);
+
+        DebounceGroupPtr debounceGroup(const DebounceGroupConfig& config, esp_err_t& err);
+        GPIOInterruptDispatcherPtr gpioInterruptDispatcher(const GPIOInterruptDispatcherConfig& config, esp_err_t& err);
+        // Only one can exist at a time, and only while no pin has an interrupt set through the ISR service.
+        GPIOFastInterruptsPtr gpioFastInterrupts(const GPIOFastInterruptsConfig& config, esp_err_t& err);
 
         static std::pair<adc_unit_t, adc_channel_t> adcChannelForGPIO(gpio_num_t gpio, esp_err_t& err);
         static gpio_num_t gpioForAdcChannel(adc_unit_t unit, adc_channel_t channel, esp_err_t& err);
@@ -58,6 +94,7 @@ namespace esp {
         std::vector<std::weak_ptr<adc::ADCOneshot<adc::Calibrated>>> _calibratedAdcs;
         std::vector<std::weak_ptr<adc::ADCContinuous>> _continuousAdcs;
         std::vector<std::weak_ptr<GPIO>> _gpios;
+        std::weak_ptr<GPIOFastInterrupts> _gpioFastInterrupts;
 
         mcpwm::MCPWM _mcpwm;
 
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "Testing.hpp"
 
 #include <esp_event.h>
@@ -74,6 +76,10 @@ namespace esp {
         void postEvent(esp_event_base_t eventBase, int32_t eventId, void* eventData, TickType_t ticksToWait, esp_err_t& err);
         BaseType_t postEventFromISR(esp_event_base_t eventBase, int32_t eventId, void* eventData, esp_err_t& err);
 
+        // For posting with esp_event_isr_post_to from ISRs that can't risk postEventFromISR's logging, nullptr for the default loop, which
+        // takes esp_event_isr_post.
+        esp_event_loop_handle_t handle() const { return _isDefaultLoop ? nullptr : _handle; }
+
     private:
         EventLoop(const EventLoopConfig& config, esp_err_t& err);
         EventLoop();
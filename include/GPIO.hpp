@@ -8,11 +8,22 @@
 #pragma once
 
 #include "Enums.hpp"
+#include "EventLoop.hpp"
+#include "Testing.hpp"
 
 #include <driver/gpio.h>
+#include <esp_event.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 
 namespace esp {
     struct GPIOMode {
@@ -85,9 +96,24 @@ namespace esp {
     int interuptFlags(GPIOInteruptType type);
 
     void _interruptHandler(void* arg);
+    void _captureInterruptHandler(void* arg);
+    void _deferredInterruptHandler(void* arg);
 
     using GPIOInteruptCallback = void(*)(void* userInfo);
 
+    class GPIO;
+
+    class GPIOInterruptDispatcher;
+    using GPIOInterruptDispatcherPtr = std::shared_ptr<GPIOInterruptDispatcher>;
+
+    struct GPIODeferredInterrupt {
+        // Edges since the pin was last dispatched.
+        uint32_t edges;
+        std::chrono::microseconds lastEdgeTime;
+    };
+
+    using GPIODeferredInterruptCallback = void(*)(GPIO& gpio, const GPIODeferredInterrupt& interrupt, void* userInfo);
+
     struct GPIOConfig {
     public:
         GPIOConfig(gpio_num_t num, GPIOMode m, PullUp pu = PullUp::Disable, PullDown pd = PullDown::Disable)
@@ -100,6 +126,52 @@ namespace esp {
         GPIOInteruptType interuptType = GPIOInteruptType::Disable;
     };
 
+    enum class GPIOTimestampSource : uint8_t {
+        // CPU cycle counter, the cheapest to read but only meaningful if the CPU frequency doesn't change while capturing.
+        CPUCycles = 0,
+        Microseconds
+    };
+
+    struct GPIOCaptureConfig {
+        // Edges the ring holds before further edges are dropped, rounded up to a power of two.
+        size_t capacity = 64;
+        GPIOInteruptType interuptType = GPIOInteruptType::AnyEdge;
+        GPIOTimestampSource timestampSource = GPIOTimestampSource::CPUCycles;
+    };
+
+    struct GPIOEdge {
+        // In the units of the capture's timestamp source, wrapping at 32 bits.
+        uint32_t timestamp;
+        Level level;
+    };
+
+    ESP_EVENT_DECLARE_BASE(GPIO_INTERRUPT_BUDGET_EVENT);
+
+    // Posted with the pin's gpio_num_t as the event data.
+    enum class GPIOInterruptBudgetEvent : int32_t {
+        Throttled = 0,
+        Restored
+    };
+
+    struct GPIOInterruptBudget {
+        // 0 removes the budget.
+        uint32_t maxEdges = 0;
+        std::chrono::microseconds window{0};
+        // How long the interrupt stays disabled once the budget is exceeded.
+        std::chrono::microseconds coolDown{0};
+        // Where transitions are posted, the default event loop if not given.
+        EventLoopPtr eventLoop;
+    };
+
+    struct GPIOISRServiceConfig {
+        // ESP_INTR_FLAG_* flags other than the level.
+        int interruptFlags = ESP_INTR_FLAG_EDGE;
+        // Interrupt level 1 to 3, or 0 for any low or medium level.
+        uint8_t priority = 0;
+        // The core GPIO interrupts are handled on, or tskNO_AFFINITY for whichever core first sets an interrupt.
+        BaseType_t coreId = tskNO_AFFINITY;
+    };
+
     bool operator==(const GPIOMode& a, const GPIOMode& b);
     bool operator==(const GPIOConfig& a, const GPIOConfig& b);
 
@@ -122,21 +194,130 @@ namespace esp {
         GPIOInteruptType interruptType() const;
         void setInterrupt(GPIOInteruptType type, GPIOInteruptCallback callback, void* userInfo, esp_err_t& err);
 
+        // Run the callback in the dispatcher's task rather than the ISR, with edges coalesced between dispatches.
+        void setDeferredInterrupt(GPIOInteruptType type, GPIOInterruptDispatcherPtr dispatcher, GPIODeferredInterruptCallback callback, void* userInfo,
+                                  esp_err_t& err);
+
+        // Bound the load a chattering input can put on the ISR.  Past maxEdges in one window the pin's interrupt is disabled, and is
+        // enabled again after the cool-down.  The pin is sampled as it's throttled and again as it's restored, and a change of level its
+        // edge type would have caught is recorded by a capture or signalled to a deferred interrupt's dispatcher then.  A setInterrupt
+        // callback is only ever called from the ISR, so it isn't called for it, and the Restored event is the cue to read the level.
+        void setInterruptBudget(const GPIOInterruptBudget& budget, esp_err_t& err);
+
+        bool interruptThrottled() const { return _throttled.load(std::memory_order_relaxed); }
+
+        // Times the budget has been exceeded.
+        uint32_t interruptThrottles() const { return _throttles.load(std::memory_order_relaxed); }
+
+        // Throttled and Restored events that couldn't be posted as the event loop's queue was full.
+        uint32_t failedBudgetEvents() const { return _failedBudgetEvents.load(std::memory_order_relaxed); }
+
         bool level();
         void setLevel(Level level, esp_err_t& err);
 
+        // Record edges from the ISR into a preallocated ring instead of calling back, for measuring signals too fast for a callback per
+        // edge.  Captured edges are consumed either with readEdges or by the measurement helpers, not both.
+        void startCapture(const GPIOCaptureConfig& config, esp_err_t& err);
+        void stopCapture(esp_err_t& err);
+
+        size_t readEdges(std::span<GPIOEdge> edges);
+
+        // Edges lost because the ring was full.
+        uint32_t droppedEdges() const { return _droppedEdges.load(std::memory_order_relaxed); }
+
+        // The most recent complete measurements, after consuming every captured edge.
+        std::optional<std::chrono::nanoseconds> pulseWidth(Level level);
+        std::optional<std::chrono::nanoseconds> period();
+        std::optional<float> frequencyHz();
+
+        PRIVATE_UNLESS_TESTING
+        // Lets tests configure the service whatever ran before them.
+        static void _uninstallIsrService();
+
     private:
         GPIO(const GPIOConfig& gpioConfig, esp_err_t& err);
+        // For pins already configured by _configure.
+        explicit GPIO(const GPIOConfig& gpioConfig);
+
+        // Apply the settings in config to every pin in pinMask with one driver call.
+        static void _configure(uint64_t pinMask, const GPIOConfig& config, esp_err_t& err);
+        // Installed by the first pin to use an interrupt, so pins that never do don't pay for it.
+        static void _installIsrService(esp_err_t& err);
+        // Uninstalls the service and keeps it from being installed again, until called with false.
+        static void _suspendIsrService(bool suspend);
+        // Interrupts are allocated on the core that asks for them, so ask from a short lived task pinned to coreId.
+        static void _runOnCore(BaseType_t coreId, void (*function)(void* arg), void* arg, esp_err_t& err);
+
+        void _removeDispatcher();
+
+        // Called by every ISR handler before doing anything else, returning false once the pin is over budget.
+        bool _admitInterrupt();
+        static void _onCoolDown(void* userInfo);
+        // Deliver a change of level missed while throttled, with the interrupt still disabled.
+        void _deliverMissedEdge(Level level);
+
+        uint32_t _captureTimestamp() const;
+        // Single producer, from the capture ISR or while it's disabled.
+        void _recordEdge(const GPIOEdge& edge);
+        void _updateMeasurements();
+        std::chrono::nanoseconds _captureDuration(uint32_t ticks) const;
 
         GPIOConfig _config;
         GPIOInteruptCallback _interuptCallback;
         std::pair<GPIO*, void*> _userInfo;
+        GPIOInterruptDispatcherPtr _dispatcher;
+
+        // Single producer ring written by the capture ISR.
+        GPIOCaptureConfig _captureConfig;
+        std::unique_ptr<GPIOEdge[]> _edges;
+        uint32_t _edgeMask = 0;
+        std::atomic<uint32_t> _edgeHead = 0;
+        std::atomic<uint32_t> _edgeTail = 0;
+        std::atomic<uint32_t> _droppedEdges = 0;
+        bool _capturing = false;
+
+        // Holds the event loop, while the ISR only uses the copies below.
+        GPIOInterruptBudget _interruptBudget;
+        // esp_timer directly, as the ISR starts it and esp::Timer can log.
+        esp_timer_handle_t _coolDownTimer = nullptr;
+        // Guards everything the ISR uses to keep to the budget.
+        portMUX_TYPE _budgetLock = portMUX_INITIALIZER_UNLOCKED;
+        // Also read without the lock, so pins without a budget never take it.
+        std::atomic<uint32_t> _budgetMaxEdges = 0;
+        int64_t _budgetWindow = 0;
+        int64_t _budgetCoolDown = 0;
+        // nullptr for the default event loop.
+        esp_event_loop_handle_t _budgetEventLoop = nullptr;
+        int64_t _windowStart = 0;
+        uint32_t _windowEdges = 0;
+        Level _throttledLevel = Level::Low;
+        std::atomic<bool> _throttled = false;
+        std::atomic<uint32_t> _throttles = 0;
+        std::atomic<uint32_t> _failedBudgetEvents = 0;
+        // Event data is copied from a pointer sized location.
+        intptr_t _eventPin = 0;
+
+        std::optional<GPIOEdge> _lastEdge;
+        std::optional<uint32_t> _lastRise;
+        std::optional<uint32_t> _highWidth;
+        std::optional<uint32_t> _lowWidth;
+        std::optional<uint32_t> _period;
 
         friend void esp::_interruptHandler(void* arg);
+        friend void esp::_captureInterruptHandler(void* arg);
+        friend void esp::_deferredInterruptHandler(void* arg);
 
         static constexpr char _loggingTag[] = "esp::GPIO";
 
+        // Guards the service's config and flags, as pins and GPIOFastInterrupts can be set up from any task.
+        static inline std::mutex _isrServiceMutex;
+        static inline GPIOISRServiceConfig _isrServiceConfig;
+        static inline bool _isrServiceInstalled = false;
+        // Set while GPIOFastInterrupts owns the GPIO interrupt, which the ISR service would otherwise claim.
+        static inline bool _isrServiceSuspended = false;
+
         friend class ESP32;
+        friend class GPIOFastInterrupts;
     };
 
     using GPIOPtr = std::shared_ptr<GPIO>;
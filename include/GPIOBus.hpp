@@ -0,0 +1,122 @@
+#pragma once
+
+#include "GPIO.hpp"
+
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+#include <soc/soc_caps.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace esp {
+    class GPIOBus;
+    using GPIOBusPtr = std::shared_ptr<GPIOBus>;
+
+    struct GPIOBusConfig {
+        // Bit i of every bus value is pins[i].
+        std::vector<gpio_num_t> pins;
+        GPIOMode mode = GPIOModeOutput;
+        PullUp pullUp = PullUp::Disable;
+        PullDown pullDown = PullDown::Disable;
+    };
+
+    // A group of up to 32 pins written with one W1TS/W1TC register pair per bank and read with one input register read per bank.
+    // The pins are claimed through ESP32::gpio, so they can't be reconfigured from under the bus.
+    class GPIOBus {
+    public:
+        static constexpr size_t kMaximumWidth = 32;
+
+        const GPIOBusConfig& config() const { return _config; }
+
+        size_t width() const { return _config.pins.size(); }
+
+        // Drive every pin in the bus.
+        void write(uint32_t value);
+
+        // Drive only the pins selected by mask, leaving the others alone.
+        void write(uint32_t mask, uint32_t value);
+
+        uint32_t read() const;
+
+    private:
+        GPIOBus(const GPIOBusConfig& config, std::vector<GPIOPtr> gpios, esp_err_t& err);
+
+#if SOC_GPIO_PIN_COUNT > 32
+        static constexpr size_t kNumBanks = 2;
+#else
+        static constexpr size_t kNumBanks = 1;
+#endif
+
+        GPIOBusConfig _config;
+        std::vector<GPIOPtr> _gpios;
+
+        std::array<uint32_t, kMaximumWidth> _bankMasks = {};
+        std::array<uint8_t, kMaximumWidth> _banks = {};
+        std::array<bool, kNumBanks> _usesBank = {};
+
+        // Set when the pins are consecutive in one bank, so values can be shifted into place instead of scattered bit by bit.
+        bool _contiguous = false;
+        uint8_t _shift = 0;
+        uint32_t _widthMask = 0;
+
+        static constexpr char _loggingTag[] = "esp::GPIOBus";
+
+        friend class ESP32;
+    };
+
+    //
+    // IMPLEMENTATION
+    //
+    inline void GPIOBus::write(uint32_t value) {
+        write(_widthMask, value);
+    }
+
+    inline void GPIOBus::write(uint32_t mask, uint32_t value) {
+        std::array<uint32_t, kNumBanks> set = {};
+        std::array<uint32_t, kNumBanks> clear = {};
+        mask &= _widthMask;
+        if (_contiguous) {
+            set[_banks[0]] = (value & mask) << _shift;
+            clear[_banks[0]] = (~value & mask) << _shift;
+        } else {
+            for (size_t i = 0; i < width(); i++) {
+                if ((mask & (1u << i)) != 0) {
+                    ((value & (1u << i)) != 0 ? set : clear)[_banks[i]] |= _bankMasks[i];
+                }
+            }
+        }
+
+        if (_usesBank[0]) {
+            REG_WRITE(GPIO_OUT_W1TS_REG, set[0]);
+            REG_WRITE(GPIO_OUT_W1TC_REG, clear[0]);
+        }
+#if SOC_GPIO_PIN_COUNT > 32
+        if (_usesBank[1]) {
+            REG_WRITE(GPIO_OUT1_W1TS_REG, set[1]);
+            REG_WRITE(GPIO_OUT1_W1TC_REG, clear[1]);
+        }
+#endif
+    }
+
+    inline uint32_t GPIOBus::read() const {
+        std::array<uint32_t, kNumBanks> levels = {};
+        levels[0] = _usesBank[0] ? REG_READ(GPIO_IN_REG) : 0;
+#if SOC_GPIO_PIN_COUNT > 32
+        levels[1] = _usesBank[1] ? REG_READ(GPIO_IN1_REG) : 0;
+#endif
+        if (_contiguous) {
+            return (levels[_banks[0]] >> _shift) & _widthMask;
+        }
+
+        uint32_t value = 0;
+        for (size_t i = 0; i < width(); i++) {
+            if ((levels[_banks[i]] & _bankMasks[i]) != 0) {
+                value |= 1u << i;
+            }
+        }
+        return value;
+    }
+}  // namespace esp
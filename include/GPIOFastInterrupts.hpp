@@ -0,0 +1,82 @@
+#pragma once
+
+#include "GPIO.hpp"
+#include "Testing.hpp"
+
+#include <esp_intr_alloc.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <soc/soc_caps.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace esp {
+    class GPIOFastInterrupts;
+    using GPIOFastInterruptsPtr = std::shared_ptr<GPIOFastInterrupts>;
+
+    // Called from the ISR, so it must be IRAM_ATTR and must not block.
+    using GPIOFastInterruptCallback = void(*)(gpio_num_t pin, void* userInfo);
+
+    struct GPIOFastInterruptsConfig {
+        // The core the ISR runs on, or tskNO_AFFINITY for the core creating it.
+        BaseType_t coreId = tskNO_AFFINITY;
+        int interruptFlags = ESP_INTR_FLAG_IRAM | ESP_INTR_FLAG_LEVEL3;
+    };
+
+    // Takes the GPIO interrupt over from the driver's ISR service with a single IRAM ISR.  The ISR reads the status registers once and
+    // calls each pending pin's callback straight out of a flat table, skipping the service's per pin dispatch and GPIO's trampoline.
+    // While one exists, setInterrupt, setDeferredInterrupt and startCapture are unavailable on every pin.
+    class GPIOFastInterrupts {
+    public:
+        ~GPIOFastInterrupts();
+
+        const GPIOFastInterruptsConfig& config() const { return _config; }
+
+        void attach(GPIOPtr gpio, GPIOInteruptType type, GPIOFastInterruptCallback callback, void* userInfo, esp_err_t& err);
+        void detach(GPIOPtr gpio, esp_err_t& err);
+
+        PRIVATE_UNLESS_TESTING
+        // Call the callbacks for every attached pin set in one bank's interrupt status.
+        void dispatch(uint32_t bank, uint32_t status);
+
+    private:
+        GPIOFastInterrupts(const GPIOFastInterruptsConfig& config, esp_err_t& err);
+
+        void _register(esp_err_t& err);
+        // Wait out a dispatch in flight on the ISR's core, unless this is that dispatch, calling from one of its callbacks.
+        void _drain() const;
+
+        static void _isr(void* arg);
+
+#if SOC_GPIO_PIN_COUNT > 32
+        static constexpr size_t kNumBanks = 2;
+#else
+        static constexpr size_t kNumBanks = 1;
+#endif
+
+        struct Entry {
+            GPIOFastInterruptCallback callback = nullptr;
+            void* userInfo = nullptr;
+        };
+
+        GPIOFastInterruptsConfig _config;
+        // An entry is only written while its mask bit is clear and no dispatch that could have seen the bit set is in flight, so the
+        // ISR never takes a lock, and never reads an entry mid change.
+        std::array<Entry, kNumBanks * 32> _entries = {};
+        std::array<std::atomic<uint32_t>, kNumBanks> _masks = {};
+        // Raised by the ISR before it reads the masks and lowered once its callbacks have returned.
+        std::atomic<uint32_t> _inFlight = 0;
+        BaseType_t _isrCore = 0;
+        std::array<GPIOPtr, kNumBanks * 32> _gpios;
+
+        intr_handle_t _handle = nullptr;
+        esp_err_t _registerErr = ESP_OK;
+
+        static constexpr char _loggingTag[] = "esp::GPIOFastInterrupts";
+
+        friend class ESP32;
+    };
+}  // namespace esp
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "EventLoop.hpp"
+#include "GPIO.hpp"
+
+#include <esp_event.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <soc/soc_caps.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace esp {
+    ESP_EVENT_DECLARE_BASE(GPIO_INTERRUPT_DISPATCH_EVENT);
+
+    struct GPIOInterruptDispatcherConfig {
+        // Callbacks run on a dedicated task, or on the event loop's task when an event loop is given instead.
+        std::optional<TaskInfo> taskInfo;
+        EventLoopPtr eventLoop;
+    };
+
+    // Moves GPIO interrupt callbacks out of ISR context.  The ISR only marks its pin pending, counts the edge and stamps it, and wakes the
+    // dispatcher if nothing else was pending, so a burst of edges across any number of pins costs one wakeup.  The dispatcher then drains
+    // every pending pin in one pass.
+    class GPIOInterruptDispatcher {
+    public:
+        ~GPIOInterruptDispatcher();
+
+        // Times an edge couldn't post to the event loop to wake the dispatcher, each retried by the pin's next edge.
+        uint32_t failedWakes() const { return _failedWakes.load(std::memory_order_relaxed); }
+
+    private:
+        GPIOInterruptDispatcher(const GPIOInterruptDispatcherConfig& config, esp_err_t& err);
+
+        void _add(GPIO* gpio, GPIODeferredInterruptCallback callback, void* userInfo);
+        void _remove(GPIO* gpio);
+
+        void _signalFromISR(gpio_num_t pin);
+        // For an edge delivered from a task.
+        void _signal(gpio_num_t pin);
+        // Count and stamp the edge and mark the pin pending, returning true if the dispatcher needs waking.
+        bool _markPending(gpio_num_t pin);
+        void _drain();
+
+        static void _dispatchTask(void* userInfo);
+
+#if SOC_GPIO_PIN_COUNT > 32
+        static constexpr size_t kNumBanks = 2;
+#else
+        static constexpr size_t kNumBanks = 1;
+#endif
+
+        struct Pin {
+            GPIO* gpio = nullptr;
+            GPIODeferredInterruptCallback callback = nullptr;
+            void* userInfo = nullptr;
+            std::atomic<uint32_t> edges = 0;
+            // Microseconds, truncated to 32 bits so the ISR only touches lock free atomics.
+            std::atomic<uint32_t> lastEdgeTime = 0;
+        };
+
+        GPIOInterruptDispatcherConfig _config;
+        std::array<Pin, kNumBanks * 32> _pins;
+        // Held while draining so a pin can't be removed under its callback.  Recursive so callbacks may reconfigure their own pin.
+        std::recursive_mutex _pinsMutex;
+        std::array<std::atomic<uint32_t>, kNumBanks> _pending = {};
+        // Set when the ISR couldn't wake the dispatcher, so the next edge tries again.
+        std::atomic<bool> _wakeFailed = false;
+        std::atomic<uint32_t> _failedWakes = 0;
+
+        TaskHandle_t _task = nullptr;
+        TaskHandle_t _stoppingTask = nullptr;
+        std::atomic<bool> _running = false;
+        EventHandlerInstancePtr _eventHandler;
+        // nullptr for the default loop, which the ISR posts to with esp_event_isr_post.
+        esp_event_loop_handle_t _eventLoopHandle = nullptr;
+        GPIOInterruptDispatcher* _self = this;
+
+        static constexpr char _loggingTag[] = "esp::GPIOInterruptDispatcher";
+
+        friend class ESP32;
+        friend class GPIO;
+        friend void esp::_deferredInterruptHandler(void* arg);
+    };
+}  // namespace esp
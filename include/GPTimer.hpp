@@ -15,6 +15,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 
 namespace esp {
     IRAM_ATTR bool _onAlarm(gptimer_handle_t timerHandle, const gptimer_alarm_event_data_t* eventData, void* userInfo);
@@ -24,9 +25,30 @@ namespace esp {
 
     using GPTimerCallback = InterruptResult(*)(GPTimer&, const gptimer_alarm_event_data_t&, void* userInfo);
 
+    enum class GPTimerDirection : uint8_t {
+        Up = GPTIMER_COUNT_UP,
+        Down = GPTIMER_COUNT_DOWN
+    };
+
+    struct GPTimerAlarm {
+        // In ticks at the timer's resolution.
+        uint64_t alarmCount;
+        uint64_t reloadCount = 0;
+        bool autoReload = true;
+    };
+
     struct GPTimerConfig {
-        uint32_t durationMicroseconds;
         GPTimerCallback callback;
+        gptimer_clock_source_t clockSource = GPTIMER_CLK_SRC_DEFAULT;
+        // Ticks per second, up to what the clock source can be divided down to.
+        uint32_t resolutionHz = 1'000'000;
+        GPTimerDirection direction = GPTimerDirection::Up;
+        InterruptPriority interruptPriority = Default;
+        // Share the interrupt with other peripherals.
+        bool interruptShared = false;
+        bool allowPowerDown = false;
+        // Otherwise the timer counts without an alarm until setAlarm is called.
+        std::optional<GPTimerAlarm> alarm = std::nullopt;
     };
 
     class GPTimer {
@@ -34,11 +56,24 @@ namespace esp {
         GPTimer(const GPTimerConfig& config, void* userInfo, esp_err_t& err);
         ~GPTimer();
 
+        const GPTimerConfig& config() const { return _config; }
+
+        // The resolution the driver actually set, in Hz.
+        uint32_t resolution(esp_err_t& err) const;
+
         void start(esp_err_t& err);
         void stop(esp_err_t& err);
 
+        // Safe from the alarm callback and other ISRs, so don't log.  Setting an alarm from the callback is how to vary the period
+        // from one alarm to the next.
+        IRAM_ATTR void setAlarm(const GPTimerAlarm& alarm, esp_err_t& err);
+        IRAM_ATTR void clearAlarm(esp_err_t& err);
+        IRAM_ATTR uint64_t count(esp_err_t& err) const;
+        IRAM_ATTR void setCount(uint64_t count, esp_err_t& err);
+
     private:
-        gptimer_handle_t _timer;
+        GPTimerConfig _config;
+        gptimer_handle_t _timer = nullptr;
 
         IRAM_ATTR bool onAlarm(const gptimer_alarm_event_data_t& eventData, void* userInfo);
 
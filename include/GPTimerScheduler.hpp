@@ -0,0 +1,139 @@
+#pragma once
+
+#include "GPTimer.hpp"
+#include "Interrupt.hpp"
+#include "Testing.hpp"
+
+#include <freertos/FreeRTOS.h>
+
+#include <cstdint>
+#include <memory>
+
+namespace esp {
+    class GPTimerScheduler;
+    using GPTimerSchedulerPtr = std::shared_ptr<GPTimerScheduler>;
+
+    // Called from the ISR, so it must be IRAM_ATTR and must not block.  count is the event's scheduled count.
+    using GPTimerEventCallback = InterruptResult(*)(GPTimerScheduler& scheduler, uint64_t count, void* userInfo);
+
+    struct GPTimerSchedulerConfig {
+        gptimer_clock_source_t clockSource = GPTIMER_CLK_SRC_DEFAULT;
+        // Ticks per second of the counter events are scheduled against.
+        uint32_t resolutionHz = 1'000'000;
+        InterruptPriority interruptPriority = Default;
+        // The most events that can be pending at once, all allocated up front.
+        size_t capacity = 32;
+    };
+
+    // The counter and alarm the scheduler runs on, its GPTimer unless replaced for testing.  Called from the alarm ISR with the scheduler's
+    // lock held, so both must be IRAM_ATTR.
+    struct GPTimerSchedulerPort {
+        uint64_t (*count)(void* context) = nullptr;
+        void (*setAlarm)(void* context, uint64_t alarmCount) = nullptr;
+        void* context = nullptr;
+    };
+
+    // Identifies one scheduled event, going stale once it's dispatched or cancelled.
+    struct GPTimerEventHandle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    struct GPTimerSchedulerStats {
+        uint32_t dispatched = 0;
+        // Events already due when they were scheduled.
+        uint32_t scheduledLate = 0;
+        // Ticks from each event's count to its dispatch.
+        uint64_t worstLatency = 0;
+        uint64_t totalLatency = 0;
+    };
+
+    // Runs many one shot events off a single free running GPTimer.  Pending events are kept in a min-heap of absolute counts over a
+    // fixed pool, and the alarm is always set for the earliest.  The alarm ISR dispatches every event that's due, then sets the next
+    // alarm, dispatching straight away any event that comes due before the alarm could be set.
+    class GPTimerScheduler {
+    public:
+        ~GPTimerScheduler();
+
+        const GPTimerSchedulerConfig& config() const { return _config; }
+
+        void start(esp_err_t& err);
+        void stop(esp_err_t& err);
+
+        // Safe from ISRs, including event callbacks.
+        uint64_t count() const;
+
+        // Safe from ISRs, including event callbacks.  ESP_ERR_NO_MEM when capacity events are already pending.  An event scheduled
+        // for a count that has passed is dispatched as soon as possible.
+        GPTimerEventHandle scheduleAt(uint64_t count, GPTimerEventCallback callback, void* userInfo, esp_err_t& err);
+        GPTimerEventHandle scheduleAfter(uint64_t ticks, GPTimerEventCallback callback, void* userInfo, esp_err_t& err);
+        // Returns false if the event had already been dispatched or cancelled.
+        bool cancel(GPTimerEventHandle handle);
+
+        size_t pendingEvents() const;
+
+        GPTimerSchedulerStats stats() const;
+        void resetStats();
+
+        PRIVATE_UNLESS_TESTING
+        // Run on port instead of the GPTimer, which is left alone from then on.  Only before any event is scheduled.
+        void setPort(const GPTimerSchedulerPort& port);
+        // What the alarm ISR does: dispatch every event that's due and set the next alarm.  Returns true if a callback woke a higher
+        // priority task.
+        bool fireAlarm();
+
+    private:
+        GPTimerScheduler(const GPTimerSchedulerConfig& config, esp_err_t& err);
+
+        static constexpr uint32_t kNil = UINT32_MAX;
+        // How far ahead of the counter an alarm is first set when the event it's for is about to come due.
+        static constexpr uint64_t kMinimumLead = 2;
+
+        struct Event {
+            uint64_t count = 0;
+            GPTimerEventCallback callback = nullptr;
+            void* userInfo = nullptr;
+            uint32_t generation = 0;
+            // Position in _heap, or the next free event while free.
+            uint32_t heapIndex = kNil;
+            uint32_t nextFree = kNil;
+        };
+
+        uint64_t _count() const;
+
+        // The rest need _lock held.
+        void _push(uint32_t index);
+        void _remove(uint32_t heapPosition);
+        void _siftUp(uint32_t heapPosition);
+        void _siftDown(uint32_t heapPosition);
+        void _swap(uint32_t a, uint32_t b);
+        void _free(uint32_t index);
+        // Set the alarm for the earliest event, or just ahead of the counter if it's too close.  Returns false if the event is already
+        // due, so it can be dispatched without waiting for the alarm.
+        bool _armNext();
+
+        // Dispatch every event that's due, releasing _lock around each callback.  Returns true if a callback woke a higher priority
+        // task.
+        bool _dispatch();
+
+        static InterruptResult _onAlarm(GPTimer& timer, const gptimer_alarm_event_data_t& eventData, void* userInfo);
+        static uint64_t _timerCount(void* context);
+        static void _setTimerAlarm(void* context, uint64_t alarmCount);
+
+        GPTimerSchedulerConfig _config;
+        GPTimerPtr _timer;
+        GPTimerSchedulerPort _port = {.count = _timerCount, .setAlarm = _setTimerAlarm, .context = this};
+
+        // Plain arrays rather than vectors, so nothing the ISR touches lives outside IRAM.
+        mutable portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+        std::unique_ptr<Event[]> _events;
+        std::unique_ptr<uint32_t[]> _heap;
+        uint32_t _heapSize = 0;
+        uint32_t _freeList = kNil;
+        GPTimerSchedulerStats _stats;
+
+        static constexpr char _loggingTag[] = "esp::GPTimerScheduler";
+
+        friend class ESP32;
+    };
+}  // namespace esp
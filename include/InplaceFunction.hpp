@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace esp {
+    template <typename Signature, size_t Capacity = 32>
+    class InplaceFunction;
+
+    // A move only std::function that keeps its callable in an inline buffer instead of on the heap.  Callables that don't fit, or
+    // could throw while being moved, are a compile error rather than an allocation.
+    template <typename R, typename... Args, size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity> {
+    public:
+        InplaceFunction() = default;
+        InplaceFunction(std::nullptr_t) {}
+
+        template <typename F>
+            requires(!std::is_same_v<std::decay_t<F>, InplaceFunction>)
+        InplaceFunction(F&& function) {
+            using Callable = std::decay_t<F>;
+            static_assert(std::is_invocable_r_v<R, Callable&, Args...>, "InplaceFunction: callable has the wrong signature");
+            static_assert(sizeof(Callable) <= Capacity, "InplaceFunction: callable is too large for the inline buffer");
+            static_assert(alignof(Callable) <= alignof(std::max_align_t), "InplaceFunction: callable is over aligned");
+            static_assert(std::is_nothrow_move_constructible_v<Callable>, "InplaceFunction: callable must be nothrow move constructible");
+
+            if constexpr (std::is_pointer_v<Callable> || std::is_member_pointer_v<Callable>) {
+                if (function == nullptr) {
+                    return;
+                }
+            }
+
+            ::new (static_cast<void*>(_storage)) Callable(std::forward<F>(function));
+            _invoke = [](void* storage, Args&&... args) -> R {
+                return std::invoke(*static_cast<Callable*>(storage), std::forward<Args>(args)...);
+            };
+            _manage = [](void* destination, void* source) {
+                Callable* callable = static_cast<Callable*>(source);
+                if (destination != nullptr) {
+                    ::new (destination) Callable(std::move(*callable));
+                }
+                callable->~Callable();
+            };
+        }
+
+        InplaceFunction(const InplaceFunction& other) = delete;
+        InplaceFunction(InplaceFunction&& other) noexcept { _take(other); }
+        ~InplaceFunction() { _reset(); }
+
+        InplaceFunction& operator=(const InplaceFunction& other) = delete;
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept;
+        InplaceFunction& operator=(std::nullptr_t) noexcept;
+
+        explicit operator bool() const { return _invoke != nullptr; }
+
+        R operator()(Args... args) { return _invoke(_storage, std::forward<Args>(args)...); }
+
+    private:
+        // Moves the callable from source into destination, or just destroys source when destination is nullptr.
+        using Manager = void (*)(void* destination, void* source);
+
+        void _take(InplaceFunction& other) noexcept;
+        void _reset() noexcept;
+
+        alignas(std::max_align_t) std::byte _storage[Capacity];
+        R (*_invoke)(void* storage, Args&&... args) = nullptr;
+        Manager _manage = nullptr;
+    };
+
+    //
+    // IMPLEMENTATION
+    //
+    template <typename R, typename... Args, size_t Capacity>
+    InplaceFunction<R(Args...), Capacity>& InplaceFunction<R(Args...), Capacity>::operator=(InplaceFunction&& other) noexcept {
+        if (&other != this) {
+            _reset();
+            _take(other);
+        }
+        return *this;
+    }
+
+    template <typename R, typename... Args, size_t Capacity>
+    InplaceFunction<R(Args...), Capacity>& InplaceFunction<R(Args...), Capacity>::operator=(std::nullptr_t) noexcept {
+        _reset();
+        return *this;
+    }
+
+    template <typename R, typename... Args, size_t Capacity>
+    void InplaceFunction<R(Args...), Capacity>::_take(InplaceFunction& other) noexcept {
+        if (other._manage == nullptr) {
+            return;
+        }
+
+        other._manage(_storage, other._storage);
+        _invoke = std::exchange(other._invoke, nullptr);
+        _manage = std::exchange(other._manage, nullptr);
+    }
+
+    template <typename R, typename... Args, size_t Capacity>
+    void InplaceFunction<R(Args...), Capacity>::_reset() noexcept {
+        if (_manage != nullptr) {
+            _manage(nullptr, _storage);
+        }
+        _invoke = nullptr;
+        _manage = nullptr;
+    }
+}  // namespace esp
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "PCNT/Types.hpp"
+
+#include <driver/gpio.h>
+#include <driver/pulse_cnt.h>
+
+#include <memory>
+
+namespace esp {
+    namespace pcnt {
+        struct ChannelConfig {
+            gpio_num_t edgeGPIO;
+            // GPIO_NUM_NC for a channel that only counts edges.
+            gpio_num_t levelGPIO = GPIO_NUM_NC;
+            bool invertEdgeInput = false;
+            bool invertLevelInput = false;
+        };
+
+        class Channel;
+        using ChannelPtr = std::shared_ptr<Channel>;
+
+        class PulseCounter;
+        using PulseCounterPtr = std::shared_ptr<PulseCounter>;
+
+        // One input of a pulse counter unit.  A channel keeps its unit alive.
+        class Channel {
+        public:
+            ~Channel();
+
+            const ChannelConfig& config() const { return _config; }
+
+            void setEdgeAction(EdgeAction positive, EdgeAction negative, esp_err_t& err);
+            void setLevelAction(LevelAction high, LevelAction low, esp_err_t& err);
+
+        private:
+            Channel(PulseCounterPtr unit, const ChannelConfig& config, esp_err_t& err);
+
+            ChannelConfig _config;
+            PulseCounterPtr _unit;
+            pcnt_channel_handle_t _channel = nullptr;
+
+            static constexpr char _loggingTag[] = "esp::pcnt::Channel";
+
+            friend class PulseCounter;
+        };
+    }  // namespace pcnt
+}  // namespace esp
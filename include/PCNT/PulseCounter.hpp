@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Interrupt.hpp"
+#include "PCNT/Channel.hpp"
+#include "PCNT/Types.hpp"
+
+#include <driver/pulse_cnt.h>
+#include <freertos/FreeRTOS.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace esp {
+    class ESP32;
+
+    namespace pcnt {
+        struct PulseCounterConfig {
+            // The hardware count wraps to 0 on reaching either limit, which the unit extends to 64 bits in software.
+            int lowLimit = -32768;
+            int highLimit = 32767;
+            InterruptPriority interruptPriority = Default;
+        };
+
+        // Called from the ISR, so it must be IRAM_ATTR and must not block.  position is the extended count at the watch point.
+        using WatchPointCallback = InterruptResult(*)(int watchPoint, int64_t position, void* userInfo);
+
+        bool _onReach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t* eventData, void* userInfo);
+
+        // A pulse counter unit, counting edges on its channels in hardware.  The 16 bit hardware count is extended to 64 bits by
+        // accumulating the limits as the unit reaches them, and position reads that without a lock, so it is safe from any task, or from an ISR that can't preempt the unit's.
+        class PulseCounter : public std::enable_shared_from_this<PulseCounter> {
+        public:
+            ~PulseCounter();
+
+            const PulseCounterConfig& config() const { return _config; }
+
+            ChannelPtr addChannel(const ChannelConfig& config, esp_err_t& err);
+
+            // Pulses narrower than maxGlitchNs are ignored, 0 turns the filter off.  Only while disabled.
+            void setGlitchFilter(uint32_t maxGlitchNs, esp_err_t& err);
+
+            // The limits are reserved for the 64 bit extension.
+            void addWatchPoint(int watchPoint, esp_err_t& err);
+            void removeWatchPoint(int watchPoint, esp_err_t& err);
+            // Only while disabled.
+            void setWatchPointCallback(WatchPointCallback callback, void* userInfo, esp_err_t& err);
+
+            void enable(esp_err_t& err);
+            void disable(esp_err_t& err);
+
+            void start(esp_err_t& err);
+            void stop(esp_err_t& err);
+
+            // Zero both the hardware count and its extension.
+            void clear(esp_err_t& err);
+
+            // The hardware count wraps before the limit interrupt extends it, so a wrap whose interrupt is still pending is added from the
+            // unit's latched limit event.  Only a read on the other core in the moment between the driver's ISR clearing the interrupt and
+            // the extension being updated can miss it, as with the driver's own accumulated count.
+            int64_t position() const;
+
+        private:
+            PulseCounter(const PulseCounterConfig& config, esp_err_t& err);
+
+            // The driver doesn't say which hardware unit it allocated, so find it by the registers a probe watch point sets.
+            void _findUnitId(esp_err_t& err);
+
+            int64_t _extension() const;
+            void _setExtension(int64_t extension);
+            // The limit the hardware has wrapped at with its interrupt not yet handled, or 0.
+            int _pendingWrap() const;
+
+            PulseCounterConfig _config;
+            pcnt_unit_handle_t _unit = nullptr;
+            uint32_t _unitId = 0;
+            bool _enabled = false;
+
+            WatchPointCallback _callback = nullptr;
+            void* _userInfo = nullptr;
+
+            // A sequence lock: the writers hold _lock and make _sequence odd while changing the extension, readers retry until they
+            // see the same even sequence either side of their read.
+            portMUX_TYPE _lock = portMUX_INITIALIZER_UNLOCKED;
+            std::atomic<uint32_t> _sequence = 0;
+            std::atomic<uint32_t> _extensionLow = 0;
+            std::atomic<uint32_t> _extensionHigh = 0;
+
+            static constexpr char _loggingTag[] = "esp::pcnt::PulseCounter";
+
+            friend class Channel;
+            friend class esp::ESP32;
+
+            friend bool _onReach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t* eventData, void* userInfo);
+        };
+    }  // namespace pcnt
+}  // namespace esp
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <driver/pulse_cnt.h>
+
+#include <cstdint>
+
+namespace esp {
+    namespace pcnt {
+        // What a channel does to the count on each edge of its edge pin.
+        enum class EdgeAction : uint8_t {
+            Hold = PCNT_CHANNEL_EDGE_ACTION_HOLD,
+            Increase = PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+            Decrease = PCNT_CHANNEL_EDGE_ACTION_DECREASE
+        };
+
+        // How the level of a channel's level pin changes its edge actions.
+        enum class LevelAction : uint8_t {
+            Keep = PCNT_CHANNEL_LEVEL_ACTION_KEEP,
+            Inverse = PCNT_CHANNEL_LEVEL_ACTION_INVERSE,
+            Hold = PCNT_CHANNEL_LEVEL_ACTION_HOLD
+        };
+    }  // namespace pcnt
+}  // namespace esp
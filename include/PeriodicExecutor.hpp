@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Timer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace esp {
+    class PeriodicClock;
+    using PeriodicClockPtr = std::shared_ptr<PeriodicClock>;
+
+    class PeriodicExecutor;
+    using PeriodicExecutorPtr = std::shared_ptr<PeriodicExecutor>;
+
+    // periods is how many periods the run stands for, more than 1 only when the Coalesce policy folds missed deadlines into it.
+    using PeriodicCallback = void(*)(PeriodicExecutor& executor, uint32_t periods, void* userInfo);
+
+    // What to do when a run starts so late that later deadlines have already passed.
+    enum class OverrunPolicy : uint8_t {
+        // Drop the passed deadlines and carry on from the next one to come.
+        Skip = 0,
+        // Run once for every passed deadline, back to back, until caught up.
+        CatchUp,
+        // Like Skip, but tell the callback how many periods the run covers.
+        Coalesce
+    };
+
+    struct PeriodicClockConfig {
+        // Executors on the clock have periods that are multiples of this, with deadlines on the same grid.
+        std::chrono::microseconds basePeriod = std::chrono::milliseconds(1);
+        std::string name = "periodic";
+    };
+
+    struct PeriodicExecutorConfig {
+        std::chrono::microseconds period{0};
+        PeriodicCallback callback = nullptr;
+        void* userInfo = nullptr;
+        OverrunPolicy overrunPolicy = OverrunPolicy::Skip;
+        // Share a clock with other executors, or nullptr for one with period as its base period.
+        PeriodicClockPtr clock = nullptr;
+    };
+
+    struct PeriodicExecutorStats {
+        uint32_t runs = 0;
+        // Deadlines that weren't started within a period of them, whether run late, skipped or coalesced.
+        uint32_t missedDeadlines = 0;
+        std::chrono::microseconds worstLateness{0};
+    };
+
+    // A single esp::Timer, armed as a one shot for the earliest deadline of the executors on it.  Executors with harmonic periods share
+    // deadlines on its grid, so they're run from one wakeup.
+    class PeriodicClock {
+    public:
+        const PeriodicClockConfig& config() const { return _config; }
+
+    private:
+        PeriodicClock(const PeriodicClockConfig& config, esp_err_t& err);
+
+        void _add(PeriodicExecutor* executor);
+        void _remove(PeriodicExecutor* executor);
+        // The first deadline on the grid at or after time.
+        std::chrono::microseconds _alignUp(std::chrono::microseconds time) const;
+        void _arm();
+
+        static void _onTimer(Timer& timer, void* userInfo);
+
+        PeriodicClockConfig _config;
+        TimerPtr _timer;
+        std::chrono::microseconds _epoch{0};
+
+        // Held while callbacks run, so removing an executor waits for its run to finish.  Recursive so callbacks can start and stop
+        // executors.
+        std::recursive_mutex _mutex;
+        std::vector<PeriodicExecutor*> _executors;
+
+        static constexpr char _loggingTag[] = "esp::PeriodicClock";
+
+        friend class ESP32;
+        friend class PeriodicExecutor;
+    };
+
+    // Runs a callback at a fixed rate against absolute deadlines, start + n * period, so a late run never pushes the ones after it.
+    // Runs happen on the esp_timer task.
+    class PeriodicExecutor {
+    public:
+        ~PeriodicExecutor();
+
+        const PeriodicExecutorConfig& config() const { return _config; }
+
+        // The first run is a period after the start, rounded up to the clock's grid.  ESP_ERR_INVALID_STATE if already running.
+        void start(esp_err_t& err);
+        void stop();
+        bool isRunning() const;
+
+        std::chrono::microseconds nextDeadline() const;
+
+        PeriodicExecutorStats stats() const;
+        void resetStats();
+
+    private:
+        PeriodicExecutor(const PeriodicExecutorConfig& config, esp_err_t& err);
+
+        void _run(std::chrono::microseconds now);
+
+        PeriodicExecutorConfig _config;
+
+        // Guarded by the clock's mutex.
+        bool _running = false;
+        std::chrono::microseconds _deadline{0};
+        PeriodicExecutorStats _stats;
+
+        static constexpr char _loggingTag[] = "esp::PeriodicExecutor";
+
+        friend class ESP32;
+        friend class PeriodicClock;
+    };
+}  // namespace esp
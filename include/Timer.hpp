@@ -1,9 +1,18 @@
 #pragma once
 
+#include "InplaceFunction.hpp"
+
 #include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <expected>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace esp {
     class ESP32;
@@ -12,6 +21,8 @@ namespace esp {
     using TimerPtr = std::shared_ptr<Timer>;
 
     using TimerCallback = void(*)(Timer& timer, void* userInfo);
+    // Holds its captures inside the Timer.  Callables over 32 bytes, or that could throw while being moved, don't compile.
+    using TimerFunction = InplaceFunction<void(Timer& timer), 32>;
 
     enum class TimerDispatchMethod : uint8_t {
         Task = ESP_TIMER_TASK,
@@ -21,15 +32,53 @@ namespace esp {
     };
 
     struct TimerConfig {
-        TimerCallback callback;
-        void* userInfo;
+        TimerCallback callback = nullptr;
+        void* userInfo = nullptr;
         TimerDispatchMethod dispatchMethod;
         std::string name;
         bool skipUnhandledEvents;
+        // Record how late each fire runs and how long the callback takes, see Timer::stats.
+        bool collectStats = false;
+    };
+
+    // Counts of microsecond values in power of two buckets.  Bucket 0 counts zero, bucket i counts [2^(i-1), 2^i), and the last
+    // bucket also counts everything larger.
+    struct TimerHistogram {
+        static constexpr size_t kBuckets = 24;
+
+        std::array<uint32_t, kBuckets> buckets = {};
+        uint32_t count = 0;
+        std::chrono::microseconds min{0};
+        std::chrono::microseconds max{0};
+        std::chrono::microseconds total{0};
+
+        void record(std::chrono::microseconds value);
+
+        std::chrono::microseconds mean() const;
+        // The upper bound of the bucket holding the given fraction of the values, so within a factor of two.
+        std::chrono::microseconds percentile(float fraction) const;
+    };
+
+    struct TimerStats {
+        // From when each fire was scheduled to when its callback started.
+        TimerHistogram lateness;
+        // How long each callback ran.
+        TimerHistogram duration;
+    };
+
+    struct TimerCoalescingStats {
+        // Starts and periodic fires of timers given slack.
+        uint32_t arms = 0;
+        // Fires of timers given slack.
+        uint32_t fires = 0;
+        // Fires dispatched on a wakeup another timer's fire had already taken, rather than needing one of their own.
+        uint32_t coalesced = 0;
     };
 
     namespace priv {
         void timerCallback(void* userData);
+
+        struct TimerStatsState;
     }
 
     class Timer {
@@ -48,9 +97,13 @@ namespace esp {
         Timer& operator=(const Timer& other) = delete;
         Timer& operator=(Timer&& other);
 
-        esp_err_t startOneshot(std::chrono::microseconds duration);
-        esp_err_t startPeriodic(std::chrono::microseconds duration);
+        // With slack the timer may fire up to slack late, sharing the alarm of any other timer started with slack that's due in that
+        // window so they're dispatched together.  Up to kSlackAlarms distinct alarms can be shared at once.  Only for Task dispatch,
+        // ESP_ERR_NOT_SUPPORTED otherwise.
+        esp_err_t startOneshot(std::chrono::microseconds duration, std::chrono::microseconds slack = std::chrono::microseconds(0));
+        esp_err_t startPeriodic(std::chrono::microseconds duration, std::chrono::microseconds slack = std::chrono::microseconds(0));
 
+        // Keeps the slack the timer was started with.
         esp_err_t restart(std::chrono::microseconds duration);
 
         esp_err_t stop();
@@ -60,16 +113,76 @@ namespace esp {
 
         bool isActive() const;
 
+        // ESP_ERR_INVALID_STATE unless created with collectStats.
+        std::expected<TimerStats, esp_err_t> stats() const;
+        void resetStats();
+
+        // The stats of every live timer collecting them, by name.
+        static std::vector<std::pair<std::string, TimerStats>> allStats();
+        // Log a line per timer from allStats, for finding which one runs late or long.
+        static void logStats();
+
+        static TimerCoalescingStats coalescingStats();
+
     private:
         Timer(const TimerConfig& config, esp_err_t& err);
 
         void _timerCallback(void* userInfo);
+        void _call(void* userInfo);
+        void _scheduled(std::chrono::microseconds duration, bool periodic);
+
+        // Timers started with slack are run as one shots, rearmed here after each periodic fire.
+        esp_err_t _startWithSlack(std::chrono::microseconds duration, std::chrono::microseconds slack, bool periodic);
+        esp_err_t _armWithSlack(int64_t deadline);
+        void _onSlackFire();
+        void _clearSlack();
+        // With _slackLock held.
+        void _linkSlack();
+        void _unlinkSlack();
+        void _takeSlack(Timer& other);
+
+        // A pending alarm time, and how many timers with slack are set for it.
+        struct SlackAlarm {
+            int64_t at;
+            uint16_t timers;
+            // How many of them have fired, so every fire after the first shared its wakeup.
+            uint16_t fired;
+        };
+        // The first pending alarm at or after at, or the end of the index.  With _slackLock held.
+        static SlackAlarm* _findSlackAlarm(int64_t at);
 
         void _teardown();
 
         TimerCallback _callback;
+        // Called instead of _callback when set.
+        TimerFunction _function;
         esp_timer_handle_t _timerHandle = nullptr;
-        std::pair<Timer*, void*> _userInfo;
+        // The esp_timer's arg, heap allocated so it stays put and can be pointed at the new timer when the timer is moved.
+        std::unique_ptr<std::pair<Timer*, void*>> _userInfo;
+        TimerDispatchMethod _dispatchMethod = TimerDispatchMethod::Task;
+        bool _skipUnhandledEvents = false;
+        // Heap allocated so it stays put in the registry when the timer is moved.
+        std::unique_ptr<priv::TimerStatsState> _stats;
+
+        // Set while the timer has slack, so timers without it never touch _slackLock.
+        std::atomic<bool> _hasSlack = false;
+        // Zero unless started with slack.  The rest is guarded by _slackLock.
+        std::chrono::microseconds _slack{0};
+        int64_t _period = 0;
+        // When the pending fire was asked for, and when its alarm is actually set.
+        int64_t _deadline = 0;
+        int64_t _alarm = 0;
+        bool _slackArmed = false;
+        // Whether _alarm is in the index, which it isn't when the index was full as the timer was armed.
+        bool _slackIndexed = false;
+
+        // The distinct alarms of the timers armed with slack, sorted by time, so finding one to share is a binary search.  Alarms
+        // that don't fit still fire, but can't be joined.
+        static constexpr size_t kSlackAlarms = 16;
+        static inline portMUX_TYPE _slackLock = portMUX_INITIALIZER_UNLOCKED;
+        static inline std::array<SlackAlarm, kSlackAlarms> _slackAlarms = {};
+        static inline size_t _slackAlarmCount = 0;
+        static inline TimerCoalescingStats _coalescingStats;
 
         static constexpr char _loggingTag[] = "esp::Timer";
 
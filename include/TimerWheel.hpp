@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Testing.hpp"
+#include "Timer.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace esp {
+    class TimerWheel;
+    using TimerWheelPtr = std::shared_ptr<TimerWheel>;
+
+    using TimerWheelCallback = void(*)(TimerWheel& wheel, void* userInfo);
+
+    struct TimerWheelConfig {
+        // Timers fire on the first tick at or after their deadline.
+        std::chrono::microseconds tick = std::chrono::milliseconds(1);
+        // The most timers that can be running at once, all allocated up front.
+        size_t capacity = 256;
+        std::string name = "timer_wheel";
+    };
+
+    // Identifies one start of a timer.  Once the timer fires or is cancelled the handle goes stale, so cancelling it again is harmless
+    // even after its node has been reused.
+    struct TimerWheelHandle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+        // The tick the timer fires on, counting from when the wheel last started from idle.
+        uint64_t expiry = 0;
+    };
+
+    // Runs many one shot timers off a single esp::Timer with a hierarchical timing wheel: 4 levels of 64 slots, each slot an intrusive
+    // list of nodes from a fixed pool, so start and cancel are constant time and never allocate.  Timers further out than the top level
+    // reaches are parked in it and reinserted as it turns.  The esp::Timer only runs while timers are pending.
+    class TimerWheel {
+    public:
+        const TimerWheelConfig& config() const { return _config; }
+
+        // ESP_ERR_NO_MEM when capacity timers are already running.
+        TimerWheelHandle start(std::chrono::microseconds duration, TimerWheelCallback callback, void* userInfo, esp_err_t& err);
+        // Returns false if the timer had already fired or been cancelled.
+        bool cancel(TimerWheelHandle handle);
+
+        bool isActive(TimerWheelHandle handle) const;
+        size_t activeTimers() const;
+
+        PRIVATE_UNLESS_TESTING
+        // Process every tick up to and including tick, firing the timers due on them.
+        void advance(uint64_t tick);
+
+    private:
+        TimerWheel(const TimerWheelConfig& config, esp_err_t& err);
+
+        static constexpr size_t kLevels = 4;
+        static constexpr size_t kSlotBits = 6;
+        static constexpr size_t kSlots = 1 << kSlotBits;
+        static constexpr uint64_t kMaxDelta = (uint64_t(1) << (kLevels * kSlotBits)) - 1;
+        static constexpr uint32_t kNil = UINT32_MAX;
+
+        struct Node {
+            uint32_t previous = kNil;
+            uint32_t next = kNil;
+            uint32_t generation = 0;
+            // The list the node is on, as level * kSlots + slot, or kNil while free.
+            uint32_t list = kNil;
+            uint64_t expiry = 0;
+            TimerWheelCallback callback = nullptr;
+            void* userInfo = nullptr;
+        };
+
+        uint64_t _currentTick() const;
+        void _insert(uint32_t index);
+        void _unlink(uint32_t index);
+        void _free(uint32_t index);
+        void _cascade(size_t level);
+
+        static void _onTick(Timer& timer, void* userInfo);
+
+        TimerWheelConfig _config;
+        TimerPtr _timer;
+
+        mutable std::mutex _mutex;
+        std::vector<Node> _nodes;
+        std::array<uint32_t, kLevels * kSlots> _lists;
+        uint32_t _freeList = kNil;
+        size_t _active = 0;
+
+        // Ticks are counted from _epoch, and _now is the last one processed.
+        std::chrono::microseconds _epoch{0};
+        uint64_t _now = 0;
+        bool _running = false;
+
+        static constexpr char _loggingTag[] = "esp::TimerWheel";
+
+        friend class ESP32;
+    };
+}  // namespace esp
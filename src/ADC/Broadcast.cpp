@@ -0,0 +1,263 @@
+#include "ADC/Broadcast.hpp"
+
+#include <esp_log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace esp;
+using namespace esp::adc;
+
+ADCBroadcast::ADCBroadcast(ADCContinuousPtr adc, const ADCBroadcastConfig& config, esp_err_t& err)
+    : _adc(adc), _config(config), _frameSize(adc->config().numberOfValuesPerConversionFrame * SOC_ADC_DIGI_DATA_BYTES_PER_CONV) {
+    if (config.frameCount < 2 || _frameSize == 0) {
+        ESP_LOGE(_loggingTag, "Invalid broadcast configuration");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _ring = static_cast<uint8_t*>(heap_caps_malloc(_frameSize * config.frameCount, config.memoryCapabilities));
+    if (_ring == nullptr) {
+        ESP_LOGE(_loggingTag, "Failed to allocate %zu byte frame ring", _frameSize * config.frameCount);
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+
+    _slots = std::make_unique<Slot[]>(config.frameCount);
+}
+
+ADCBroadcast::~ADCBroadcast() {
+    if (_running) {
+        esp_err_t err = ESP_OK;
+        stop(err);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "esp::adc::ADCBroadcast::stop failed: %s", esp_err_to_name(err));
+        }
+    }
+
+    if (_ring != nullptr) {
+        heap_caps_free(_ring);
+    }
+}
+
+ADCBroadcastConsumerPtr ADCBroadcast::addConsumer(const ADCBroadcastConsumerConfig& config, esp_err_t& err) {
+    err = ESP_OK;
+    std::lock_guard lock(_mutex);
+
+    // Can't use std::make_shared because we only have access through friendship
+    ADCBroadcastConsumerPtr consumer = std::shared_ptr<ADCBroadcastConsumer>(new ADCBroadcastConsumer(shared_from_this(), config, _framesPublished));
+    _consumers.push_back(consumer.get());
+    return consumer;
+}
+
+void ADCBroadcast::start(esp_err_t& err) {
+    if (_running) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    _running = true;
+    BaseType_t result = xTaskCreatePinnedToCore(_drainTask, _config.taskInfo.name.c_str(), _config.taskInfo.stackSize, this, _config.taskInfo.priority,
+                                                &_task, _config.taskInfo.coreId);
+    if (result != pdPASS) {
+        ESP_LOGE(_loggingTag, "xTaskCreatePinnedToCore failed");
+        _running = false;
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+
+    err = ESP_OK;
+}
+
+void ADCBroadcast::stop(esp_err_t& err) {
+    if (!_running) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    _stoppingTask = xTaskGetCurrentTaskHandle();
+    _running = false;
+    _released.notify_all();
+
+    // The drain task notices within one read timeout and notifies us on its way out.
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    _task = nullptr;
+    _stoppingTask = nullptr;
+    err = ESP_OK;
+}
+
+uint64_t ADCBroadcast::framesPublished() const {
+    std::lock_guard lock(_mutex);
+    return _framesPublished;
+}
+
+void ADCBroadcast::publish(std::span<const uint8_t> frame, esp_err_t& err) {
+    if (frame.size() > _frameSize) {
+        err = ESP_ERR_INVALID_SIZE;
+        return;
+    }
+
+    uint8_t* slot = _claim(err);
+    if (err != ESP_OK) {
+        return;
+    }
+    std::memcpy(slot, frame.data(), frame.size());
+    _commit(frame.size());
+}
+
+uint8_t* ADCBroadcast::_claim(esp_err_t& err) {
+    std::unique_lock lock(_mutex);
+    const uint64_t frame = _framesPublished;
+
+    // Claiming the slot overwrites the frame published frameCount frames ago.
+    while (frame >= _config.frameCount) {
+        const uint64_t overwritten = frame - _config.frameCount;
+        bool blocked = false;
+        for (ADCBroadcastConsumer* consumer : _consumers) {
+            if (consumer->_config.policy == ADCSlowConsumerPolicy::Lag || consumer->_cursor > overwritten) {
+                continue;
+            }
+
+            // A Drop consumer can't lose the frame it's holding, so it holds up the producer until it releases it.
+            if (consumer->_config.policy == ADCSlowConsumerPolicy::Block || consumer->_holding) {
+                blocked = true;
+                continue;
+            }
+
+            consumer->_framesDropped += overwritten + 1 - consumer->_cursor;
+            consumer->_cursor = overwritten + 1;
+        }
+
+        if (!blocked) {
+            break;
+        }
+        if (_released.wait_for(lock, std::chrono::milliseconds(_config.readTimeoutMs)) == std::cv_status::timeout) {
+            err = ESP_ERR_TIMEOUT;
+            return nullptr;
+        }
+    }
+
+    Slot& slot = _slots[frame % _config.frameCount];
+    slot.sequence++;
+    slot.size = 0;
+
+    err = ESP_OK;
+    return _ring + (frame % _config.frameCount) * _frameSize;
+}
+
+void ADCBroadcast::_commit(size_t size) {
+    {
+        std::lock_guard lock(_mutex);
+        _slots[_framesPublished % _config.frameCount].size = size;
+        _framesPublished++;
+    }
+    _published.notify_all();
+}
+
+void ADCBroadcast::_removeConsumer(ADCBroadcastConsumer* consumer) {
+    {
+        std::lock_guard lock(_mutex);
+        std::erase(_consumers, consumer);
+    }
+    _released.notify_all();
+}
+
+void ADCBroadcast::_drainTask(void* userInfo) {
+    ADCBroadcast* broadcast = static_cast<ADCBroadcast*>(userInfo);
+    broadcast->_drain();
+
+    TaskHandle_t stoppingTask = broadcast->_stoppingTask;
+    if (stoppingTask != nullptr) {
+        xTaskNotifyGive(stoppingTask);
+    }
+    vTaskDelete(nullptr);
+}
+
+void ADCBroadcast::_drain() {
+    while (_running) {
+        esp_err_t err = ESP_OK;
+        uint8_t* slot = _claim(err);
+        if (err == ESP_ERR_TIMEOUT) {
+            continue;
+        }
+
+        // Read straight into the ring so every consumer shares the one copy.
+        size_t filled = 0;
+        while (_running && filled < _frameSize) {
+            const size_t bytesRead = _adc->read(slot + filled, _frameSize - filled, _config.readTimeoutMs, err);
+            if (err == ESP_ERR_TIMEOUT) {
+                continue;
+            }
+            if (err != ESP_OK) {
+                ESP_LOGE(_loggingTag, "esp::adc::ADCContinuous::read failed: %s", esp_err_to_name(err));
+                vTaskDelay(pdMS_TO_TICKS(_config.readTimeoutMs));
+                continue;
+            }
+            filled += bytesRead;
+        }
+
+        if (filled == _frameSize) {
+            _commit(filled);
+        }
+    }
+}
+
+ADCBroadcastConsumer::ADCBroadcastConsumer(ADCBroadcastPtr broadcast, const ADCBroadcastConsumerConfig& config, uint64_t cursor)
+    : _broadcast(broadcast), _config(config), _cursor(cursor) {}
+
+ADCBroadcastConsumer::~ADCBroadcastConsumer() {
+    _broadcast->_removeConsumer(this);
+}
+
+std::span<const uint8_t> ADCBroadcastConsumer::acquire(uint32_t timeoutMs, esp_err_t& err) {
+    ADCBroadcast& broadcast = *_broadcast;
+    std::unique_lock lock(broadcast._mutex);
+    if (_holding) {
+        err = ESP_ERR_INVALID_STATE;
+        return {};
+    }
+
+    if (!broadcast._published.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] { return _cursor < broadcast._framesPublished; })) {
+        err = ESP_ERR_TIMEOUT;
+        return {};
+    }
+
+    // The oldest published frame's slot may already be claimed for the next one, so a Lag consumer that far behind has been lapped.
+    const uint64_t published = broadcast._framesPublished;
+    if (_config.policy == ADCSlowConsumerPolicy::Lag && published >= broadcast._config.frameCount && _cursor <= published - broadcast._config.frameCount) {
+        _framesDropped += published - 1 - _cursor;
+        _cursor = published - 1;
+    }
+
+    const size_t index = _cursor % broadcast._config.frameCount;
+    _holding = true;
+    _heldSequence = broadcast._slots[index].sequence;
+
+    err = ESP_OK;
+    return std::span<const uint8_t>(broadcast._ring + index * broadcast._frameSize, broadcast._slots[index].size);
+}
+
+void ADCBroadcastConsumer::release(esp_err_t& err) {
+    ADCBroadcast& broadcast = *_broadcast;
+    {
+        std::lock_guard lock(broadcast._mutex);
+        if (!_holding) {
+            err = ESP_ERR_INVALID_STATE;
+            return;
+        }
+
+        err = ESP_OK;
+        if (broadcast._slots[_cursor % broadcast._config.frameCount].sequence != _heldSequence) {
+            err = ESP_ERR_INVALID_STATE;
+        }
+        _holding = false;
+        _cursor++;
+    }
+    broadcast._released.notify_all();
+}
+
+uint64_t ADCBroadcastConsumer::framesDropped() const {
+    std::lock_guard lock(_broadcast->_mutex);
+    return _framesDropped;
+}
@@ -0,0 +1,425 @@
+#include "ADC/Codec.hpp"
+
+#include <esp_log.h>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+using namespace esp;
+using namespace esp::adc;
+
+namespace {
+    // Residuals whose Rice quotient would be at least this long are escaped and written as raw kEscapeBits bits instead.
+    constexpr uint32_t kEscapeQuotient = 24;
+    constexpr uint32_t kEscapeBits = 20;
+    constexpr uint32_t kMaximumRiceParameter = 19;
+    // Set in the mode byte when the block's indices or times don't follow from its first sample, and a timing section follows the values.
+    constexpr uint8_t kIrregularFlag = 0x80;
+    constexpr uint32_t kTimingWidthBits = 6;
+    constexpr uint32_t kMaximumTimingWidth = 32;
+
+    class BitWriter {
+    public:
+        BitWriter(uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+        void write(uint32_t value, uint32_t bits) {
+            _accumulator = (_accumulator << bits) | (value & ((1ull << bits) - 1));
+            _bits += bits;
+            while (_bits >= 8) {
+                _bits -= 8;
+                _put(static_cast<uint8_t>(_accumulator >> _bits));
+            }
+        }
+
+        void writeOnes(uint32_t count) {
+            while (count >= 16) {
+                write(0xFFFF, 16);
+                count -= 16;
+            }
+            write((1u << count) - 1, count);
+        }
+
+        size_t finish() {
+            if (_bits > 0) {
+                _put(static_cast<uint8_t>(_accumulator << (8 - _bits)));
+                _bits = 0;
+            }
+            return _position;
+        }
+
+        bool overflowed() const { return _overflowed; }
+
+    private:
+        void _put(uint8_t byte) {
+            if (_position >= _size) {
+                _overflowed = true;
+                return;
+            }
+            _data[_position++] = byte;
+        }
+
+        uint8_t* _data;
+        size_t _size;
+        size_t _position = 0;
+        uint64_t _accumulator = 0;
+        uint32_t _bits = 0;
+        bool _overflowed = false;
+    };
+
+    class BitReader {
+    public:
+        BitReader(const uint8_t* data, size_t size) : _data(data), _size(size) {}
+
+        uint32_t read(uint32_t bits) {
+            while (_bits < bits) {
+                _accumulator = (_accumulator << 8) | (_position < _size ? _data[_position] : 0);
+                if (_position >= _size) {
+                    _overran = true;
+                }
+                _position++;
+                _bits += 8;
+            }
+            _bits -= bits;
+            return static_cast<uint32_t>((_accumulator >> _bits) & ((1ull << bits) - 1));
+        }
+
+        uint32_t readOnes(uint32_t limit) {
+            uint32_t count = 0;
+            while (count < limit && read(1) == 1) {
+                count++;
+            }
+            return count;
+        }
+
+        bool overran() const { return _overran; }
+
+    private:
+        const uint8_t* _data;
+        size_t _size;
+        size_t _position = 0;
+        uint64_t _accumulator = 0;
+        uint32_t _bits = 0;
+        bool _overran = false;
+    };
+
+    uint32_t zigzag(int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int32_t unzigzag(uint32_t value) {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+
+    uint64_t zigzag64(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag64(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // Timing residuals against the block's first sample: the index gap since the previous sample, and the time against the step per index.
+    uint64_t indexResidual(std::span<const ADCSample> samples, size_t i) {
+        return zigzag64(static_cast<int64_t>(samples[i].index - samples[i - 1].index - 1));
+    }
+
+    uint64_t timeResidual(std::span<const ADCSample> samples, size_t i, uint64_t timeStep) {
+        const ADCSample& first = samples.front();
+        return zigzag64(static_cast<int64_t>(samples[i].timeNanoseconds - first.timeNanoseconds - (samples[i].index - first.index) * timeStep));
+    }
+
+    int32_t residual(std::span<const ADCSample> samples, size_t i, uint32_t order) {
+        const int32_t x = static_cast<int32_t>(samples[i].value);
+        switch (order) {
+            case 1:
+                return x - static_cast<int32_t>(samples[i - 1].value);
+            case 2:
+                return x - 2 * static_cast<int32_t>(samples[i - 1].value) + static_cast<int32_t>(samples[i - 2].value);
+            default:
+                return x;
+        }
+    }
+
+    uint64_t riceBits(std::span<const ADCSample> samples, uint32_t order, uint32_t parameter) {
+        uint64_t bits = 0;
+        for (size_t i = order; i < samples.size(); i++) {
+            const uint32_t quotient = zigzag(residual(samples, i, order)) >> parameter;
+            bits += quotient < kEscapeQuotient ? quotient + 1 + parameter : kEscapeQuotient + kEscapeBits;
+        }
+        return bits;
+    }
+
+    void putLittleEndian(uint8_t* data, uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; i++) {
+            data[i] = static_cast<uint8_t>(value >> (8 * i));
+        }
+    }
+
+    uint64_t getLittleEndian(const uint8_t* data, size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= static_cast<uint64_t>(data[i]) << (8 * i);
+        }
+        return value;
+    }
+}  // namespace
+
+size_t ADCCodec::encodeBlock(std::span<const ADCSample> samples, std::span<uint8_t> output, esp_err_t& err) {
+    err = ESP_OK;
+    if (samples.empty() || samples.size() > kMaximumSamplesPerBlock) {
+        err = ESP_ERR_INVALID_ARG;
+        return 0;
+    }
+    if (output.size() < maximumBlockSize(samples.size())) {
+        err = ESP_ERR_INVALID_SIZE;
+        return 0;
+    }
+
+    // One pass to find the widest sample and the cheapest predictor by total absolute residual.
+    uint32_t maximumValue = 0;
+    uint64_t residualSums[3] = {0, 0, 0};
+    for (size_t i = 0; i < samples.size(); i++) {
+        if (samples[i].value > UINT16_MAX) {
+            ESP_LOGE(_loggingTag, "Sample %zu doesn't fit in 16 bits", i);
+            err = ESP_ERR_INVALID_ARG;
+            return 0;
+        }
+        maximumValue = std::max(maximumValue, samples[i].value);
+        for (uint32_t order = 0; order < 3; order++) {
+            if (i >= order) {
+                residualSums[order] += zigzag(residual(samples, i, order));
+            }
+        }
+    }
+
+    uint32_t order = 0;
+    for (uint32_t candidate = 1; candidate < 3 && candidate < samples.size(); candidate++) {
+        if (residualSums[candidate] < residualSums[order]) {
+            order = candidate;
+        }
+    }
+
+    // Estimate the Rice parameter from the mean residual, then settle on the cheapest of its neighbours.
+    const uint64_t residualCount = samples.size() - order;
+    uint32_t estimate = 0;
+    while (estimate < kMaximumRiceParameter && (residualCount << (estimate + 1)) <= residualSums[order]) {
+        estimate++;
+    }
+    uint32_t parameter = estimate;
+    uint64_t codedBits = std::numeric_limits<uint64_t>::max();
+    for (uint32_t candidate = estimate > 0 ? estimate - 1 : 0; candidate <= std::min(estimate + 1, kMaximumRiceParameter); candidate++) {
+        const uint64_t bits = riceBits(samples, order, candidate);
+        if (bits < codedBits) {
+            codedBits = bits;
+            parameter = candidate;
+        }
+    }
+    codedBits += 16 * order;
+
+    const uint32_t width = std::max<uint32_t>(1, std::bit_width(maximumValue));
+    const uint64_t verbatimBits = static_cast<uint64_t>(width) * samples.size();
+    const Mode mode = verbatimBits <= codedBits ? Mode::Verbatim : static_cast<Mode>(static_cast<uint8_t>(Mode::Order0) + order);
+
+    // Dropped conversions leave gaps in the indices and rounding jitters the times, so any departure from a uniform step is kept as residuals.
+    const ADCSample& first = samples.front();
+    const ADCSample& last = samples.back();
+    uint64_t timeStep = 0;
+    if (last.index > first.index && last.timeNanoseconds > first.timeNanoseconds) {
+        timeStep = std::min<uint64_t>((last.timeNanoseconds - first.timeNanoseconds) / (last.index - first.index), UINT32_MAX);
+    }
+    uint64_t indexResiduals = 0;
+    uint64_t timeResiduals = 0;
+    for (size_t i = 1; i < samples.size(); i++) {
+        indexResiduals |= indexResidual(samples, i);
+        timeResiduals |= timeResidual(samples, i, timeStep);
+    }
+    const uint32_t indexWidth = std::bit_width(indexResiduals);
+    const uint32_t timeWidth = std::bit_width(timeResiduals);
+    if (indexWidth > kMaximumTimingWidth || timeWidth > kMaximumTimingWidth) {
+        ESP_LOGE(_loggingTag, "Sample indices or times are too far from a uniform step");
+        err = ESP_ERR_INVALID_ARG;
+        return 0;
+    }
+    const bool irregular = indexWidth > 0 || timeWidth > 0;
+
+    uint8_t* header = output.data();
+    putLittleEndian(header + 2, samples.size(), 2);
+    putLittleEndian(header + 4, first.index, 8);
+    putLittleEndian(header + 12, first.timeNanoseconds, 8);
+    putLittleEndian(header + 20, timeStep, 4);
+    header[24] = static_cast<uint8_t>(mode) | static_cast<uint8_t>((mode == Mode::Verbatim ? width : parameter) << 2) | (irregular ? kIrregularFlag : 0);
+
+    BitWriter writer(output.data() + kHeaderSize, output.size() - kHeaderSize);
+    if (mode == Mode::Verbatim) {
+        for (const ADCSample& sample : samples) {
+            writer.write(sample.value, width);
+        }
+    } else {
+        for (size_t i = 0; i < order; i++) {
+            writer.write(samples[i].value, 16);
+        }
+        for (size_t i = order; i < samples.size(); i++) {
+            const uint32_t value = zigzag(residual(samples, i, order));
+            const uint32_t quotient = value >> parameter;
+            if (quotient < kEscapeQuotient) {
+                writer.writeOnes(quotient);
+                writer.write(0, 1);
+                writer.write(value, parameter);
+            } else {
+                writer.writeOnes(kEscapeQuotient);
+                writer.write(value, kEscapeBits);
+            }
+        }
+    }
+
+    if (irregular) {
+        writer.write(indexWidth, kTimingWidthBits);
+        writer.write(timeWidth, kTimingWidthBits);
+        for (size_t i = 1; i < samples.size(); i++) {
+            writer.write(static_cast<uint32_t>(indexResidual(samples, i)), indexWidth);
+            writer.write(static_cast<uint32_t>(timeResidual(samples, i, timeStep)), timeWidth);
+        }
+    }
+
+    const size_t size = kHeaderSize + writer.finish();
+    if (writer.overflowed()) {
+        err = ESP_ERR_INVALID_SIZE;
+        return 0;
+    }
+    putLittleEndian(header, size, 2);
+
+    return size;
+}
+
+size_t ADCCodec::blockSamples(std::span<const uint8_t> input, esp_err_t& err) {
+    if (input.size() < kHeaderSize) {
+        err = ESP_ERR_INVALID_SIZE;
+        return 0;
+    }
+
+    err = ESP_OK;
+    return getLittleEndian(input.data() + 2, 2);
+}
+
+size_t ADCCodec::decodeBlock(std::span<const uint8_t> input, std::span<ADCSample> samples, size_t& samplesDecoded, esp_err_t& err) {
+    samplesDecoded = 0;
+    err = ESP_OK;
+    if (input.size() < kHeaderSize) {
+        err = ESP_ERR_INVALID_SIZE;
+        return 0;
+    }
+
+    const size_t size = getLittleEndian(input.data(), 2);
+    const size_t count = getLittleEndian(input.data() + 2, 2);
+    if (size < kHeaderSize || size > input.size()) {
+        err = ESP_ERR_INVALID_SIZE;
+        return 0;
+    }
+    if (count > samples.size()) {
+        err = ESP_ERR_INVALID_SIZE;
+        return 0;
+    }
+
+    const uint64_t firstIndex = getLittleEndian(input.data() + 4, 8);
+    const uint64_t firstTime = getLittleEndian(input.data() + 12, 8);
+    const uint64_t timeStep = getLittleEndian(input.data() + 20, 4);
+    const Mode mode = static_cast<Mode>(input[24] & 0x3);
+    const uint32_t parameter = (input[24] & ~kIrregularFlag) >> 2;
+    const bool irregular = (input[24] & kIrregularFlag) != 0;
+
+    BitReader reader(input.data() + kHeaderSize, size - kHeaderSize);
+
+    if (mode == Mode::Verbatim) {
+        for (size_t i = 0; i < count; i++) {
+            samples[i].value = reader.read(parameter);
+        }
+    } else {
+        const uint32_t order = static_cast<uint32_t>(mode) - static_cast<uint32_t>(Mode::Order0);
+        for (size_t i = 0; i < order && i < count; i++) {
+            samples[i].value = reader.read(16);
+        }
+        for (size_t i = order; i < count; i++) {
+            const uint32_t quotient = reader.readOnes(kEscapeQuotient);
+            uint32_t value = 0;
+            if (quotient < kEscapeQuotient) {
+                value = (quotient << parameter) | reader.read(parameter);
+            } else {
+                value = reader.read(kEscapeBits);
+            }
+
+            const int32_t prediction = order == 1 ? static_cast<int32_t>(samples[i - 1].value)
+                                                  : 2 * static_cast<int32_t>(samples[i - 1].value) - static_cast<int32_t>(samples[i - 2].value);
+            samples[i].value = static_cast<uint32_t>((order == 0 ? 0 : prediction) + unzigzag(value));
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        samples[i].index = firstIndex + i;
+        samples[i].timeNanoseconds = firstTime + i * timeStep;
+    }
+    if (irregular && count > 0) {
+        const uint32_t indexWidth = reader.read(kTimingWidthBits);
+        const uint32_t timeWidth = reader.read(kTimingWidthBits);
+        if (indexWidth > kMaximumTimingWidth || timeWidth > kMaximumTimingWidth) {
+            err = ESP_ERR_INVALID_ARG;
+            return 0;
+        }
+        for (size_t i = 1; i < count; i++) {
+            samples[i].index = samples[i - 1].index + 1 + unzigzag64(reader.read(indexWidth));
+            samples[i].timeNanoseconds = firstTime + (samples[i].index - firstIndex) * timeStep + unzigzag64(reader.read(timeWidth));
+        }
+    }
+
+    if (reader.overran()) {
+        err = ESP_ERR_INVALID_SIZE;
+        return 0;
+    }
+
+    samplesDecoded = count;
+    return size;
+}
+
+ADCEncoder::ADCEncoder(const ADCEncoderConfig& config, void* userInfo, esp_err_t& err) : _config(config), _userInfo(userInfo) {
+    if (config.samplesPerBlock == 0 || config.samplesPerBlock > ADCCodec::kMaximumSamplesPerBlock) {
+        ESP_LOGE(_loggingTag, "Invalid block size: %zu", config.samplesPerBlock);
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _pending.reserve(config.samplesPerBlock);
+    _block.resize(ADCCodec::maximumBlockSize(config.samplesPerBlock));
+}
+
+void ADCEncoder::process(std::span<const ADCSample> samples, esp_err_t& err) {
+    err = ESP_OK;
+    for (const ADCSample& sample : samples) {
+        _pending.push_back(sample);
+        if (_pending.size() == _config.samplesPerBlock) {
+            flush(err);
+            if (err != ESP_OK) {
+                return;
+            }
+        }
+    }
+}
+
+void ADCEncoder::flush(esp_err_t& err) {
+    err = ESP_OK;
+    if (_pending.empty()) {
+        return;
+    }
+
+    const size_t size = ADCCodec::encodeBlock(_pending, _block, err);
+    _pending.clear();
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp::adc::ADCCodec::encodeBlock failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _samplesEncoded += ADCCodec::blockSamples(_block, err);
+    _bytesEncoded += size;
+    if (_config.onBlock) {
+        _config.onBlock(std::span<const uint8_t>(_block.data(), size), _userInfo);
+    }
+}
@@ -1,4 +1,6 @@
+#include <ADC/Broadcast.hpp>
 #include <ADC/Continuous.hpp>
+#include <ADC/History.hpp>
 
 #include <esp_log.h>
 
@@ -9,12 +11,9 @@ namespace esp {
     namespace adc {
         bool _onConversionComplete(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* data, void* userData) {
             auto& [adc, userInfo] = *reinterpret_cast<std::pair<ADCContinuous*, void*>*>(userData);
-            ADCContinuousPtr ownedAdc = adc->shared_from_this();
-
-            if (ownedAdc == nullptr) {
-                return false;
-            }
-
+            adc->_framesConverted.fetch_add(1, std::memory_order_release);
+            // No reference is taken: the destructor deinits the driver, which stops these callbacks before the unit goes away, and
+            // an owning reference dropped here could run that destructor in the ISR.
             if (!adc->_callbacks.onConversionComplete) {
                 return false;
             }
@@ -24,12 +23,7 @@ namespace esp {
 
         bool _onPoolOverflow(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* data, void* userData) {
             auto& [adc, userInfo] = *reinterpret_cast<std::pair<ADCContinuous*, void*>*>(userData);
-            ADCContinuousPtr ownedAdc = adc->shared_from_this();
-
-            if (ownedAdc == nullptr) {
-                return false;
-            }
-
+            adc->_poolOverflows.fetch_add(1, std::memory_order_release);
             if (!adc->_callbacks.onPoolOverflow) {
                 return false;
             }
@@ -57,9 +51,10 @@ ADCContinuous::~ADCContinuous() {
 }
 
 esp_err_t ADCContinuous::setEventCallbacks(const ADCContinuousEventCallbacks& callbacks, void* userInfo) {
+    // Both are always registered, to keep the frame and overflow counts.
     adc_continuous_evt_cbs_t callbackConfig = {
-        .on_conv_done = callbacks.onConversionComplete ? _onConversionComplete : nullptr,
-        .on_pool_ovf = callbacks.onPoolOverflow ? _onPoolOverflow : nullptr,
+        .on_conv_done = _onConversionComplete,
+        .on_pool_ovf = _onPoolOverflow,
     };
     _callbacks = callbacks;
     _userInfo = std::make_pair(this, userInfo);
@@ -104,7 +99,65 @@ esp_err_t ADCContinuous::flush() {
     return err;
 }
 
-ADCContinuous::ADCContinuous(const ADCContinuousConfig& config, esp_err_t& err) {
+ADCBroadcastPtr ADCContinuous::addBroadcast(const ADCBroadcastConfig& config, esp_err_t& err) {
+    // Can't use std::make_shared because we only have access through friendship
+    ADCBroadcastPtr broadcast = std::shared_ptr<ADCBroadcast>(new ADCBroadcast(shared_from_this(), config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp::adc::ADCBroadcast::ADCBroadcast failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return broadcast;
+}
+
+ADCHistoryPtr ADCContinuous::addHistory(const ADCHistoryConfig& config, esp_err_t& err) {
+    // Can't use std::make_shared because we only have access through friendship
+    ADCHistoryPtr history = std::shared_ptr<ADCHistory>(new ADCHistory(shared_from_this(), config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp::adc::ADCHistory::ADCHistory failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return history;
+}
+
+#if SOC_ADC_DIG_IIR_FILTER_SUPPORTED
+ADCIIRFilterPtr ADCContinuous::addIIRFilter(const ADCIIRFilterConfig& config, esp_err_t& err) {
+    if (_started) {
+        err = ESP_ERR_INVALID_STATE;
+        return nullptr;
+    }
+
+    // Can't use std::make_shared because we only have access through friendship
+    ADCIIRFilterPtr filter = std::shared_ptr<ADCIIRFilter>(new ADCIIRFilter(shared_from_this(), config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp::adc::ADCIIRFilter::ADCIIRFilter failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return filter;
+}
+#endif
+
+#if SOC_ADC_MONITOR_SUPPORTED
+ADCMonitorPtr ADCContinuous::addMonitor(const ADCMonitorConfig& config, esp_err_t& err) {
+    if (_started) {
+        err = ESP_ERR_INVALID_STATE;
+        return nullptr;
+    }
+
+    // Can't use std::make_shared because we only have access through friendship
+    ADCMonitorPtr monitor = std::shared_ptr<ADCMonitor>(new ADCMonitor(shared_from_this(), config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp::adc::ADCMonitor::ADCMonitor failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return monitor;
+}
+#endif
+
+ADCContinuous::ADCContinuous(const ADCContinuousConfig& config, esp_err_t& err) : _config(config) {
     const adc_continuous_handle_cfg_t continuousConfig = {.max_store_buf_size = config.maximumStoredValues * SOC_ADC_DIGI_DATA_BYTES_PER_CONV,
                                                           .conv_frame_size = config.numberOfValuesPerConversionFrame * SOC_ADC_DIGI_DATA_BYTES_PER_CONV,
                                                           .flags{
@@ -140,4 +193,10 @@ ADCContinuous::ADCContinuous(const ADCContinuousConfig& config, esp_err_t& err)
         adc_continuous_deinit(_handle);
         return;
     }
+
+    err = setEventCallbacks({}, nullptr);
+    if (err != ESP_OK) {
+        adc_continuous_deinit(_handle);
+        return;
+    }
 }
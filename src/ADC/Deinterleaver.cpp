@@ -0,0 +1,205 @@
+#include "ADC/Deinterleaver.hpp"
+
+#include <esp_log.h>
+
+#include <cstring>
+
+using namespace esp;
+using namespace esp::adc;
+
+ADCDeinterleaver::ADCDeinterleaver(const ADCContinuousConfig& adcConfig, const ADCDeinterleaverConfig& config, esp_err_t& err)
+    : _conversionMode(adcConfig.conversionMode), _samplingFrequencyHz(adcConfig.samplingFrequencyHz), _config(config) {
+    if (_samplingFrequencyHz == 0) {
+        ESP_LOGE(_loggingTag, "Sampling frequency must be non-zero");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    const bool dualUnit = _conversionMode == ConversionMode::BothUnit || _conversionMode == ConversionMode::AlterUnit;
+
+    for (std::array<int8_t, SOC_ADC_MAX_CHANNEL_NUM>& unitStreams : _streamForChannel) {
+        unitStreams.fill(kNoStream);
+    }
+
+    size_t unit1Channels = 0;
+    for (const ADCContinuousChannelConfig& channelConfig : adcConfig.channels) {
+        const size_t unitNum = static_cast<size_t>(channelConfig.unit);
+        const size_t channelNum = static_cast<size_t>(channelConfig.channel);
+        if (unitNum >= SOC_ADC_PERIPH_NUM || channelNum >= SOC_ADC_MAX_CHANNEL_NUM) {
+            ESP_LOGE(_loggingTag, "Invalid ADC channel: unit %zu channel %zu", unitNum, channelNum);
+            err = ESP_ERR_INVALID_ARG;
+            return;
+        }
+
+        if (channelConfig.unit == ADC_UNIT_1) {
+            unit1Channels++;
+        }
+
+        // A channel may appear in the pattern more than once; all of its conversions go to the same stream.
+        if (_streamForChannel[unitNum][channelNum] != kNoStream) {
+            continue;
+        }
+
+        _streamForChannel[unitNum][channelNum] = static_cast<int8_t>(_streams.size());
+        Stream& stream = _streams.emplace_back();
+        stream.unit = channelConfig.unit;
+        stream.channel = channelConfig.channel;
+        stream.samples.reserve(config.maximumSamplesPerChannel);
+    }
+
+    if (dualUnit) {
+        _slotsPerCycle = unit1Channels;
+    } else {
+        _slotsPerCycle = adcConfig.channels.size();
+    }
+
+    if (config.interpolateUnit2 && (!dualUnit || unit1Channels == 0)) {
+        ESP_LOGE(_loggingTag, "Interpolating ADC2 needs a dual unit conversion mode with at least one ADC1 channel");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+}
+
+void ADCDeinterleaver::process(std::span<const uint8_t> frame, esp_err_t& err) {
+    err = ESP_OK;
+    _beginFrame();
+
+    const size_t count = frame.size() / SOC_ADC_DIGI_RESULT_BYTES;
+    for (size_t i = 0; i < count; i++) {
+        adc_digi_output_data_t result;
+        std::memcpy(&result, frame.data() + i * SOC_ADC_DIGI_RESULT_BYTES, sizeof(result));
+        const adc_unit_t unit = static_cast<adc_unit_t>(result.type2.unit);
+        const adc_channel_t channel = static_cast<adc_channel_t>(result.type2.channel);
+        const bool valid = result.type2.channel < SOC_ADC_CHANNEL_NUM(unit);
+        _push(unit, channel, result.type2.data, valid, err);
+    }
+}
+
+void ADCDeinterleaver::process(std::span<const adc_continuous_data_t> parsedData, esp_err_t& err) {
+    err = ESP_OK;
+    _beginFrame();
+
+    for (const adc_continuous_data_t& result : parsedData) {
+        _push(result.unit, result.channel, result.raw_data, result.valid, err);
+    }
+}
+
+std::span<const ADCSample> ADCDeinterleaver::samples(adc_unit_t unit, adc_channel_t channel) const {
+    const size_t unitNum = static_cast<size_t>(unit);
+    const size_t channelNum = static_cast<size_t>(channel);
+    if (unitNum >= SOC_ADC_PERIPH_NUM || channelNum >= SOC_ADC_MAX_CHANNEL_NUM || _streamForChannel[unitNum][channelNum] == kNoStream) {
+        return {};
+    }
+
+    return _streams[_streamForChannel[unitNum][channelNum]].samples;
+}
+
+std::span<ADCSample> ADCDeinterleaver::samples(adc_unit_t unit, adc_channel_t channel) {
+    const size_t unitNum = static_cast<size_t>(unit);
+    const size_t channelNum = static_cast<size_t>(channel);
+    if (unitNum >= SOC_ADC_PERIPH_NUM || channelNum >= SOC_ADC_MAX_CHANNEL_NUM || _streamForChannel[unitNum][channelNum] == kNoStream) {
+        return {};
+    }
+
+    return _streams[_streamForChannel[unitNum][channelNum]].samples;
+}
+
+void ADCDeinterleaver::reset() {
+    for (Stream& stream : _streams) {
+        stream.samples.clear();
+        stream.nextIndex = 0;
+        stream.hasPrevious = false;
+        stream.nextGridIndex = 0;
+    }
+
+    _nextSlot = 0;
+    _unit1Time = 0;
+    _droppedSamples = 0;
+    _unknownSamples = 0;
+}
+
+void ADCDeinterleaver::_beginFrame() {
+    for (Stream& stream : _streams) {
+        stream.samples.clear();
+    }
+}
+
+void ADCDeinterleaver::_push(adc_unit_t unit, adc_channel_t channel, uint32_t value, bool valid, esp_err_t& err) {
+    const bool dualUnit = _conversionMode == ConversionMode::BothUnit || _conversionMode == ConversionMode::AlterUnit;
+
+    // Every conversion occupies a slot, even an invalid one, so that the time base stays locked to the sampling frequency.
+    uint64_t time = 0;
+    if (!dualUnit || unit == ADC_UNIT_1) {
+        time = _slotTime(_nextSlot++);
+        _unit1Time = time;
+    } else {
+        const int64_t unit2Time = static_cast<int64_t>(_unit1Time) + _config.unit2OffsetNanoseconds;
+        time = unit2Time > 0 ? static_cast<uint64_t>(unit2Time) : 0;
+    }
+
+    if (!valid) {
+        return;
+    }
+
+    const size_t unitNum = static_cast<size_t>(unit);
+    const size_t channelNum = static_cast<size_t>(channel);
+    if (unitNum >= SOC_ADC_PERIPH_NUM || channelNum >= SOC_ADC_MAX_CHANNEL_NUM || _streamForChannel[unitNum][channelNum] == kNoStream) {
+        _unknownSamples++;
+        return;
+    }
+
+    Stream& stream = _streams[_streamForChannel[unitNum][channelNum]];
+    if (_config.interpolateUnit2 && unit == ADC_UNIT_2) {
+        _interpolate(stream, time, value, err);
+        return;
+    }
+
+    _append(stream, stream.nextIndex++, time, value, err);
+}
+
+void ADCDeinterleaver::_append(Stream& stream, uint64_t index, uint64_t time, uint32_t value, esp_err_t& err) {
+    // Never grow the stream here, process may be running from the conversion complete ISR.
+    if (stream.samples.size() == stream.samples.capacity()) {
+        _droppedSamples++;
+        err = ESP_ERR_INVALID_SIZE;
+        return;
+    }
+
+    stream.samples.push_back(ADCSample{.index = index, .timeNanoseconds = time, .value = value});
+}
+
+void ADCDeinterleaver::_interpolate(Stream& stream, uint64_t time, uint32_t value, esp_err_t& err) {
+    if (!stream.hasPrevious) {
+        while (_gridTime(stream.nextGridIndex) < time) {
+            stream.nextGridIndex++;
+        }
+    }
+
+    uint64_t gridTime = _gridTime(stream.nextGridIndex);
+    while (gridTime <= time) {
+        if (!stream.hasPrevious || gridTime == time) {
+            _append(stream, stream.nextGridIndex, gridTime, value, err);
+        } else if (gridTime >= stream.previousTime) {
+            const int64_t span = static_cast<int64_t>(time - stream.previousTime);
+            const int64_t delta = static_cast<int64_t>(value) - static_cast<int64_t>(stream.previousValue);
+            const int64_t offset = static_cast<int64_t>(gridTime - stream.previousTime);
+            const int64_t interpolated = static_cast<int64_t>(stream.previousValue) + (delta * offset + (delta >= 0 ? span / 2 : -span / 2)) / span;
+            _append(stream, stream.nextGridIndex, gridTime, static_cast<uint32_t>(interpolated), err);
+        }
+        stream.nextGridIndex++;
+        gridTime = _gridTime(stream.nextGridIndex);
+    }
+
+    stream.hasPrevious = true;
+    stream.previousTime = time;
+    stream.previousValue = value;
+}
+
+uint64_t ADCDeinterleaver::_slotTime(uint64_t slot) const {
+    // Split the multiply so that the time base doesn't overflow on long captures.
+    return (slot / _samplingFrequencyHz) * 1'000'000'000ull + ((slot % _samplingFrequencyHz) * 1'000'000'000ull) / _samplingFrequencyHz;
+}
+
+uint64_t ADCDeinterleaver::_gridTime(uint64_t gridIndex) const {
+    return _slotTime(gridIndex * _slotsPerCycle);
+}
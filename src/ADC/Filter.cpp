@@ -0,0 +1,106 @@
+#include "ADC/Filter.hpp"
+#include "ADC/Continuous.hpp"
+
+#include <esp_log.h>
+
+using namespace esp;
+using namespace esp::adc;
+
+namespace esp {
+    namespace adc {
+        uint32_t iirFilterDivisor(IIRFilterCoefficient coefficient) {
+            switch (coefficient) {
+                case IIRFilterCoefficient::K2:
+                    return 2;
+                case IIRFilterCoefficient::K4:
+                    return 4;
+                case IIRFilterCoefficient::K8:
+                    return 8;
+                case IIRFilterCoefficient::K16:
+                    return 16;
+                case IIRFilterCoefficient::K64:
+                    return 64;
+            }
+            // GCC...
+            return 2;
+        }
+    }  // namespace adc
+}  // namespace esp
+
+#if SOC_ADC_DIG_IIR_FILTER_SUPPORTED
+ADCIIRFilter::ADCIIRFilter(ADCContinuousPtr adc, const ADCIIRFilterConfig& config, esp_err_t& err) : _adc(adc), _config(config) {
+    adc_continuous_iir_filter_config_t filterConfig = {
+        .unit = config.unit,
+        .channel = config.channel,
+        .coeff = static_cast<adc_digi_iir_filter_coeff_t>(config.coefficient),
+    };
+    err = adc_new_continuous_iir_filter(adc->_handle, &filterConfig, &_filter);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_new_continuous_iir_filter failed: %s", esp_err_to_name(err));
+        _filter = nullptr;
+        return;
+    }
+}
+
+ADCIIRFilter::~ADCIIRFilter() {
+    if (_filter == nullptr) {
+        return;
+    }
+
+    esp_err_t err = ESP_OK;
+    disable(err);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp::adc::ADCIIRFilter::disable failed: %s", esp_err_to_name(err));
+    }
+
+    err = adc_del_continuous_iir_filter(_filter);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_del_continuous_iir_filter failed: %s", esp_err_to_name(err));
+    }
+}
+
+void ADCIIRFilter::enable(esp_err_t& err) {
+    if (_enabled) {
+        return;
+    }
+
+    err = adc_continuous_iir_filter_enable(_filter);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_continuous_iir_filter_enable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _enabled = true;
+}
+
+void ADCIIRFilter::disable(esp_err_t& err) {
+    if (!_enabled) {
+        return;
+    }
+
+    err = adc_continuous_iir_filter_disable(_filter);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_continuous_iir_filter_disable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _enabled = false;
+}
+#endif
+
+uint32_t ADCIIRFilterModel::push(uint32_t value) {
+    if (!_primed) {
+        _state = value;
+        _primed = true;
+        return _state;
+    }
+
+    _state = ((_divisor - 1) * _state + value) / _divisor;
+    return _state;
+}
+
+void ADCIIRFilterModel::process(std::span<ADCSample> samples) {
+    for (ADCSample& sample : samples) {
+        sample.value = push(sample.value);
+    }
+}
@@ -0,0 +1,306 @@
+#include "ADC/History.hpp"
+
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+using namespace esp;
+using namespace esp::adc;
+
+ADCHistory::ADCHistory(ADCContinuousPtr adc, const ADCHistoryConfig& config, esp_err_t& err)
+    : _adc(adc), _config(config), _samplingFrequencyHz(adc->config().samplingFrequencyHz) {
+    if (config.blockSize == 0 || config.blockCount < 2 || _samplingFrequencyHz == 0) {
+        ESP_LOGE(_loggingTag, "Invalid history configuration");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    // Whole cache lines keep every bulk copy into the ring aligned at both ends.
+    _blockSize = ((config.blockSize + kCacheLineSize - 1) / kCacheLineSize) * kCacheLineSize;
+    _conversionsPerBlock = _blockSize / SOC_ADC_DIGI_RESULT_BYTES;
+    _conversionsPerFrame = adc->config().numberOfValuesPerConversionFrame * SOC_ADC_DIGI_DATA_BYTES_PER_CONV / SOC_ADC_DIGI_RESULT_BYTES;
+
+    _staging = static_cast<uint8_t*>(heap_caps_aligned_alloc(kCacheLineSize, _blockSize, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+    if (_staging == nullptr) {
+        ESP_LOGE(_loggingTag, "Failed to allocate %zu byte staging block", _blockSize);
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+
+    _ring = static_cast<uint8_t*>(heap_caps_aligned_alloc(kCacheLineSize, _blockSize * config.blockCount, config.memoryCapabilities));
+    if (_ring == nullptr) {
+        ESP_LOGE(_loggingTag, "Failed to allocate %zu byte history ring", _blockSize * config.blockCount);
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+
+    _blocks = std::make_unique<Block[]>(config.blockCount);
+}
+
+ADCHistory::~ADCHistory() {
+    if (_running) {
+        esp_err_t err = ESP_OK;
+        stop(err);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "esp::adc::ADCHistory::stop failed: %s", esp_err_to_name(err));
+        }
+    }
+
+    if (_ring != nullptr) {
+        heap_caps_free(_ring);
+    }
+    if (_staging != nullptr) {
+        heap_caps_free(_staging);
+    }
+}
+
+void ADCHistory::start(esp_err_t& err) {
+    if (_running) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    for (size_t i = 0; i < _config.blockCount; i++) {
+        _blocks[i].index.store(UINT64_MAX, std::memory_order_relaxed);
+    }
+    _blocksWritten.store(0, std::memory_order_release);
+    _droppedConversions.store(0, std::memory_order_relaxed);
+
+    // Anything already in the pool predates the time base, so throw it away, flushing again if a frame lands meanwhile so that the
+    // frame count starts from an empty pool.
+    uint32_t frames = 0;
+    do {
+        frames = _adc->framesConverted();
+        err = _adc->flush();
+        if (err != ESP_OK) {
+            return;
+        }
+    } while (_adc->framesConverted() != frames);
+    _startTime = std::chrono::microseconds(esp_timer_get_time());
+    _stagingConversion = 0;
+    _framesConverted = 0;
+    _framesSeen = frames;
+    _overflowsSeen = _adc->poolOverflows();
+
+    _running = true;
+    BaseType_t result = xTaskCreatePinnedToCore(_drainTask, _config.taskInfo.name.c_str(), _config.taskInfo.stackSize, this, _config.taskInfo.priority,
+                                                &_task, _config.taskInfo.coreId);
+    if (result != pdPASS) {
+        ESP_LOGE(_loggingTag, "xTaskCreatePinnedToCore failed");
+        _running = false;
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+}
+
+void ADCHistory::stop(esp_err_t& err) {
+    if (!_running) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    _stoppingTask = xTaskGetCurrentTaskHandle();
+    _running = false;
+
+    // The drain task notices within one read timeout and notifies us on its way out.
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    _task = nullptr;
+    _stoppingTask = nullptr;
+}
+
+std::pair<std::chrono::microseconds, std::chrono::microseconds> ADCHistory::availableRange() const {
+    while (true) {
+        const uint64_t written = _blocksWritten.load(std::memory_order_acquire);
+        if (written == 0) {
+            return std::make_pair(_conversionTime(0), _conversionTime(0));
+        }
+
+        // The oldest block in the ring is the next one to be overwritten, so don't promise it.
+        const uint64_t oldest = written >= _config.blockCount ? written - _config.blockCount + 1 : 0;
+        const uint64_t from = _blocks[oldest % _config.blockCount].firstConversion.load(std::memory_order_relaxed);
+        const uint64_t to = _blocks[(written - 1) % _config.blockCount].firstConversion.load(std::memory_order_relaxed) + _conversionsPerBlock;
+        if (_blocksWritten.load(std::memory_order_acquire) == written) {
+            return std::make_pair(_conversionTime(from), _conversionTime(to));
+        }
+    }
+}
+
+size_t ADCHistory::read(std::chrono::microseconds from, std::chrono::microseconds to, std::span<uint8_t> buffer, esp_err_t& err) const {
+    err = ESP_OK;
+    if (to <= from) {
+        return 0;
+    }
+
+    const uint64_t written = _blocksWritten.load(std::memory_order_acquire);
+    const uint64_t oldest = written > _config.blockCount ? written - _config.blockCount : 0;
+    const uint64_t firstConversion = _conversionAt(from);
+    const uint64_t endConversion = _conversionAt(to);
+
+    // Blocks are in time order but not evenly spaced once conversions have been dropped, so walk them from the oldest.
+    size_t copied = 0;
+    bool lapped = false;
+    bool gap = false;
+    std::optional<uint64_t> covered;
+    for (uint64_t blockIndex = oldest; blockIndex < written; blockIndex++) {
+        const Block& block = _blocks[blockIndex % _config.blockCount];
+        const uint32_t sequence = block.sequence.load(std::memory_order_acquire);
+        const bool indexMatches = block.index.load(std::memory_order_relaxed) == blockIndex;
+        const uint64_t blockStart = block.firstConversion.load(std::memory_order_relaxed);
+        const uint64_t start = std::max(firstConversion, blockStart);
+        const uint64_t end = std::min(endConversion, blockStart + _conversionsPerBlock);
+        size_t bytes = start < end ? (end - start) * SOC_ADC_DIGI_RESULT_BYTES : 0;
+        const bool full = copied + bytes > buffer.size();
+        if (full) {
+            bytes = ((buffer.size() - copied) / SOC_ADC_DIGI_RESULT_BYTES) * SOC_ADC_DIGI_RESULT_BYTES;
+        }
+        const uint8_t* source = _ring + (blockIndex % _config.blockCount) * _blockSize + (start - blockStart) * SOC_ADC_DIGI_RESULT_BYTES;
+        std::memcpy(buffer.data() + copied, source, bytes);
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // The drain task lapped us while we were copying, so the data, and where the block starts, may be torn.  Only the oldest blocks
+        // are lapped, so the first block that survives tells whether any of the range went with them.
+        if ((sequence & 1) != 0 || !indexMatches || block.sequence.load(std::memory_order_relaxed) != sequence) {
+            lapped = true;
+            continue;
+        }
+        if (lapped && blockStart > firstConversion) {
+            err = ESP_ERR_INVALID_STATE;
+        }
+        lapped = false;
+        if (start >= end) {
+            continue;
+        }
+
+        gap = gap || (covered && start > *covered);
+        covered = end;
+        copied += bytes;
+        if (full) {
+            err = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+    }
+    if (lapped) {
+        err = ESP_ERR_INVALID_STATE;
+    }
+
+    if (err == ESP_OK && gap) {
+        err = ESP_ERR_NOT_FOUND;
+    }
+    return copied;
+}
+
+void ADCHistory::_drainTask(void* userInfo) {
+    ADCHistory* history = static_cast<ADCHistory*>(userInfo);
+    history->_drain();
+
+    TaskHandle_t stoppingTask = history->_stoppingTask;
+    if (stoppingTask != nullptr) {
+        xTaskNotifyGive(stoppingTask);
+    }
+    vTaskDelete(nullptr);
+}
+
+void ADCHistory::_drain() {
+    size_t filled = 0;
+    while (_running) {
+        const uint64_t frames = _frames();
+        esp_err_t err = ESP_OK;
+        const size_t bytesRead = _adc->read(_staging + filled, _blockSize - filled, _config.readTimeoutMs, err);
+
+        // An overflow at any point up to here may have left a gap, or a flushed pool, inside what's in the staging block.
+        const uint32_t overflows = _adc->poolOverflows();
+        if (overflows != _overflowsSeen) {
+            _overflowsSeen = overflows;
+            _resynchronise();
+            filled = 0;
+            continue;
+        }
+
+        if (err == ESP_ERR_TIMEOUT) {
+            // The pool ran dry, so unless a frame came in meanwhile every conversion has either been read or lost.
+            if (_frames() == frames && _reanchor(frames, filled)) {
+                filled = 0;
+            }
+            continue;
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "esp::adc::ADCContinuous::read failed: %s", esp_err_to_name(err));
+            vTaskDelay(pdMS_TO_TICKS(_config.readTimeoutMs));
+            continue;
+        }
+
+        filled += bytesRead;
+        if (filled == _blockSize) {
+            _commitBlock();
+            filled = 0;
+        }
+    }
+}
+
+void ADCHistory::_commitBlock() {
+    const uint64_t index = _blocksWritten.load(std::memory_order_relaxed);
+    const size_t slot = index % _config.blockCount;
+    Block& block = _blocks[slot];
+
+    block.sequence.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(_ring + slot * _blockSize, _staging, _blockSize);
+    block.index.store(index, std::memory_order_relaxed);
+    block.firstConversion.store(_stagingConversion, std::memory_order_relaxed);
+    block.sequence.fetch_add(1, std::memory_order_release);
+
+    _stagingConversion += _conversionsPerBlock;
+    _blocksWritten.store(index + 1, std::memory_order_release);
+}
+
+uint64_t ADCHistory::_frames() {
+    const uint32_t frames = _adc->framesConverted();
+    _framesConverted += frames - _framesSeen;
+    _framesSeen = frames;
+    return _framesConverted;
+}
+
+void ADCHistory::_resynchronise() {
+    // Wherever the overflow fell, the pool no longer follows on from the staging block, so read it dry until a read finds it empty with
+    // no frame converted meanwhile.
+    while (_running) {
+        const uint64_t frames = _frames();
+        esp_err_t err = ESP_OK;
+        _adc->read(_staging, _blockSize, 0, err);
+        if (err == ESP_ERR_TIMEOUT && _frames() == frames) {
+            _reanchor(frames, 0);
+            return;
+        }
+        if (err != ESP_OK && err != ESP_ERR_TIMEOUT) {
+            ESP_LOGE(_loggingTag, "esp::adc::ADCContinuous::read failed: %s", esp_err_to_name(err));
+            vTaskDelay(pdMS_TO_TICKS(_config.readTimeoutMs));
+        }
+    }
+}
+
+bool ADCHistory::_reanchor(uint64_t frames, size_t filled) {
+    const uint64_t converted = frames * _conversionsPerFrame;
+    if (converted <= _stagingConversion + filled / SOC_ADC_DIGI_RESULT_BYTES) {
+        return false;
+    }
+
+    _droppedConversions.fetch_add(converted - _stagingConversion, std::memory_order_relaxed);
+    _stagingConversion = converted;
+    return true;
+}
+
+std::chrono::microseconds ADCHistory::_conversionTime(uint64_t conversion) const {
+    return _startTime + std::chrono::microseconds(conversion * 1'000'000ull / _samplingFrequencyHz);
+}
+
+uint64_t ADCHistory::_conversionAt(std::chrono::microseconds time) const {
+    if (time <= _startTime) {
+        return 0;
+    }
+
+    const uint64_t elapsed = static_cast<uint64_t>((time - _startTime).count());
+    return (elapsed * _samplingFrequencyHz + 999'999ull) / 1'000'000ull;
+}
@@ -0,0 +1,151 @@
+#include "ADC/MedianFilter.hpp"
+
+#include <esp_log.h>
+
+#include <utility>
+
+using namespace esp;
+using namespace esp::adc;
+
+ADCMedianFilter::ADCMedianFilter(const ADCMedianFilterConfig& config, esp_err_t& err) : _config(config) {
+    if (config.windowSize == 0 || config.windowSize > INT32_MAX / 2) {
+        ESP_LOGE(_loggingTag, "Invalid window size: %zu", config.windowSize);
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _windowSize = static_cast<int32_t>(config.windowSize);
+    _values.resize(_windowSize);
+    _positions.resize(_windowSize);
+    _heapStorage.resize(_windowSize);
+    _heap = _heapStorage.data() + _windowSize / 2;
+
+    reset();
+}
+
+uint32_t ADCMedianFilter::push(uint32_t value) {
+    const bool isNew = _count < _windowSize;
+    const int32_t position = _positions[_next];
+    const uint32_t old = _values[_next];
+    _values[_next] = value;
+    _next = (_next + 1) % _windowSize;
+    if (isNew) {
+        _count++;
+    }
+
+    if (position > 0) {
+        if (!isNew && old < value) {
+            _minSortDown(position * 2);
+        } else if (_minSortUp(position)) {
+            _maxSortDown(-1);
+        }
+    } else if (position < 0) {
+        if (!isNew && value < old) {
+            _maxSortDown(position * 2);
+        } else if (_maxSortUp(position)) {
+            _minSortDown(1);
+        }
+    } else {
+        if (_maxCount() > 0) {
+            _maxSortDown(-1);
+        }
+        if (_minCount() > 0) {
+            _minSortDown(1);
+        }
+    }
+
+    const uint32_t windowMedian = median();
+    if (!_config.spikeThreshold.has_value()) {
+        return windowMedian;
+    }
+
+    const uint32_t deviation = value > windowMedian ? value - windowMedian : windowMedian - value;
+    if (deviation > *_config.spikeThreshold) {
+        _rejectedSamples++;
+        return windowMedian;
+    }
+
+    return value;
+}
+
+void ADCMedianFilter::process(std::span<ADCSample> samples) {
+    for (ADCSample& sample : samples) {
+        sample.value = push(sample.value);
+    }
+}
+
+uint32_t ADCMedianFilter::median() const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    // With an even number of samples the max-heap holds one more value than the min-heap, so average the two middle values.
+    const uint32_t upper = _values[_heap[0]];
+    if ((_count & 1) == 0) {
+        const uint32_t lower = _values[_heap[-1]];
+        return lower + (upper - lower) / 2;
+    }
+
+    return upper;
+}
+
+void ADCMedianFilter::reset() {
+    _next = 0;
+    _count = 0;
+    _rejectedSamples = 0;
+
+    // Fill the heap in the order median, max, min, max, min... so that the window grows evenly on both sides.
+    for (int32_t i = _windowSize - 1; i >= 0; i--) {
+        _positions[i] = ((i + 1) / 2) * ((i & 1) ? -1 : 1);
+        _heap[_positions[i]] = i;
+    }
+}
+
+bool ADCMedianFilter::_exchangeIfLess(int32_t i, int32_t j) {
+    if (!_less(i, j)) {
+        return false;
+    }
+
+    std::swap(_heap[i], _heap[j]);
+    _positions[_heap[i]] = i;
+    _positions[_heap[j]] = j;
+    return true;
+}
+
+// Restores the min-heap below i / 2, where i / 2 may be the median.
+void ADCMedianFilter::_minSortDown(int32_t i) {
+    for (; i <= _minCount(); i *= 2) {
+        if (i > 1 && i < _minCount() && _less(i + 1, i)) {
+            i++;
+        }
+        if (!_exchangeIfLess(i, i / 2)) {
+            break;
+        }
+    }
+}
+
+// Restores the max-heap below i / 2, where i / 2 may be the median.
+void ADCMedianFilter::_maxSortDown(int32_t i) {
+    for (; i >= -_maxCount(); i *= 2) {
+        if (i < -1 && i > -_maxCount() && _less(i, i - 1)) {
+            i--;
+        }
+        if (!_exchangeIfLess(i / 2, i)) {
+            break;
+        }
+    }
+}
+
+bool ADCMedianFilter::_minSortUp(int32_t i) {
+    while (i > 0 && _exchangeIfLess(i, i / 2)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+bool ADCMedianFilter::_maxSortUp(int32_t i) {
+    while (i < 0 && _exchangeIfLess(i / 2, i)) {
+        i /= 2;
+    }
+    return i == 0;
+}
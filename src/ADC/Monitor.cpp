@@ -0,0 +1,125 @@
+#include "ADC/Monitor.hpp"
+#include "ADC/Continuous.hpp"
+
+#include <esp_log.h>
+
+using namespace esp;
+using namespace esp::adc;
+
+#if SOC_ADC_MONITOR_SUPPORTED
+namespace esp {
+    namespace adc {
+        bool _onAboveHighThreshold(adc_monitor_handle_t handle, const adc_monitor_evt_data_t* data, void* userData) {
+            auto& [monitor, userInfo] = *reinterpret_cast<std::pair<ADCMonitor*, void*>*>(userData);
+            return monitor->_callbacks.onAboveHighThreshold ? static_cast<bool>(monitor->_callbacks.onAboveHighThreshold(userInfo)) : false;
+        }
+
+        bool _onBelowLowThreshold(adc_monitor_handle_t handle, const adc_monitor_evt_data_t* data, void* userData) {
+            auto& [monitor, userInfo] = *reinterpret_cast<std::pair<ADCMonitor*, void*>*>(userData);
+            return monitor->_callbacks.onBelowLowThreshold ? static_cast<bool>(monitor->_callbacks.onBelowLowThreshold(userInfo)) : false;
+        }
+    }  // namespace adc
+}  // namespace esp
+
+ADCMonitor::ADCMonitor(ADCContinuousPtr adc, const ADCMonitorConfig& config, esp_err_t& err) : _adc(adc), _config(config) {
+    adc_monitor_config_t monitorConfig = {
+        .adc_unit = config.unit,
+        .channel = config.channel,
+        .h_threshold = config.highThreshold.has_value() ? static_cast<int32_t>(*config.highThreshold) : -1,
+        .l_threshold = config.lowThreshold.has_value() ? static_cast<int32_t>(*config.lowThreshold) : -1,
+    };
+    err = adc_new_continuous_monitor(adc->_handle, &monitorConfig, &_monitor);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_new_continuous_monitor failed: %s", esp_err_to_name(err));
+        _monitor = nullptr;
+        return;
+    }
+}
+
+ADCMonitor::~ADCMonitor() {
+    if (_monitor == nullptr) {
+        return;
+    }
+
+    esp_err_t err = ESP_OK;
+    disable(err);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp::adc::ADCMonitor::disable failed: %s", esp_err_to_name(err));
+    }
+
+    err = adc_del_continuous_monitor(_monitor);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_del_continuous_monitor failed: %s", esp_err_to_name(err));
+    }
+}
+
+void ADCMonitor::setEventCallbacks(const ADCMonitorEventCallbacks& callbacks, void* userInfo, esp_err_t& err) {
+    adc_monitor_evt_cbs_t callbackConfig = {
+        .on_over_high_thresh = callbacks.onAboveHighThreshold ? _onAboveHighThreshold : nullptr,
+        .on_below_low_thresh = callbacks.onBelowLowThreshold ? _onBelowLowThreshold : nullptr,
+    };
+    _callbacks = callbacks;
+    _userInfo = std::make_pair(this, userInfo);
+    err = adc_continuous_monitor_register_event_callbacks(_monitor, &callbackConfig, &_userInfo);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_continuous_monitor_register_event_callbacks failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void ADCMonitor::enable(esp_err_t& err) {
+    if (_enabled) {
+        return;
+    }
+
+    err = adc_continuous_monitor_enable(_monitor);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_continuous_monitor_enable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _enabled = true;
+}
+
+void ADCMonitor::disable(esp_err_t& err) {
+    if (!_enabled) {
+        return;
+    }
+
+    err = adc_continuous_monitor_disable(_monitor);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "adc_continuous_monitor_disable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _enabled = false;
+}
+#endif
+
+void ADCMonitorModel::setEventCallbacks(const ADCMonitorEventCallbacks& callbacks, void* userInfo) {
+    _callbacks = callbacks;
+    _userInfo = userInfo;
+}
+
+InterruptResult ADCMonitorModel::push(uint32_t value) {
+    if (_config.highThreshold.has_value() && value > *_config.highThreshold && _callbacks.onAboveHighThreshold) {
+        return _callbacks.onAboveHighThreshold(_userInfo);
+    }
+
+    if (_config.lowThreshold.has_value() && value < *_config.lowThreshold && _callbacks.onBelowLowThreshold) {
+        return _callbacks.onBelowLowThreshold(_userInfo);
+    }
+
+    return InterruptResult::NoHighPriorityTaskWoken;
+}
+
+InterruptResult ADCMonitorModel::process(std::span<const ADCSample> samples) {
+    InterruptResult result = InterruptResult::NoHighPriorityTaskWoken;
+    for (const ADCSample& sample : samples) {
+        if (push(sample.value) == InterruptResult::HighPriorityTaskWoken) {
+            result = InterruptResult::HighPriorityTaskWoken;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,71 @@
+#include "BitBangSerial.hpp"
+
+#include <esp_log.h>
+#include <esp_rom_sys.h>
+#include <soc/soc_caps.h>
+
+using namespace esp;
+
+BitBangSerial::BitBangSerial(const BitBangSerialConfig& config, std::vector<GPIOPtr> gpios, esp_err_t& err)
+    : _config(config), _gpios(std::move(gpios)) {
+    if (config.wordSize == 0 || config.wordSize > 32) {
+        ESP_LOGE(_loggingTag, "Invalid word size: %u", config.wordSize);
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+    if (config.clockHz != 0 && static_cast<uint64_t>(config.wordSize) * 1'000'000 > static_cast<uint64_t>(kMaxMaskedMicros) * config.clockHz) {
+        ESP_LOGE(_loggingTag, "A %u bit word at %lu Hz masks interrupts for longer than %lu us", config.wordSize,
+                 static_cast<unsigned long>(config.clockHz), static_cast<unsigned long>(kMaxMaskedMicros));
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    const uint32_t clock = static_cast<uint32_t>(config.clock);
+    _port.clockSetReg = _setReg(clock);
+    _port.clockClearReg = _clearReg(clock);
+    _port.clockMask = 1u << (clock % 32);
+
+    if (config.dataOut != GPIO_NUM_NC) {
+        const uint32_t dataOut = static_cast<uint32_t>(config.dataOut);
+        _port.dataSetReg = _setReg(dataOut);
+        _port.dataClearReg = _clearReg(dataOut);
+        _port.dataMask = 1u << (dataOut % 32);
+    }
+
+    if (config.dataIn != GPIO_NUM_NC) {
+        const uint32_t dataIn = static_cast<uint32_t>(config.dataIn);
+#if SOC_GPIO_PIN_COUNT > 32
+        _port.sampleReg = dataIn < 32 ? GPIO_IN_REG : GPIO_IN1_REG;
+#else
+        _port.sampleReg = GPIO_IN_REG;
+#endif
+        _port.sampleShift = dataIn % 32;
+        _port.hasDataIn = true;
+    }
+
+    if (config.clockHz != 0) {
+        const uint32_t cyclesPerSecond = esp_rom_get_cpu_ticks_per_us() * 1'000'000;
+        _halfPeriodCycles = cyclesPerSecond / (2 * config.clockHz);
+    }
+
+    _port.setClock(config.clockPolarity);
+    if (_isHalfDuplex(config)) {
+        _port.setData(Level::High);
+    }
+}
+
+uint32_t BitBangSerial::_setReg(uint32_t pin) {
+#if SOC_GPIO_PIN_COUNT > 32
+    return pin < 32 ? GPIO_OUT_W1TS_REG : GPIO_OUT1_W1TS_REG;
+#else
+    return GPIO_OUT_W1TS_REG;
+#endif
+}
+
+uint32_t BitBangSerial::_clearReg(uint32_t pin) {
+#if SOC_GPIO_PIN_COUNT > 32
+    return pin < 32 ? GPIO_OUT_W1TC_REG : GPIO_OUT1_W1TC_REG;
+#else
+    return GPIO_OUT_W1TC_REG;
+#endif
+}
@@ -0,0 +1,239 @@
+#include "Coroutine.hpp"
+
+#include <esp_attr.h>
+#include <esp_log.h>
+
+#include <vector>
+
+using namespace esp;
+
+bool priv::Deadline::arm(std::coroutine_handle<> handle) {
+    CoroutineExecutor* executor = CoroutineExecutor::current();
+    if (executor == nullptr) {
+        return false;
+    }
+
+    _executor = executor;
+    _handle = handle;
+    executor->_insert(this);
+    _armed = true;
+    _fired = false;
+    executor->_armTimer();
+    return true;
+}
+
+void priv::Deadline::cancel() {
+    if (!_armed) {
+        return;
+    }
+
+    // Leaving the timer set for a cancelled deadline only costs a spurious wakeup.
+    _executor->_remove(this);
+    _armed = false;
+}
+
+CoroutineExecutor::CoroutineExecutor(const CoroutineExecutorConfig& config, esp_err_t& err) : _config(config) {
+    _queue = xQueueCreate(config.queueSize, sizeof(Message));
+    if (_queue == nullptr) {
+        ESP_LOGE(_loggingTag, "xQueueCreate failed");
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+
+    const TaskInfo& taskInfo = config.taskInfo;
+    BaseType_t result =
+        xTaskCreatePinnedToCore(_executorTask, taskInfo.name.c_str(), taskInfo.stackSize, this, taskInfo.priority, &_task, taskInfo.coreId);
+    if (result != pdPASS) {
+        ESP_LOGE(_loggingTag, "xTaskCreatePinnedToCore failed");
+        _task = nullptr;
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+}
+
+CoroutineExecutor::~CoroutineExecutor() {
+    if (_task != nullptr) {
+        _stoppingTask = xTaskGetCurrentTaskHandle();
+        const Message message = {.kind = MessageKind::Stop, .address = nullptr};
+        xQueueSend(_queue, &message, portMAX_DELAY);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+
+    _timer.reset();
+    if (_queue != nullptr) {
+        vQueueDelete(_queue);
+    }
+}
+
+void CoroutineExecutor::spawn(Coroutine<void> coroutine, esp_err_t& err) {
+    std::coroutine_handle<priv::Promise<void>> handle = std::exchange(coroutine._handle, nullptr);
+    handle.promise().executor = this;
+
+    // The executor can't wait for itself to empty the queue.
+    const Message message = {.kind = MessageKind::Spawn, .address = handle.address()};
+    if (xQueueSend(_queue, &message, current() == this ? 0 : portMAX_DELAY) != pdTRUE) {
+        handle.destroy();
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+    err = ESP_OK;
+}
+
+void CoroutineExecutor::_insert(priv::Deadline* deadline) {
+    deadline->_order = _deadlinesArmed++;
+    deadline->_child = nullptr;
+    deadline->_next = nullptr;
+    deadline->_previous = nullptr;
+    _earliest = _earliest == nullptr ? deadline : _meld(_earliest, deadline);
+}
+
+void CoroutineExecutor::_remove(priv::Deadline* deadline) {
+    priv::Deadline* children = _mergePairs(deadline->_child);
+    if (deadline == _earliest) {
+        _earliest = children;
+        return;
+    }
+
+    // Unlink it from its siblings, then meld its children back in.
+    if (deadline->_previous->_child == deadline) {
+        deadline->_previous->_child = deadline->_next;
+    } else {
+        deadline->_previous->_next = deadline->_next;
+    }
+    if (deadline->_next != nullptr) {
+        deadline->_next->_previous = deadline->_previous;
+    }
+    if (children != nullptr) {
+        _earliest = _meld(_earliest, children);
+    }
+}
+
+bool CoroutineExecutor::_before(const priv::Deadline* a, const priv::Deadline* b) {
+    return a->_at < b->_at || (a->_at == b->_at && a->_order < b->_order);
+}
+
+priv::Deadline* CoroutineExecutor::_meld(priv::Deadline* a, priv::Deadline* b) {
+    if (_before(b, a)) {
+        std::swap(a, b);
+    }
+    b->_previous = a;
+    b->_next = a->_child;
+    if (a->_child != nullptr) {
+        a->_child->_previous = b;
+    }
+    a->_child = b;
+    return a;
+}
+
+priv::Deadline* CoroutineExecutor::_mergePairs(priv::Deadline* first) {
+    // The melded pairs, the last first, linked through _next.
+    priv::Deadline* pairs = nullptr;
+    while (first != nullptr) {
+        priv::Deadline* pair = first;
+        priv::Deadline* second = pair->_next;
+        first = second == nullptr ? nullptr : second->_next;
+        pair->_next = nullptr;
+        pair->_previous = nullptr;
+        if (second != nullptr) {
+            second->_next = nullptr;
+            second->_previous = nullptr;
+            pair = _meld(pair, second);
+        }
+        pair->_next = pairs;
+        pairs = pair;
+    }
+
+    priv::Deadline* root = nullptr;
+    while (pairs != nullptr) {
+        priv::Deadline* next = pairs->_next;
+        pairs->_next = nullptr;
+        root = root == nullptr ? pairs : _meld(root, pairs);
+        pairs = next;
+    }
+    return root;
+}
+
+void CoroutineExecutor::_runExpired() {
+    while (_earliest != nullptr && _earliest->_at <= Timer::now()) {
+        // Resuming can add and remove deadlines, so take each one off the heap first.
+        priv::Deadline* deadline = _earliest;
+        _remove(deadline);
+        deadline->_armed = false;
+        deadline->_fired = true;
+        deadline->_handle.resume();
+    }
+
+    _armTimer();
+}
+
+void CoroutineExecutor::_armTimer() {
+    if (_timer == nullptr || _earliest == nullptr) {
+        return;
+    }
+
+    const std::chrono::microseconds earliest = _earliest->_at;
+    if (_timer->isActive()) {
+        if (earliest == _armedAt) {
+            return;
+        }
+        _timer->stop();
+    }
+    _armedAt = earliest;
+    _timer->startOneshot(std::max(earliest - Timer::now(), std::chrono::microseconds(0)));
+}
+
+void CoroutineExecutor::_finished(std::coroutine_handle<> handle) {
+    _roots.erase(handle.address());
+    handle.destroy();
+}
+
+void IRAM_ATTR CoroutineExecutor::_onTimer(Timer& timer, void* userInfo) {
+    CoroutineExecutor* executor = static_cast<CoroutineExecutor*>(userInfo);
+    const Message message = {.kind = MessageKind::Wake, .address = nullptr};
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+    if (executor->_config.dispatchMethod == TimerDispatchMethod::ISR) {
+        BaseType_t taskAwoken = pdFALSE;
+        xQueueSendFromISR(executor->_queue, &message, &taskAwoken);
+        if (taskAwoken == pdTRUE) {
+            Timer::requestISRYield();
+        }
+        return;
+    }
+#endif
+
+    // A full queue means the executor is about to run anyway, and it checks the deadlines after every message.
+    xQueueSend(executor->_queue, &message, 0);
+}
+
+void CoroutineExecutor::_executorTask(void* userInfo) {
+    CoroutineExecutor* executor = static_cast<CoroutineExecutor*>(userInfo);
+    _current = executor;
+
+    Message message;
+    while (true) {
+        xQueueReceive(executor->_queue, &message, portMAX_DELAY);
+        if (message.kind == MessageKind::Stop) {
+            break;
+        }
+        if (message.kind == MessageKind::Spawn) {
+            executor->_roots.insert(message.address);
+            std::coroutine_handle<>::from_address(message.address).resume();
+        }
+        executor->_runExpired();
+    }
+
+    // Destroying the coroutines still running unregisters everything they were waiting on.
+    std::vector<void*> roots(executor->_roots.begin(), executor->_roots.end());
+    executor->_roots.clear();
+    for (void* root : roots) {
+        std::coroutine_handle<>::from_address(root).destroy();
+    }
+    _current = nullptr;
+
+    TaskHandle_t stoppingTask = executor->_stoppingTask;
+    if (stoppingTask != nullptr) {
+        xTaskNotifyGive(stoppingTask);
+    }
+    vTaskDelete(nullptr);
+}
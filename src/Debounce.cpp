@@ -0,0 +1,79 @@
+#include "Debounce.hpp"
+
+#include <esp_log.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+
+#include <bit>
+
+using namespace esp;
+
+DebounceGroup::DebounceGroup(const DebounceGroupConfig& config, esp_err_t& err) : _config(config) {
+    if (config.inputs.empty() || config.inputs.size() > UINT8_MAX) {
+        ESP_LOGE(_loggingTag, "Invalid number of inputs: %zu", config.inputs.size());
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    for (size_t i = 0; i < config.inputs.size(); i++) {
+        const uint32_t pin = static_cast<uint32_t>(config.inputs[i]->config().gpioNum);
+        const uint32_t bit = 1u << (pin % 32);
+        if (pin >= kNumBanks * 32 || (_masks[pin / 32] & bit) != 0) {
+            ESP_LOGE(_loggingTag, "Invalid or repeated input: %lu", static_cast<unsigned long>(pin));
+            err = ESP_ERR_INVALID_ARG;
+            return;
+        }
+        _masks[pin / 32] |= bit;
+        _inputForPin[pin] = static_cast<uint8_t>(i);
+
+        // Start from the current levels so nothing is reported until an input actually changes.
+        if (config.inputs[i]->level()) {
+            _states[pin / 32] |= bit;
+        }
+    }
+}
+
+void DebounceGroup::start(std::chrono::microseconds samplePeriod, esp_err_t& err) {
+    err = _timer->startPeriodic(samplePeriod);
+}
+
+void DebounceGroup::stop(esp_err_t& err) {
+    err = _timer->stop();
+}
+
+Level DebounceGroup::level(size_t input) const {
+    const uint32_t pin = static_cast<uint32_t>(_config.inputs[input]->config().gpioNum);
+    return (_states[pin / 32] & (1u << (pin % 32))) != 0 ? Level::High : Level::Low;
+}
+
+void DebounceGroup::sample(std::span<const uint32_t> levels) {
+    for (size_t bank = 0; bank < kNumBanks; bank++) {
+        if (_masks[bank] == 0) {
+            continue;
+        }
+
+        // Each counter resets whenever its input matches the debounced state and toggles the state when it wraps.
+        const uint32_t delta = (levels[bank] ^ _states[bank]) & _masks[bank];
+        _counts1[bank] = (_counts1[bank] ^ _counts0[bank]) & delta;
+        _counts0[bank] = ~_counts0[bank] & delta;
+        uint32_t toggled = delta & ~(_counts0[bank] | _counts1[bank]);
+        _states[bank] ^= toggled;
+
+        while (toggled != 0 && _config.callback != nullptr) {
+            const uint32_t bit = std::countr_zero(toggled);
+            toggled &= toggled - 1;
+            const Level level = (_states[bank] & (1u << bit)) != 0 ? Level::High : Level::Low;
+            _config.callback(_inputForPin[bank * 32 + bit], level, _config.userInfo);
+        }
+    }
+}
+
+void DebounceGroup::_onTick(Timer& timer, void* userInfo) {
+    DebounceGroup* group = static_cast<DebounceGroup*>(userInfo);
+    std::array<uint32_t, kNumBanks> levels = {};
+    levels[0] = REG_READ(GPIO_IN_REG);
+#if SOC_GPIO_PIN_COUNT > 32
+    levels[1] = REG_READ(GPIO_IN1_REG);
+#endif
+    group->sample(levels);
+}
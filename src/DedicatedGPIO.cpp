@@ -0,0 +1,68 @@
+#include "DedicatedGPIO.hpp"
+
+#include <esp_log.h>
+
+#include <bit>
+
+using namespace esp;
+
+DedicatedGPIOBundle::DedicatedGPIOBundle(const DedicatedGPIOBundleConfig& config, std::vector<GPIOPtr> gpios, esp_err_t& err)
+    : _config(config), _gpios(std::move(gpios)) {
+    if (config.pins.empty() || config.pins.size() >= 32 || (!config.input && !config.output)) {
+        ESP_LOGE(_loggingTag, "Invalid bundle configuration");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+    _widthMask = (1u << config.pins.size()) - 1;
+
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    std::vector<int> pins(config.pins.begin(), config.pins.end());
+    dedic_gpio_bundle_config_t bundleConfig = {
+        .gpio_array = pins.data(),
+        .array_size = pins.size(),
+        .flags =
+            {
+                .in_en = config.input,
+                .in_invert = config.invertInput,
+                .out_en = config.output,
+                .out_invert = config.invertOutput,
+            },
+    };
+    err = dedic_gpio_new_bundle(&bundleConfig, &_bundle);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "dedic_gpio_new_bundle failed: %s", esp_err_to_name(err));
+        _bundle = nullptr;
+        return;
+    }
+
+    // The bundle's channels are allocated contiguously, so the masks only tell us where they start.
+    uint32_t mask = 0;
+    if (config.output) {
+        err = dedic_gpio_get_out_mask(_bundle, &mask);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "dedic_gpio_get_out_mask failed: %s", esp_err_to_name(err));
+            return;
+        }
+        _outputShift = std::countr_zero(mask);
+    }
+    if (config.input) {
+        err = dedic_gpio_get_in_mask(_bundle, &mask);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "dedic_gpio_get_in_mask failed: %s", esp_err_to_name(err));
+            return;
+        }
+        _inputShift = std::countr_zero(mask);
+    }
+#endif
+}
+
+DedicatedGPIOBundle::~DedicatedGPIOBundle() {
+#if SOC_DEDICATED_GPIO_SUPPORTED
+    if (_bundle != nullptr) {
+        esp_err_t err = dedic_gpio_del_bundle(_bundle);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "dedic_gpio_del_bundle failed: %s", esp_err_to_name(err));
+        }
+    }
+#endif
+}
@@ -148,6 +148,166 @@ GPIOPtr ESP32::gpio(GPIOConfig gpioConfig, esp_err_t& err) {
     return gpio;
 }
 
+std::vector<GPIOPtr> ESP32::gpios(std::span<const GPIOConfig> gpioConfigs, esp_err_t& err) {
+    std::vector<GPIOPtr> gpios(gpioConfigs.size());
+    // One representative config and the pins that share its settings.
+    std::vector<std::pair<GPIOConfig, uint64_t>> groups;
+    uint64_t requested = 0;
+    for (size_t i = 0; i < gpioConfigs.size(); i++) {
+        const GPIOConfig& gpioConfig = gpioConfigs[i];
+        // Checked before building the mask, as shifting by GPIO_NUM_NC or past 63 is undefined.
+        if (!GPIO_IS_VALID_GPIO(gpioConfig.gpioNum) || numGPIOs() <= static_cast<size_t>(gpioConfig.gpioNum)) {
+            ESP_LOGE(_loggingTag, "Invalid GPIO: %d", gpioConfig.gpioNum);
+            err = ESP_ERR_INVALID_ARG;
+            return {};
+        }
+        const uint64_t bit = 1ull << gpioConfig.gpioNum;
+        if ((requested & bit) != 0) {
+            ESP_LOGE(_loggingTag, "Repeated GPIO: %d", gpioConfig.gpioNum);
+            err = ESP_ERR_INVALID_ARG;
+            return {};
+        }
+        requested |= bit;
+
+        gpios[i] = _gpios[gpioConfig.gpioNum].lock();
+        if (gpios[i] != nullptr) {
+            if (gpios[i]->config() != gpioConfig) {
+                err = ESP_ERR_INVALID_STATE;
+                return {};
+            }
+            continue;
+        }
+
+        auto group = std::find_if(groups.begin(), groups.end(), [&](const auto& group) {
+            const GPIOConfig& other = group.first;
+            return other.mode == gpioConfig.mode && other.pullUp == gpioConfig.pullUp && other.pullDown == gpioConfig.pullDown &&
+                   other.interuptType == gpioConfig.interuptType;
+        });
+        if (group == groups.end()) {
+            groups.emplace_back(gpioConfig, bit);
+        } else {
+            group->second |= bit;
+        }
+    }
+
+    err = ESP_OK;
+    for (const auto& [groupConfig, pinMask] : groups) {
+        GPIO::_configure(pinMask, groupConfig, err);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "ESP32::gpios failed: %s", esp_err_to_name(err));
+            return {};
+        }
+    }
+
+    for (size_t i = 0; i < gpioConfigs.size(); i++) {
+        if (gpios[i] == nullptr) {
+            // Can't use std::make_shared because we only have access through friendship
+            gpios[i] = std::shared_ptr<GPIO>(new GPIO(gpioConfigs[i]));
+            _gpios[gpioConfigs[i].gpioNum] = gpios[i];
+        }
+    }
+
+    return gpios;
+}
+
+void ESP32::setGPIOISRServiceConfig(const GPIOISRServiceConfig& config, esp_err_t& err) {
+    if (config.priority > 3 || (config.coreId != tskNO_AFFINITY && (config.coreId < 0 || config.coreId >= portNUM_PROCESSORS))) {
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+    std::lock_guard lock(GPIO::_isrServiceMutex);
+    if (GPIO::_isrServiceInstalled) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    GPIO::_isrServiceConfig = config;
+    err = ESP_OK;
+}
+
+const GPIOISRServiceConfig& ESP32::gpioISRServiceConfig() const {
+    return GPIO::_isrServiceConfig;
+}
+
+GPIOBusPtr ESP32::gpioBus(const GPIOBusConfig& config, esp_err_t& err) {
+    // Checked before claiming any pin, so a bad config leaves them all free.
+    if (config.pins.empty() || config.pins.size() > GPIOBus::kMaximumWidth) {
+        ESP_LOGE(_loggingTag, "Invalid bus width: %zu", config.pins.size());
+        err = ESP_ERR_INVALID_ARG;
+        return nullptr;
+    }
+
+    // gpios rejects invalid and repeated pins before configuring any of them.
+    std::vector<GPIOConfig> gpioConfigs;
+    gpioConfigs.reserve(config.pins.size());
+    for (gpio_num_t pin : config.pins) {
+        gpioConfigs.emplace_back(pin, config.mode, config.pullUp, config.pullDown);
+    }
+    std::vector<GPIOPtr> gpios = this->gpios(gpioConfigs, err);
+    if (err != ESP_OK) {
+        return nullptr;
+    }
+
+    GPIOBusPtr bus = std::shared_ptr<GPIOBus>(new GPIOBus(config, std::move(gpios), err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::gpioBus failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return bus;
+}
+
+DedicatedGPIOBundlePtr ESP32::dedicatedGPIOBundle(const DedicatedGPIOBundleConfig& config, esp_err_t& err) {
+    const GPIOMode mode(config.input, config.output, false);
+    std::vector<GPIOPtr> gpios;
+    for (gpio_num_t pin : config.pins) {
+        GPIOPtr gpio = this->gpio(GPIOConfig(pin, mode), err);
+        if (err != ESP_OK) {
+            return nullptr;
+        }
+        gpios.push_back(gpio);
+    }
+
+    DedicatedGPIOBundlePtr bundle = std::shared_ptr<DedicatedGPIOBundle>(new DedicatedGPIOBundle(config, std::move(gpios), err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::dedicatedGPIOBundle failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return bundle;
+}
+
+BitBangSerialPtr ESP32::bitBangSerial(const BitBangSerialConfig& config, esp_err_t& err) {
+    if (config.clock == GPIO_NUM_NC || (config.dataOut == GPIO_NUM_NC && config.dataIn == GPIO_NUM_NC)) {
+        err = ESP_ERR_INVALID_ARG;
+        return nullptr;
+    }
+
+    std::vector<GPIOConfig> gpioConfigs = {GPIOConfig(config.clock, GPIOModeOutput)};
+    if (BitBangSerial::_isHalfDuplex(config)) {
+        gpioConfigs.push_back(GPIOConfig(config.dataOut, GPIOModeInputOutputOpenDrain, PullUp::Enable));
+    } else {
+        if (config.dataOut != GPIO_NUM_NC) {
+            gpioConfigs.push_back(GPIOConfig(config.dataOut, GPIOModeOutput));
+        }
+        if (config.dataIn != GPIO_NUM_NC) {
+            gpioConfigs.push_back(GPIOConfig(config.dataIn, GPIOModeInput));
+        }
+    }
+    std::vector<GPIOPtr> gpios = this->gpios(gpioConfigs, err);
+    if (err != ESP_OK) {
+        return nullptr;
+    }
+
+    BitBangSerialPtr serial = std::shared_ptr<BitBangSerial>(new BitBangSerial(config, std::move(gpios), err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::bitBangSerial failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return serial;
+}
+
 std::expected<TimerPtr, esp_err_t> ESP32::timer(const TimerConfig& config) {
     esp_err_t err = ESP_OK;
     TimerPtr timer = std::shared_ptr<Timer>(new Timer(config, err));
@@ -159,6 +319,178 @@ std::expected<TimerPtr, esp_err_t> ESP32::timer(const TimerConfig& config) {
     return timer;
 }
 
+std::expected<TimerPtr, esp_err_t> ESP32::timer(const TimerConfig& config, TimerFunction function) {
+    std::expected<TimerPtr, esp_err_t> timer = this->timer(config);
+    if (timer) {
+        (*timer)->_function = std::move(function);
+    }
+    return timer;
+}
+
+TimerWheelPtr ESP32::timerWheel(const TimerWheelConfig& config, esp_err_t& err) {
+    TimerWheelPtr wheel = std::shared_ptr<TimerWheel>(new TimerWheel(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::timerWheel failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    std::expected<TimerPtr, esp_err_t> timer = this->timer({
+        .callback = TimerWheel::_onTick,
+        .userInfo = wheel.get(),
+        .dispatchMethod = TimerDispatchMethod::Task,
+        .name = config.name,
+        .skipUnhandledEvents = true,
+    });
+    if (!timer) {
+        err = timer.error();
+        return nullptr;
+    }
+    wheel->_timer = *timer;
+
+    return wheel;
+}
+
+PeriodicClockPtr ESP32::periodicClock(const PeriodicClockConfig& config, esp_err_t& err) {
+    PeriodicClockPtr clock = std::shared_ptr<PeriodicClock>(new PeriodicClock(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::periodicClock failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    std::expected<TimerPtr, esp_err_t> timer = this->timer({
+        .callback = PeriodicClock::_onTimer,
+        .userInfo = clock.get(),
+        .dispatchMethod = TimerDispatchMethod::Task,
+        .name = config.name,
+        .skipUnhandledEvents = false,
+    });
+    if (!timer) {
+        err = timer.error();
+        return nullptr;
+    }
+    clock->_timer = *timer;
+
+    return clock;
+}
+
+PeriodicExecutorPtr ESP32::periodicExecutor(const PeriodicExecutorConfig& config, esp_err_t& err) {
+    PeriodicExecutorConfig executorConfig = config;
+    if (executorConfig.clock == nullptr) {
+        executorConfig.clock = periodicClock({.basePeriod = config.period}, err);
+        if (err != ESP_OK) {
+            return nullptr;
+        }
+    }
+
+    PeriodicExecutorPtr executor = std::shared_ptr<PeriodicExecutor>(new PeriodicExecutor(executorConfig, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::periodicExecutor failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return executor;
+}
+
+GPTimerSchedulerPtr ESP32::gpTimerScheduler(const GPTimerSchedulerConfig& config, esp_err_t& err) {
+    GPTimerSchedulerPtr scheduler = std::shared_ptr<GPTimerScheduler>(new GPTimerScheduler(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::gpTimerScheduler failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return scheduler;
+}
+
+CoroutineExecutorPtr ESP32::coroutineExecutor(const CoroutineExecutorConfig& config, esp_err_t& err) {
+    CoroutineExecutorPtr executor = std::shared_ptr<CoroutineExecutor>(new CoroutineExecutor(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::coroutineExecutor failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    std::expected<TimerPtr, esp_err_t> timer = this->timer({
+        .callback = CoroutineExecutor::_onTimer,
+        .userInfo = executor.get(),
+        .dispatchMethod = config.dispatchMethod,
+        .name = config.taskInfo.name,
+        .skipUnhandledEvents = true,
+    });
+    if (!timer) {
+        err = timer.error();
+        return nullptr;
+    }
+    executor->_timer = *timer;
+
+    return executor;
+}
+
+DebounceGroupPtr ESP32::debounceGroup(const DebounceGroupConfig& config, esp_err_t& err) {
+    DebounceGroupPtr group = std::shared_ptr<DebounceGroup>(new DebounceGroup(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::debounceGroup failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    std::expected<TimerPtr, esp_err_t> timer = this->timer({
+        .callback = DebounceGroup::_onTick,
+        .userInfo = group.get(),
+        .dispatchMethod = TimerDispatchMethod::Task,
+        .name = config.name,
+        .skipUnhandledEvents = true,
+    });
+    if (!timer) {
+        err = timer.error();
+        return nullptr;
+    }
+    group->_timer = *timer;
+
+    return group;
+}
+
+pcnt::PulseCounterPtr ESP32::pulseCounter(const pcnt::PulseCounterConfig& config, esp_err_t& err) {
+    pcnt::PulseCounterPtr counter = std::shared_ptr<pcnt::PulseCounter>(new pcnt::PulseCounter(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::pulseCounter failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return counter;
+}
+
+GPIOInterruptDispatcherPtr ESP32::gpioInterruptDispatcher(const GPIOInterruptDispatcherConfig& config, esp_err_t& err) {
+    GPIOInterruptDispatcherPtr dispatcher = std::shared_ptr<GPIOInterruptDispatcher>(new GPIOInterruptDispatcher(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::gpioInterruptDispatcher failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return dispatcher;
+}
+
+GPIOFastInterruptsPtr ESP32::gpioFastInterrupts(const GPIOFastInterruptsConfig& config, esp_err_t& err) {
+    if (!_gpioFastInterrupts.expired()) {
+        err = ESP_ERR_INVALID_STATE;
+        return nullptr;
+    }
+    for (const std::weak_ptr<GPIO>& weakGPIO : _gpios) {
+        GPIOPtr gpio = weakGPIO.lock();
+        if (gpio != nullptr && (gpio->interruptType() != GPIOInteruptType::Disable || gpio->_capturing)) {
+            ESP_LOGE(_loggingTag, "GPIO %u still uses the ISR service", gpio->config().gpioNum);
+            err = ESP_ERR_INVALID_STATE;
+            return nullptr;
+        }
+    }
+
+    GPIOFastInterruptsPtr interrupts = std::shared_ptr<GPIOFastInterrupts>(new GPIOFastInterrupts(config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "ESP32::gpioFastInterrupts failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+    _gpioFastInterrupts = interrupts;
+
+    return interrupts;
+}
+
 std::pair<adc_unit_t, adc_channel_t> ESP32::adcChannelForGPIO(gpio_num_t gpio, esp_err_t& err) {
     adc_unit_t unit = ADC_UNIT_1;
     adc_channel_t channel = ADC_CHANNEL_0;
@@ -6,11 +6,24 @@
  */
 
 #include "GPIO.hpp"
+#include "GPIOInterruptDispatcher.hpp"
 
+#include <esp_attr.h>
+#include <esp_cpu.h>
 #include <esp_log.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+#include <soc/soc_caps.h>
+
+#include <algorithm>
+#include <bit>
 
 using namespace esp;
 
+ESP_EVENT_DEFINE_BASE(esp::GPIO_INTERRUPT_BUDGET_EVENT);
+
 namespace esp {
     bool operator==(const GPIOMode& a, const GPIOMode& b) {
         return a.input() == b.input() && a.output() == b.output() && a.openDrain() == b.openDrain();
@@ -37,12 +50,49 @@ namespace esp {
         }
     }
 
+    static IRAM_ATTR Level inputLevel(gpio_num_t gpioNum) {
+        const uint32_t pin = static_cast<uint32_t>(gpioNum);
+#if SOC_GPIO_PIN_COUNT > 32
+        const uint32_t levels = pin < 32 ? REG_READ(GPIO_IN_REG) : REG_READ(GPIO_IN1_REG);
+#else
+        const uint32_t levels = REG_READ(GPIO_IN_REG);
+#endif
+        return ((levels >> (pin % 32)) & 1) != 0 ? Level::High : Level::Low;
+    }
+
     void _interruptHandler(void* arg) {
         auto& [gpio, userInfo] = *reinterpret_cast<std::pair<GPIO*, void*>*>(arg);
+        if (!gpio->_admitInterrupt()) {
+            return;
+        }
         if (gpio->_interuptCallback) {
             gpio->_interuptCallback(userInfo);
         }
     }
+
+    void IRAM_ATTR _captureInterruptHandler(void* arg) {
+        GPIO* gpio = static_cast<GPIO*>(arg);
+        if (!gpio->_admitInterrupt()) {
+            return;
+        }
+        const uint32_t timestamp = gpio->_captureTimestamp();
+
+        Level level = Level::High;
+        if (gpio->_captureConfig.interuptType == GPIOInteruptType::NegativeEdge) {
+            level = Level::Low;
+        } else if (gpio->_captureConfig.interuptType == GPIOInteruptType::AnyEdge) {
+            level = inputLevel(gpio->_config.gpioNum);
+        }
+        gpio->_recordEdge(GPIOEdge{.timestamp = timestamp, .level = level});
+    }
+
+    void IRAM_ATTR _deferredInterruptHandler(void* arg) {
+        GPIO* gpio = static_cast<GPIO*>(arg);
+        if (!gpio->_admitInterrupt()) {
+            return;
+        }
+        gpio->_dispatcher->_signalFromISR(gpio->_config.gpioNum);
+    }
 }  // namespace esp
 
 GPIO::GPIO(const GPIOConfig& gpioConfig, esp_err_t& err) : _config(gpioConfig) {
@@ -52,31 +102,114 @@ GPIO::GPIO(const GPIOConfig& gpioConfig, esp_err_t& err) : _config(gpioConfig) {
         return;
     }
 
-    gpio_config_t config = {
-        .pin_bit_mask = (1ull << gpioConfig.gpioNum),
-        .mode = gpioConfig.mode.gpioMode(),
-        .pull_up_en = static_cast<gpio_pullup_t>(gpioConfig.pullUp),
-        .pull_down_en = static_cast<gpio_pulldown_t>(gpioConfig.pullDown),
-        .intr_type = static_cast<gpio_int_type_t>(gpioConfig.interuptType),
+    _configure(1ull << gpioConfig.gpioNum, gpioConfig, err);
+}
+
+GPIO::GPIO(const GPIOConfig& gpioConfig) : _config(gpioConfig) {}
+
+void GPIO::_configure(uint64_t pinMask, const GPIOConfig& config, esp_err_t& err) {
+    gpio_config_t gpioConfig = {
+        .pin_bit_mask = pinMask,
+        .mode = config.mode.gpioMode(),
+        .pull_up_en = static_cast<gpio_pullup_t>(config.pullUp),
+        .pull_down_en = static_cast<gpio_pulldown_t>(config.pullDown),
+        .intr_type = static_cast<gpio_int_type_t>(config.interuptType),
     };
-    err = gpio_config(&config);
+    err = gpio_config(&gpioConfig);
     if (err != ESP_OK) {
         ESP_LOGE(_loggingTag, "gpio_config failed: %s", esp_err_to_name(err));
+    }
+}
+
+void GPIO::_installIsrService(esp_err_t& err) {
+    std::lock_guard lock(_isrServiceMutex);
+    err = ESP_OK;
+    if (_isrServiceInstalled) {
         return;
     }
-    static bool isIsrServiceInstalled = false;
-    if (!isIsrServiceInstalled) {
-        err = gpio_install_isr_service(ESP_INTR_FLAG_LOWMED | ESP_INTR_FLAG_EDGE);
-        if (err != ESP_OK) {
-            ESP_LOGE(_loggingTag, "gpio_install_isr_service failed: %s", esp_err_to_name(err));
-            return;
-        }
-        isIsrServiceInstalled = true;
+    if (_isrServiceSuspended) {
+        ESP_LOGE(_loggingTag, "The GPIO interrupt is owned by GPIOFastInterrupts");
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    esp_err_t installErr = ESP_OK;
+    _runOnCore(
+        _isrServiceConfig.coreId,
+        [](void* arg) {
+            const int level = _isrServiceConfig.priority == 0 ? ESP_INTR_FLAG_LOWMED : (1 << _isrServiceConfig.priority);
+            *static_cast<esp_err_t*>(arg) = gpio_install_isr_service(_isrServiceConfig.interruptFlags | level);
+        },
+        &installErr, err);
+    if (err == ESP_OK) {
+        err = installErr;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_install_isr_service failed: %s", esp_err_to_name(err));
+        return;
+    }
+    _isrServiceInstalled = true;
+}
+
+void GPIO::_runOnCore(BaseType_t coreId, void (*function)(void* arg), void* arg, esp_err_t& err) {
+    err = ESP_OK;
+    if (coreId == tskNO_AFFINITY) {
+        function(arg);
+        return;
+    }
+
+    struct Call {
+        void (*function)(void* arg);
+        void* arg;
+        TaskHandle_t caller;
+    } call = {function, arg, xTaskGetCurrentTaskHandle()};
+    BaseType_t result = xTaskCreatePinnedToCore(
+        [](void* userInfo) {
+            Call* call = static_cast<Call*>(userInfo);
+            call->function(call->arg);
+            xTaskNotifyGive(call->caller);
+            vTaskDelete(nullptr);
+        },
+        "gpio_run_on_core", 2048, &call, uxTaskPriorityGet(nullptr), nullptr, coreId);
+    if (result != pdPASS) {
+        ESP_LOGE(_loggingTag, "xTaskCreatePinnedToCore failed");
+        err = ESP_ERR_NO_MEM;
+        return;
     }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+void GPIO::_uninstallIsrService() {
+    std::lock_guard lock(_isrServiceMutex);
+    if (_isrServiceInstalled) {
+        gpio_uninstall_isr_service();
+        _isrServiceInstalled = false;
+    }
+}
+
+void GPIO::_suspendIsrService(bool suspend) {
+    std::lock_guard lock(_isrServiceMutex);
+    if (suspend && _isrServiceInstalled) {
+        gpio_uninstall_isr_service();
+        _isrServiceInstalled = false;
+    }
+    _isrServiceSuspended = suspend;
 }
 
 GPIO::~GPIO() {
     esp_err_t err = ESP_OK;
+    if (_coolDownTimer != nullptr) {
+        esp_timer_stop(_coolDownTimer);
+        esp_timer_delete(_coolDownTimer);
+    }
+    if (_capturing) {
+        stopCapture(err);
+    }
+    if (_dispatcher) {
+        gpio_isr_handler_remove(_config.gpioNum);
+        _removeDispatcher();
+    }
+
     err = gpio_reset_pin(_config.gpioNum);
     if (err != ESP_OK) {
         ESP_LOGE(_loggingTag, "gpio_reset_pin failed: %s", esp_err_to_name(err));
@@ -89,16 +222,8 @@ const GPIOConfig& GPIO::config() const {
 }
 
 void GPIO::setConfig(const GPIOConfig& config, esp_err_t& err) {
-    gpio_config_t gpioConfig = {
-        .pin_bit_mask = (1ull << config.gpioNum),
-        .mode = config.mode.gpioMode(),
-        .pull_up_en = static_cast<gpio_pullup_t>(config.pullUp),
-        .pull_down_en = static_cast<gpio_pulldown_t>(config.pullDown),
-        .intr_type = static_cast<gpio_int_type_t>(config.interuptType),
-    };
-    err = gpio_config(&gpioConfig);
+    _configure(1ull << config.gpioNum, config, err);
     if (err != ESP_OK) {
-        ESP_LOGE(_loggingTag, "gpio_config failed: %s", esp_err_to_name(err));
         return;
     }
 
@@ -157,12 +282,26 @@ GPIOInteruptType GPIO::interruptType() const {
 }
 
 void GPIO::setInterrupt(GPIOInteruptType type, GPIOInteruptCallback callback, void* userInfo, esp_err_t& err) {
+    if (_capturing) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
     if (type == GPIOInteruptType::Disable) {
-        err = gpio_isr_handler_remove(_config.gpioNum);
+        // Nothing can have been registered before the service was installed.
+        {
+            std::lock_guard lock(_isrServiceMutex);
+            err = _isrServiceInstalled ? gpio_isr_handler_remove(_config.gpioNum) : ESP_OK;
+        }
         if (err != ESP_OK) {
             ESP_LOGE(_loggingTag, "gpio_isr_del_handler failed: %s", esp_err_to_name(err));
             return;
         }
+        _removeDispatcher();
+        if (_throttled) {
+            esp_timer_stop(_coolDownTimer);
+            _throttled = false;
+        }
 
         err = gpio_intr_disable(_config.gpioNum);
         if (err != ESP_OK) {
@@ -175,6 +314,11 @@ void GPIO::setInterrupt(GPIOInteruptType type, GPIOInteruptCallback callback, vo
         return;
     }
 
+    _installIsrService(err);
+    if (err != ESP_OK) {
+        return;
+    }
+
     err = gpio_set_intr_type(_config.gpioNum, static_cast<gpio_int_type_t>(type));
     if (err != ESP_OK) {
         ESP_LOGE(_loggingTag, "gpio_set_intr_type failed: %s", esp_err_to_name(err));
@@ -186,6 +330,7 @@ void GPIO::setInterrupt(GPIOInteruptType type, GPIOInteruptCallback callback, vo
         ESP_LOGE(_loggingTag, "gpio_isr_del_handler failed: %s", esp_err_to_name(err));
         return;
     }
+    _removeDispatcher();
 
     _interuptCallback = callback;
     _userInfo = std::make_pair(this, userInfo);
@@ -204,6 +349,209 @@ void GPIO::setInterrupt(GPIOInteruptType type, GPIOInteruptCallback callback, vo
     _config.interuptType = type;
 }
 
+void GPIO::setDeferredInterrupt(GPIOInteruptType type, GPIOInterruptDispatcherPtr dispatcher, GPIODeferredInterruptCallback callback,
+                                void* userInfo, esp_err_t& err) {
+    if (type == GPIOInteruptType::Disable) {
+        setInterrupt(type, nullptr, nullptr, err);
+        return;
+    }
+    if (_capturing) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+    if (!dispatcher || callback == nullptr) {
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _installIsrService(err);
+    if (err != ESP_OK) {
+        return;
+    }
+
+    err = gpio_set_intr_type(_config.gpioNum, static_cast<gpio_int_type_t>(type));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_set_intr_type failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    err = gpio_isr_handler_remove(_config.gpioNum);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_isr_del_handler failed: %s", esp_err_to_name(err));
+        return;
+    }
+    _removeDispatcher();
+
+    _interuptCallback = nullptr;
+    dispatcher->_add(this, callback, userInfo);
+    _dispatcher = dispatcher;
+    err = gpio_isr_handler_add(_config.gpioNum, esp::_deferredInterruptHandler, this);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_isr_handler_add failed: %s", esp_err_to_name(err));
+        _removeDispatcher();
+        return;
+    }
+
+    err = gpio_intr_enable(_config.gpioNum);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_intr_enable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _config.interuptType = type;
+}
+
+void GPIO::_removeDispatcher() {
+    if (_dispatcher) {
+        _dispatcher->_remove(this);
+        _dispatcher = nullptr;
+    }
+}
+
+void GPIO::setInterruptBudget(const GPIOInterruptBudget& budget, esp_err_t& err) {
+    if (budget.maxEdges != 0 && (budget.window.count() <= 0 || budget.coolDown.count() <= 0)) {
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    if (budget.maxEdges != 0 && _coolDownTimer == nullptr) {
+        const esp_timer_create_args_t timerArgs = {
+            .callback = _onCoolDown,
+            .arg = this,
+            .dispatch_method = ESP_TIMER_TASK,
+            .name = "gpio_cool_down",
+            .skip_unhandled_events = true,
+        };
+        err = esp_timer_create(&timerArgs, &_coolDownTimer);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "esp_timer_create failed: %s", esp_err_to_name(err));
+            return;
+        }
+    }
+
+    GPIOInterruptBudget interruptBudget = budget;
+    if (interruptBudget.eventLoop == nullptr) {
+        interruptBudget.eventLoop = EventLoop::defaultEventLoop();
+    }
+    _eventPin = _config.gpioNum;
+
+    portENTER_CRITICAL(&_budgetLock);
+    _budgetMaxEdges.store(interruptBudget.maxEdges, std::memory_order_relaxed);
+    _budgetWindow = interruptBudget.window.count();
+    _budgetCoolDown = interruptBudget.coolDown.count();
+    _budgetEventLoop = interruptBudget.eventLoop->handle();
+    _windowStart = esp_timer_get_time();
+    _windowEdges = 0;
+    portEXIT_CRITICAL(&_budgetLock);
+
+    // Only once the ISR has the new loop, as this may release the old one.
+    _interruptBudget = std::move(interruptBudget);
+    err = ESP_OK;
+}
+
+bool IRAM_ATTR GPIO::_admitInterrupt() {
+    if (_budgetMaxEdges.load(std::memory_order_relaxed) == 0) {
+        return true;
+    }
+
+    portENTER_CRITICAL_ISR(&_budgetLock);
+    // Removed since the check above.
+    const uint32_t maxEdges = _budgetMaxEdges.load(std::memory_order_relaxed);
+    if (maxEdges == 0) {
+        portEXIT_CRITICAL_ISR(&_budgetLock);
+        return true;
+    }
+    // An edge that raced the interrupt being disabled.
+    if (_throttled.load(std::memory_order_relaxed)) {
+        portEXIT_CRITICAL_ISR(&_budgetLock);
+        return false;
+    }
+
+    const int64_t now = esp_timer_get_time();
+    if (now - _windowStart >= _budgetWindow) {
+        _windowStart = now;
+        _windowEdges = 0;
+    }
+    if (++_windowEdges <= maxEdges) {
+        portEXIT_CRITICAL_ISR(&_budgetLock);
+        return true;
+    }
+
+    // Nothing here logs or blocks, so the driver's own wrappers are called rather than esp::Timer and EventLoop.
+    gpio_intr_disable(_config.gpioNum);
+    _throttledLevel = inputLevel(_config.gpioNum);
+    _throttled = true;
+    _throttles.fetch_add(1, std::memory_order_relaxed);
+    esp_timer_start_once(_coolDownTimer, _budgetCoolDown);
+
+    // Posted under the lock, so setInterruptBudget can't release the loop in between.
+    BaseType_t taskAwoken = pdFALSE;
+    const int32_t eventId = static_cast<int32_t>(GPIOInterruptBudgetEvent::Throttled);
+    esp_err_t err = ESP_OK;
+    if (_budgetEventLoop == nullptr) {
+        err = esp_event_isr_post(GPIO_INTERRUPT_BUDGET_EVENT, eventId, &_eventPin, sizeof(_eventPin), &taskAwoken);
+    } else {
+        err = esp_event_isr_post_to(_budgetEventLoop, GPIO_INTERRUPT_BUDGET_EVENT, eventId, &_eventPin, sizeof(_eventPin), &taskAwoken);
+    }
+    portEXIT_CRITICAL_ISR(&_budgetLock);
+    if (err != ESP_OK) {
+        _failedBudgetEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+    portYIELD_FROM_ISR(taskAwoken);
+    return false;
+}
+
+void GPIO::_onCoolDown(void* userInfo) {
+    GPIO* gpio = static_cast<GPIO*>(userInfo);
+    if (!gpio->_throttled) {
+        return;
+    }
+
+    portENTER_CRITICAL(&gpio->_budgetLock);
+    const Level throttledLevel = gpio->_throttledLevel;
+    gpio->_windowStart = esp_timer_get_time();
+    gpio->_windowEdges = 0;
+    portEXIT_CRITICAL(&gpio->_budgetLock);
+
+    // Before enabling the interrupt, so the ISR can't deliver alongside it.
+    const Level level = inputLevel(gpio->_config.gpioNum);
+    if (level != throttledLevel) {
+        gpio->_deliverMissedEdge(level);
+    }
+
+    gpio->_throttled = false;
+    if (gpio->_config.interuptType != GPIOInteruptType::Disable || gpio->_capturing) {
+        esp_err_t err = gpio_intr_enable(gpio->_config.gpioNum);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "gpio_intr_enable failed: %s", esp_err_to_name(err));
+        }
+    }
+
+    // Without waiting, as this runs on the esp_timer task every other timer shares.
+    esp_err_t err = ESP_OK;
+    gpio->_interruptBudget.eventLoop->postEvent(GPIO_INTERRUPT_BUDGET_EVENT, static_cast<int32_t>(GPIOInterruptBudgetEvent::Restored),
+                                                &gpio->_eventPin, 0, err);
+    if (err != ESP_OK) {
+        gpio->_failedBudgetEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void GPIO::_deliverMissedEdge(Level level) {
+    const GPIOInteruptType type = _capturing ? _captureConfig.interuptType : _config.interuptType;
+    const bool caught = type == GPIOInteruptType::AnyEdge || (type == GPIOInteruptType::PositiveEdge && level == Level::High) ||
+                        (type == GPIOInteruptType::NegativeEdge && level == Level::Low);
+    if (!caught) {
+        return;
+    }
+
+    if (_capturing) {
+        // The ISR is disabled, leaving this the ring's only producer.
+        _recordEdge(GPIOEdge{.timestamp = _captureTimestamp(), .level = level});
+    } else if (_dispatcher) {
+        _dispatcher->_signal(_config.gpioNum);
+    }
+}
+
 bool GPIO::level() {
     uint32_t level = gpio_get_level(_config.gpioNum);
     return level != 0;
@@ -216,3 +564,159 @@ void GPIO::setLevel(Level level, esp_err_t& err) {
         return;
     }
 }
+
+void GPIO::startCapture(const GPIOCaptureConfig& config, esp_err_t& err) {
+    if (_capturing || _config.interuptType != GPIOInteruptType::Disable) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    const bool edgeTriggered = config.interuptType == GPIOInteruptType::AnyEdge || config.interuptType == GPIOInteruptType::PositiveEdge ||
+                               config.interuptType == GPIOInteruptType::NegativeEdge;
+    if (!edgeTriggered || config.capacity == 0 || config.capacity > (1u << 31)) {
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _installIsrService(err);
+    if (err != ESP_OK) {
+        return;
+    }
+
+    const size_t capacity = std::bit_ceil(config.capacity);
+    _captureConfig = config;
+    _edges = std::make_unique<GPIOEdge[]>(capacity);
+    _edgeMask = static_cast<uint32_t>(capacity - 1);
+    _edgeHead.store(0, std::memory_order_relaxed);
+    _edgeTail.store(0, std::memory_order_relaxed);
+    _droppedEdges.store(0, std::memory_order_relaxed);
+    _lastEdge.reset();
+    _lastRise.reset();
+    _highWidth.reset();
+    _lowWidth.reset();
+    _period.reset();
+
+    err = gpio_set_intr_type(_config.gpioNum, static_cast<gpio_int_type_t>(config.interuptType));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_set_intr_type failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    err = gpio_isr_handler_add(_config.gpioNum, esp::_captureInterruptHandler, this);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_isr_handler_add failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    err = gpio_intr_enable(_config.gpioNum);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_intr_enable failed: %s", esp_err_to_name(err));
+        gpio_isr_handler_remove(_config.gpioNum);
+        return;
+    }
+
+    _capturing = true;
+}
+
+void GPIO::stopCapture(esp_err_t& err) {
+    if (!_capturing) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    err = gpio_intr_disable(_config.gpioNum);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_intr_disable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    err = gpio_isr_handler_remove(_config.gpioNum);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_isr_handler_remove failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    // Edges already captured stay readable.
+    _capturing = false;
+}
+
+size_t GPIO::readEdges(std::span<GPIOEdge> edges) {
+    if (_edges == nullptr) {
+        return 0;
+    }
+
+    const uint32_t tail = _edgeTail.load(std::memory_order_relaxed);
+    const uint32_t available = _edgeHead.load(std::memory_order_acquire) - tail;
+    const size_t count = std::min<size_t>(available, edges.size());
+    for (size_t i = 0; i < count; i++) {
+        edges[i] = _edges[(tail + i) & _edgeMask];
+    }
+    _edgeTail.store(tail + static_cast<uint32_t>(count), std::memory_order_release);
+    return count;
+}
+
+std::optional<std::chrono::nanoseconds> GPIO::pulseWidth(Level level) {
+    _updateMeasurements();
+    const std::optional<uint32_t>& width = level == Level::High ? _highWidth : _lowWidth;
+    if (!width) {
+        return std::nullopt;
+    }
+    return _captureDuration(*width);
+}
+
+std::optional<std::chrono::nanoseconds> GPIO::period() {
+    _updateMeasurements();
+    if (!_period) {
+        return std::nullopt;
+    }
+    return _captureDuration(*_period);
+}
+
+std::optional<float> GPIO::frequencyHz() {
+    std::optional<std::chrono::nanoseconds> currentPeriod = period();
+    if (!currentPeriod || currentPeriod->count() == 0) {
+        return std::nullopt;
+    }
+    return 1e9f / static_cast<float>(currentPeriod->count());
+}
+
+void GPIO::_updateMeasurements() {
+    GPIOEdge edges[16];
+    size_t count = 0;
+    while ((count = readEdges(edges)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            const GPIOEdge& edge = edges[i];
+            if (_lastEdge && _lastEdge->level != edge.level) {
+                (_lastEdge->level == Level::High ? _highWidth : _lowWidth) = edge.timestamp - _lastEdge->timestamp;
+            }
+            if (edge.level == Level::High) {
+                if (_lastRise) {
+                    _period = edge.timestamp - *_lastRise;
+                }
+                _lastRise = edge.timestamp;
+            }
+            _lastEdge = edge;
+        }
+    }
+}
+
+uint32_t IRAM_ATTR GPIO::_captureTimestamp() const {
+    return _captureConfig.timestampSource == GPIOTimestampSource::CPUCycles ? esp_cpu_get_cycle_count() : static_cast<uint32_t>(esp_timer_get_time());
+}
+
+void IRAM_ATTR GPIO::_recordEdge(const GPIOEdge& edge) {
+    const uint32_t head = _edgeHead.load(std::memory_order_relaxed);
+    if (head - _edgeTail.load(std::memory_order_acquire) > _edgeMask) {
+        _droppedEdges.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    _edges[head & _edgeMask] = edge;
+    _edgeHead.store(head + 1, std::memory_order_release);
+}
+
+std::chrono::nanoseconds GPIO::_captureDuration(uint32_t ticks) const {
+    if (_captureConfig.timestampSource == GPIOTimestampSource::Microseconds) {
+        return std::chrono::microseconds(ticks);
+    }
+    return std::chrono::nanoseconds(static_cast<uint64_t>(ticks) * 1000 / esp_rom_get_cpu_ticks_per_us());
+}
@@ -0,0 +1,27 @@
+#include "GPIOBus.hpp"
+
+#include <esp_log.h>
+
+using namespace esp;
+
+GPIOBus::GPIOBus(const GPIOBusConfig& config, std::vector<GPIOPtr> gpios, esp_err_t& err) : _config(config), _gpios(std::move(gpios)) {
+    if (config.pins.empty() || config.pins.size() > kMaximumWidth) {
+        ESP_LOGE(_loggingTag, "Invalid bus width: %zu", config.pins.size());
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _widthMask = config.pins.size() == kMaximumWidth ? UINT32_MAX : (1u << config.pins.size()) - 1;
+    _contiguous = true;
+    for (size_t i = 0; i < config.pins.size(); i++) {
+        const uint32_t pin = static_cast<uint32_t>(config.pins[i]);
+        _banks[i] = static_cast<uint8_t>(pin / 32);
+        _bankMasks[i] = 1u << (pin % 32);
+        _usesBank[_banks[i]] = true;
+        if (i > 0 && static_cast<uint32_t>(config.pins[i - 1]) + 1 != pin) {
+            _contiguous = false;
+        }
+    }
+    _contiguous = _contiguous && _banks[0] == _banks[config.pins.size() - 1];
+    _shift = static_cast<uint8_t>(config.pins[0] % 32);
+}
@@ -0,0 +1,152 @@
+#include "GPIOFastInterrupts.hpp"
+
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <soc/gpio_reg.h>
+#include <soc/soc.h>
+
+#include <bit>
+
+using namespace esp;
+
+GPIOFastInterrupts::GPIOFastInterrupts(const GPIOFastInterruptsConfig& config, esp_err_t& err) : _config(config) {
+    GPIO::_suspendIsrService(true);
+
+    GPIO::_runOnCore(
+        config.coreId,
+        [](void* arg) {
+            GPIOFastInterrupts* interrupts = static_cast<GPIOFastInterrupts*>(arg);
+            interrupts->_register(interrupts->_registerErr);
+        },
+        this, err);
+    if (err == ESP_OK) {
+        err = _registerErr;
+    }
+}
+
+GPIOFastInterrupts::~GPIOFastInterrupts() {
+    for (GPIOPtr gpio : _gpios) {
+        if (gpio != nullptr) {
+            esp_err_t err = ESP_OK;
+            detach(gpio, err);
+        }
+    }
+
+    if (_handle != nullptr) {
+        esp_err_t err = esp_intr_free(_handle);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "esp_intr_free failed: %s", esp_err_to_name(err));
+        }
+    }
+
+    // The service is installed again by the next pin to set an interrupt.
+    GPIO::_suspendIsrService(false);
+}
+
+void GPIOFastInterrupts::attach(GPIOPtr gpio, GPIOInteruptType type, GPIOFastInterruptCallback callback, void* userInfo, esp_err_t& err) {
+    const uint32_t pin = static_cast<uint32_t>(gpio->config().gpioNum);
+    if (type == GPIOInteruptType::Disable || callback == nullptr) {
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+    if (gpio->interruptType() != GPIOInteruptType::Disable && _gpios[pin] != gpio) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    err = gpio_set_intr_type(gpio->config().gpioNum, static_cast<gpio_int_type_t>(type));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_set_intr_type failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    // Replacing a callback takes the pin out of dispatch first, so the ISR never sees the new callback with the old userInfo.
+    const uint32_t bit = 1u << (pin % 32);
+    if ((_masks[pin / 32].fetch_and(~bit) & bit) != 0) {
+        _drain();
+    }
+    _entries[pin] = {.callback = callback, .userInfo = userInfo};
+    _gpios[pin] = gpio;
+    _masks[pin / 32].fetch_or(bit);
+    gpio->_config.interuptType = type;
+
+    err = gpio_intr_enable(gpio->config().gpioNum);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_intr_enable failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void GPIOFastInterrupts::detach(GPIOPtr gpio, esp_err_t& err) {
+    const uint32_t pin = static_cast<uint32_t>(gpio->config().gpioNum);
+    if (_gpios[pin] != gpio) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    err = gpio_intr_disable(gpio->config().gpioNum);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_intr_disable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    // Once any dispatch that saw the bit set has finished, the old callback is never running, or called again.
+    _masks[pin / 32].fetch_and(~(1u << (pin % 32)));
+    _drain();
+    _entries[pin] = {};
+    _gpios[pin] = nullptr;
+    gpio->_config.interuptType = GPIOInteruptType::Disable;
+}
+
+void IRAM_ATTR GPIOFastInterrupts::dispatch(uint32_t bank, uint32_t status) {
+    if (status == 0) {
+        return;
+    }
+
+    while (status != 0) {
+        const uint32_t bit = std::countr_zero(status);
+        status &= status - 1;
+        const Entry& entry = _entries[bank * 32 + bit];
+        if (entry.callback != nullptr) {
+            entry.callback(static_cast<gpio_num_t>(bank * 32 + bit), entry.userInfo);
+        }
+    }
+}
+
+void IRAM_ATTR GPIOFastInterrupts::_isr(void* arg) {
+    GPIOFastInterrupts* interrupts = static_cast<GPIOFastInterrupts*>(arg);
+
+    // Sequentially consistent with attach and detach clearing a mask bit, so either the masks read here don't have it, or they
+    // see this dispatch in flight and wait for it.
+    interrupts->_inFlight.fetch_add(1);
+    // Clear before dispatching so an edge during a callback raises the interrupt again.
+    const uint32_t status = REG_READ(GPIO_STATUS_REG) & interrupts->_masks[0].load();
+    REG_WRITE(GPIO_STATUS_W1TC_REG, status);
+#if SOC_GPIO_PIN_COUNT > 32
+    const uint32_t status1 = REG_READ(GPIO_STATUS1_REG) & interrupts->_masks[1].load();
+    REG_WRITE(GPIO_STATUS1_W1TC_REG, status1);
+#endif
+
+    interrupts->dispatch(0, status);
+#if SOC_GPIO_PIN_COUNT > 32
+    interrupts->dispatch(1, status1);
+#endif
+    interrupts->_inFlight.fetch_sub(1, std::memory_order_release);
+}
+
+void IRAM_ATTR GPIOFastInterrupts::_drain() const {
+    if (xPortInIsrContext() && xPortGetCoreID() == _isrCore) {
+        return;
+    }
+    while (_inFlight.load() != 0) {
+    }
+}
+
+void GPIOFastInterrupts::_register(esp_err_t& err) {
+    // Interrupts are allocated on the core that asks for them.
+    _isrCore = xPortGetCoreID();
+    err = gpio_isr_register(_isr, this, _config.interruptFlags, &_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gpio_isr_register failed: %s", esp_err_to_name(err));
+    }
+}
@@ -0,0 +1,157 @@
+#include "GPIOInterruptDispatcher.hpp"
+
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+
+#include <bit>
+
+using namespace esp;
+
+ESP_EVENT_DEFINE_BASE(esp::GPIO_INTERRUPT_DISPATCH_EVENT);
+
+GPIOInterruptDispatcher::GPIOInterruptDispatcher(const GPIOInterruptDispatcherConfig& config, esp_err_t& err) : _config(config) {
+    if (config.taskInfo.has_value() == (config.eventLoop != nullptr)) {
+        ESP_LOGE(_loggingTag, "Exactly one of taskInfo and eventLoop must be given");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    if (config.eventLoop) {
+        _eventLoopHandle = config.eventLoop->handle();
+        _eventHandler = config.eventLoop->registerHandler(
+            GPIO_INTERRUPT_DISPATCH_EVENT, 0, [this](esp_event_base_t, int32_t, void*) { _drain(); }, err);
+        return;
+    }
+
+    _running = true;
+    const TaskInfo& taskInfo = *config.taskInfo;
+    BaseType_t result =
+        xTaskCreatePinnedToCore(_dispatchTask, taskInfo.name.c_str(), taskInfo.stackSize, this, taskInfo.priority, &_task, taskInfo.coreId);
+    if (result != pdPASS) {
+        ESP_LOGE(_loggingTag, "xTaskCreatePinnedToCore failed");
+        _running = false;
+        err = ESP_ERR_NO_MEM;
+        return;
+    }
+}
+
+GPIOInterruptDispatcher::~GPIOInterruptDispatcher() {
+    if (_running) {
+        _stoppingTask = xTaskGetCurrentTaskHandle();
+        _running = false;
+        xTaskNotifyGive(_task);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+void GPIOInterruptDispatcher::_add(GPIO* gpio, GPIODeferredInterruptCallback callback, void* userInfo) {
+    std::lock_guard<std::recursive_mutex> lock(_pinsMutex);
+    Pin& pin = _pins[gpio->config().gpioNum];
+    pin.gpio = gpio;
+    pin.callback = callback;
+    pin.userInfo = userInfo;
+    pin.edges.store(0, std::memory_order_relaxed);
+}
+
+void GPIOInterruptDispatcher::_remove(GPIO* gpio) {
+    std::lock_guard<std::recursive_mutex> lock(_pinsMutex);
+    const uint32_t pinNum = static_cast<uint32_t>(gpio->config().gpioNum);
+    _pending[pinNum / 32].fetch_and(~(1u << (pinNum % 32)), std::memory_order_relaxed);
+    _pins[pinNum].gpio = nullptr;
+    _pins[pinNum].callback = nullptr;
+    _pins[pinNum].userInfo = nullptr;
+}
+
+bool IRAM_ATTR GPIOInterruptDispatcher::_markPending(gpio_num_t pinNum) {
+    Pin& pin = _pins[pinNum];
+    pin.lastEdgeTime.store(static_cast<uint32_t>(esp_timer_get_time()), std::memory_order_relaxed);
+    pin.edges.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t bank = static_cast<uint32_t>(pinNum) / 32;
+    const uint32_t previous = _pending[bank].fetch_or(1u << (pinNum % 32), std::memory_order_release);
+
+    // Something else already pending in this bank means the dispatcher has been woken and hasn't drained it yet.
+    return previous == 0 || _wakeFailed.load(std::memory_order_relaxed);
+}
+
+void GPIOInterruptDispatcher::_signal(gpio_num_t pinNum) {
+    if (!_markPending(pinNum)) {
+        return;
+    }
+
+    if (_task != nullptr) {
+        xTaskNotifyGive(_task);
+    } else {
+        esp_err_t err = ESP_OK;
+        _config.eventLoop->postEvent(GPIO_INTERRUPT_DISPATCH_EVENT, 0, &_self, portMAX_DELAY, err);
+        if (err != ESP_OK) {
+            _failedWakes.fetch_add(1, std::memory_order_relaxed);
+        }
+        _wakeFailed.store(err != ESP_OK, std::memory_order_relaxed);
+    }
+}
+
+void IRAM_ATTR GPIOInterruptDispatcher::_signalFromISR(gpio_num_t pinNum) {
+    if (!_markPending(pinNum)) {
+        return;
+    }
+
+    BaseType_t taskAwoken = pdFALSE;
+    if (_task != nullptr) {
+        vTaskNotifyGiveFromISR(_task, &taskAwoken);
+    } else {
+        // Posted directly rather than through EventLoop, which logs failures.
+        esp_err_t err = ESP_OK;
+        if (_eventLoopHandle == nullptr) {
+            err = esp_event_isr_post(GPIO_INTERRUPT_DISPATCH_EVENT, 0, &_self, sizeof(_self), &taskAwoken);
+        } else {
+            err = esp_event_isr_post_to(_eventLoopHandle, GPIO_INTERRUPT_DISPATCH_EVENT, 0, &_self, sizeof(_self), &taskAwoken);
+        }
+        if (err != ESP_OK) {
+            _failedWakes.fetch_add(1, std::memory_order_relaxed);
+        }
+        _wakeFailed.store(err != ESP_OK, std::memory_order_relaxed);
+    }
+    portYIELD_FROM_ISR(taskAwoken);
+}
+
+void GPIOInterruptDispatcher::_drain() {
+    std::lock_guard<std::recursive_mutex> lock(_pinsMutex);
+    for (size_t bank = 0; bank < kNumBanks; bank++) {
+        uint32_t pending = _pending[bank].exchange(0, std::memory_order_acquire);
+        while (pending != 0) {
+            const uint32_t bit = std::countr_zero(pending);
+            pending &= pending - 1;
+
+            Pin& pin = _pins[bank * 32 + bit];
+            const uint32_t edges = pin.edges.exchange(0, std::memory_order_relaxed);
+            if (edges == 0 || pin.callback == nullptr) {
+                continue;
+            }
+
+            const int64_t now = esp_timer_get_time();
+            // The ISR only keeps the low 32 bits, which is fine as long as we drain within about 71 minutes of the edge.
+            const uint32_t age = static_cast<uint32_t>(now) - pin.lastEdgeTime.load(std::memory_order_relaxed);
+            const GPIODeferredInterrupt interrupt = {.edges = edges, .lastEdgeTime = std::chrono::microseconds(now - age)};
+            pin.callback(*pin.gpio, interrupt, pin.userInfo);
+        }
+    }
+}
+
+void GPIOInterruptDispatcher::_dispatchTask(void* userInfo) {
+    GPIOInterruptDispatcher* dispatcher = static_cast<GPIOInterruptDispatcher*>(userInfo);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!dispatcher->_running) {
+            break;
+        }
+        dispatcher->_drain();
+    }
+
+    TaskHandle_t stoppingTask = dispatcher->_stoppingTask;
+    if (stoppingTask != nullptr) {
+        xTaskNotifyGive(stoppingTask);
+    }
+    vTaskDelete(nullptr);
+}
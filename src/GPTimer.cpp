@@ -18,16 +18,16 @@ namespace esp {
     }
 }  // namespace esp
 
-GPTimer::GPTimer(const GPTimerConfig& config, void* userInfo, esp_err_t& err) {
+GPTimer::GPTimer(const GPTimerConfig& config, void* userInfo, esp_err_t& err) : _config(config) {
     _callback = config.callback;
 
-    gptimer_config_t timerConfig = {.clk_src = GPTIMER_CLK_SRC_DEFAULT,
-                                    .direction = GPTIMER_COUNT_UP,
-                                    .resolution_hz = 1'000'000,
-                                    .intr_priority = 0,
+    gptimer_config_t timerConfig = {.clk_src = config.clockSource,
+                                    .direction = static_cast<gptimer_count_direction_t>(config.direction),
+                                    .resolution_hz = config.resolutionHz,
+                                    .intr_priority = config.interruptPriority,
                                     .flags = {
-                                        .intr_shared = false,
-                                        .allow_pd = false,
+                                        .intr_shared = config.interruptShared,
+                                        .allow_pd = config.allowPowerDown,
                                     }};
     err = gptimer_new_timer(&timerConfig, &_timer);
     if (err != ESP_OK) {
@@ -43,11 +43,12 @@ GPTimer::GPTimer(const GPTimerConfig& config, void* userInfo, esp_err_t& err) {
         return;
     }
 
-    gptimer_alarm_config_t alarmConfig = {.alarm_count = config.durationMicroseconds, .reload_count = 0, .flags = {.auto_reload_on_alarm = true}};
-    err = gptimer_set_alarm_action(_timer, &alarmConfig);
-    if (err != ESP_OK) {
-        ESP_LOGE(_loggingTag, "gptimer_set_alarm_action failed: %s", esp_err_to_name(err));
-        return;
+    if (config.alarm) {
+        setAlarm(*config.alarm, err);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "gptimer_set_alarm_action failed: %s", esp_err_to_name(err));
+            return;
+        }
     }
 
     err = gptimer_enable(_timer);
@@ -58,6 +59,10 @@ GPTimer::GPTimer(const GPTimerConfig& config, void* userInfo, esp_err_t& err) {
 }
 
 GPTimer::~GPTimer() {
+    if (_timer == nullptr) {
+        return;
+    }
+
     esp_err_t err = ESP_OK;
     err = gptimer_stop(_timer);
     if (err != ESP_OK) {
@@ -75,6 +80,15 @@ GPTimer::~GPTimer() {
     }
 }
 
+uint32_t GPTimer::resolution(esp_err_t& err) const {
+    uint32_t resolution = 0;
+    err = gptimer_get_resolution(_timer, &resolution);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "gptimer_get_resolution failed: %s", esp_err_to_name(err));
+    }
+    return resolution;
+}
+
 void GPTimer::start(esp_err_t& err) {
     err = gptimer_start(_timer);
     if (err != ESP_OK) {
@@ -89,6 +103,26 @@ void GPTimer::stop(esp_err_t& err) {
     }
 }
 
+void GPTimer::setAlarm(const GPTimerAlarm& alarm, esp_err_t& err) {
+    const gptimer_alarm_config_t alarmConfig = {
+        .alarm_count = alarm.alarmCount, .reload_count = alarm.reloadCount, .flags = {.auto_reload_on_alarm = alarm.autoReload}};
+    err = gptimer_set_alarm_action(_timer, &alarmConfig);
+}
+
+void GPTimer::clearAlarm(esp_err_t& err) {
+    err = gptimer_set_alarm_action(_timer, nullptr);
+}
+
+uint64_t GPTimer::count(esp_err_t& err) const {
+    uint64_t count = 0;
+    err = gptimer_get_raw_count(_timer, &count);
+    return count;
+}
+
+void GPTimer::setCount(uint64_t count, esp_err_t& err) {
+    err = gptimer_set_raw_count(_timer, count);
+}
+
 bool GPTimer::onAlarm(const gptimer_alarm_event_data_t& eventData, void* userInfo) {
     if (_callback) {
         return static_cast<bool>(_callback(*this, eventData, userInfo));
@@ -0,0 +1,277 @@
+#include "GPTimerScheduler.hpp"
+
+#include <esp_attr.h>
+#include <esp_log.h>
+
+#include <algorithm>
+#include <utility>
+
+using namespace esp;
+
+GPTimerScheduler::GPTimerScheduler(const GPTimerSchedulerConfig& config, esp_err_t& err) : _config(config) {
+    if (config.capacity == 0 || config.capacity >= kNil) {
+        ESP_LOGE(_loggingTag, "Invalid capacity");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _events = std::make_unique<Event[]>(config.capacity);
+    _heap = std::make_unique<uint32_t[]>(config.capacity);
+    for (uint32_t i = 0; i < config.capacity; i++) {
+        _events[i].nextFree = i + 1 < config.capacity ? i + 1 : kNil;
+    }
+    _freeList = 0;
+
+    const GPTimerConfig timerConfig = {
+        .callback = _onAlarm,
+        .clockSource = config.clockSource,
+        .resolutionHz = config.resolutionHz,
+        .interruptPriority = config.interruptPriority,
+    };
+    _timer = std::make_shared<GPTimer>(timerConfig, this, err);
+    if (err != ESP_OK) {
+        _timer.reset();
+        return;
+    }
+}
+
+GPTimerScheduler::~GPTimerScheduler() {
+    // Before the events go, as the ISR can run until the timer is deleted.
+    _timer.reset();
+}
+
+void GPTimerScheduler::start(esp_err_t& err) {
+    _timer->start(err);
+}
+
+void GPTimerScheduler::stop(esp_err_t& err) {
+    _timer->stop(err);
+}
+
+uint64_t IRAM_ATTR GPTimerScheduler::count() const {
+    return _count();
+}
+
+GPTimerEventHandle IRAM_ATTR GPTimerScheduler::scheduleAt(uint64_t count, GPTimerEventCallback callback, void* userInfo, esp_err_t& err) {
+    portENTER_CRITICAL_SAFE(&_lock);
+    if (_freeList == kNil) {
+        portEXIT_CRITICAL_SAFE(&_lock);
+        err = ESP_ERR_NO_MEM;
+        return {};
+    }
+
+    const uint32_t index = _freeList;
+    Event& event = _events[index];
+    _freeList = event.nextFree;
+    event.nextFree = kNil;
+    event.count = count;
+    event.callback = callback;
+    event.userInfo = userInfo;
+    _push(index);
+
+    if (count <= _count()) {
+        _stats.scheduledLate++;
+    }
+    // An overdue event gets an alarm just ahead of the counter, so it's dispatched by the next ISR.
+    if (_heap[0] == index) {
+        _armNext();
+    }
+    const GPTimerEventHandle handle = {.index = index, .generation = event.generation};
+    portEXIT_CRITICAL_SAFE(&_lock);
+
+    err = ESP_OK;
+    return handle;
+}
+
+GPTimerEventHandle IRAM_ATTR GPTimerScheduler::scheduleAfter(uint64_t ticks, GPTimerEventCallback callback, void* userInfo, esp_err_t& err) {
+    return scheduleAt(_count() + ticks, callback, userInfo, err);
+}
+
+bool IRAM_ATTR GPTimerScheduler::cancel(GPTimerEventHandle handle) {
+    portENTER_CRITICAL_SAFE(&_lock);
+    const bool pending =
+        handle.index < _config.capacity && _events[handle.index].generation == handle.generation && _events[handle.index].heapIndex != kNil;
+    // The alarm is left set, which at worst means an ISR with nothing to dispatch.
+    if (pending) {
+        _remove(_events[handle.index].heapIndex);
+        _free(handle.index);
+    }
+    portEXIT_CRITICAL_SAFE(&_lock);
+    return pending;
+}
+
+size_t GPTimerScheduler::pendingEvents() const {
+    portENTER_CRITICAL(&_lock);
+    const size_t pending = _heapSize;
+    portEXIT_CRITICAL(&_lock);
+    return pending;
+}
+
+GPTimerSchedulerStats GPTimerScheduler::stats() const {
+    portENTER_CRITICAL(&_lock);
+    const GPTimerSchedulerStats stats = _stats;
+    portEXIT_CRITICAL(&_lock);
+    return stats;
+}
+
+void GPTimerScheduler::resetStats() {
+    portENTER_CRITICAL(&_lock);
+    _stats = {};
+    portEXIT_CRITICAL(&_lock);
+}
+
+void GPTimerScheduler::setPort(const GPTimerSchedulerPort& port) {
+    portENTER_CRITICAL(&_lock);
+    _port = port;
+    portEXIT_CRITICAL(&_lock);
+}
+
+bool IRAM_ATTR GPTimerScheduler::fireAlarm() {
+    // Events coming due before the next alarm could be set are dispatched here rather than from another interrupt.
+    bool taskWoken = false;
+    bool armed = false;
+    while (!armed) {
+        taskWoken = _dispatch() || taskWoken;
+        portENTER_CRITICAL_SAFE(&_lock);
+        armed = _armNext();
+        portEXIT_CRITICAL_SAFE(&_lock);
+    }
+    return taskWoken;
+}
+
+uint64_t IRAM_ATTR GPTimerScheduler::_count() const {
+    return _port.count(_port.context);
+}
+
+void IRAM_ATTR GPTimerScheduler::_push(uint32_t index) {
+    const uint32_t position = _heapSize++;
+    _heap[position] = index;
+    _events[index].heapIndex = position;
+    _siftUp(position);
+}
+
+void IRAM_ATTR GPTimerScheduler::_remove(uint32_t heapPosition) {
+    const uint32_t last = _heapSize - 1;
+    const uint32_t index = _heap[heapPosition];
+    if (heapPosition != last) {
+        _swap(heapPosition, last);
+    }
+    _heapSize--;
+    _events[index].heapIndex = kNil;
+
+    if (heapPosition < _heapSize) {
+        _siftDown(heapPosition);
+        _siftUp(heapPosition);
+    }
+}
+
+void IRAM_ATTR GPTimerScheduler::_siftUp(uint32_t heapPosition) {
+    while (heapPosition > 0) {
+        const uint32_t parent = (heapPosition - 1) / 2;
+        if (_events[_heap[parent]].count <= _events[_heap[heapPosition]].count) {
+            break;
+        }
+        _swap(parent, heapPosition);
+        heapPosition = parent;
+    }
+}
+
+void IRAM_ATTR GPTimerScheduler::_siftDown(uint32_t heapPosition) {
+    while (true) {
+        const uint32_t left = 2 * heapPosition + 1;
+        const uint32_t right = left + 1;
+        uint32_t smallest = heapPosition;
+        if (left < _heapSize && _events[_heap[left]].count < _events[_heap[smallest]].count) {
+            smallest = left;
+        }
+        if (right < _heapSize && _events[_heap[right]].count < _events[_heap[smallest]].count) {
+            smallest = right;
+        }
+        if (smallest == heapPosition) {
+            break;
+        }
+        _swap(smallest, heapPosition);
+        heapPosition = smallest;
+    }
+}
+
+void IRAM_ATTR GPTimerScheduler::_swap(uint32_t a, uint32_t b) {
+    std::swap(_heap[a], _heap[b]);
+    _events[_heap[a]].heapIndex = a;
+    _events[_heap[b]].heapIndex = b;
+}
+
+void IRAM_ATTR GPTimerScheduler::_free(uint32_t index) {
+    Event& event = _events[index];
+    event.generation++;
+    event.callback = nullptr;
+    event.userInfo = nullptr;
+    event.nextFree = _freeList;
+    _freeList = index;
+}
+
+bool IRAM_ATTR GPTimerScheduler::_armNext() {
+    if (_heapSize == 0) {
+        return true;
+    }
+
+    // An alarm set for a count the counter has already passed may never fire, so chase the counter with a growing lead until the
+    // alarm lands ahead of it.
+    const uint64_t target = _events[_heap[0]].count;
+    uint64_t lead = kMinimumLead;
+    while (true) {
+        const uint64_t alarm = std::max(target, _count() + lead);
+        _port.setAlarm(_port.context, alarm);
+        const uint64_t now = _count();
+        if (now < alarm) {
+            return now < target;
+        }
+        lead *= 2;
+    }
+}
+
+bool IRAM_ATTR GPTimerScheduler::_dispatch() {
+    bool taskWoken = false;
+    portENTER_CRITICAL_SAFE(&_lock);
+    while (_heapSize > 0) {
+        const uint64_t now = _count();
+        const uint32_t index = _heap[0];
+        const Event event = _events[index];
+        if (event.count > now) {
+            break;
+        }
+
+        _remove(0);
+        _free(index);
+        const uint64_t latency = now - event.count;
+        _stats.dispatched++;
+        _stats.worstLatency = std::max(_stats.worstLatency, latency);
+        _stats.totalLatency += latency;
+
+        // Released so the callback can schedule and cancel events.
+        portEXIT_CRITICAL_SAFE(&_lock);
+        if (event.callback != nullptr && event.callback(*this, event.count, event.userInfo) == InterruptResult::HighPriorityTaskWoken) {
+            taskWoken = true;
+        }
+        portENTER_CRITICAL_SAFE(&_lock);
+    }
+    portEXIT_CRITICAL_SAFE(&_lock);
+    return taskWoken;
+}
+
+InterruptResult IRAM_ATTR GPTimerScheduler::_onAlarm(GPTimer& timer, const gptimer_alarm_event_data_t& eventData, void* userInfo) {
+    (void)timer;
+    (void)eventData;
+    GPTimerScheduler* scheduler = static_cast<GPTimerScheduler*>(userInfo);
+    return scheduler->fireAlarm() ? InterruptResult::HighPriorityTaskWoken : InterruptResult::NoHighPriorityTaskWoken;
+}
+
+uint64_t IRAM_ATTR GPTimerScheduler::_timerCount(void* context) {
+    esp_err_t err = ESP_OK;
+    return static_cast<GPTimerScheduler*>(context)->_timer->count(err);
+}
+
+void IRAM_ATTR GPTimerScheduler::_setTimerAlarm(void* context, uint64_t alarmCount) {
+    esp_err_t err = ESP_OK;
+    static_cast<GPTimerScheduler*>(context)->_timer->setAlarm({.alarmCount = alarmCount, .autoReload = false}, err);
+}
@@ -0,0 +1,50 @@
+#include "PCNT/Channel.hpp"
+
+#include "PCNT/PulseCounter.hpp"
+
+#include <esp_log.h>
+
+using namespace esp;
+using namespace pcnt;
+
+Channel::Channel(PulseCounterPtr unit, const ChannelConfig& config, esp_err_t& err) : _config(config), _unit(unit) {
+    const pcnt_chan_config_t channelConfig = {
+        .edge_gpio_num = config.edgeGPIO,
+        .level_gpio_num = config.levelGPIO,
+        .flags = {.invert_edge_input = config.invertEdgeInput, .invert_level_input = config.invertLevelInput}};
+    err = pcnt_new_channel(unit->_unit, &channelConfig, &_channel);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_new_channel failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+Channel::~Channel() {
+    if (_channel == nullptr) {
+        return;
+    }
+
+    esp_err_t err = pcnt_del_channel(_channel);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_del_channel failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void Channel::setEdgeAction(EdgeAction positive, EdgeAction negative, esp_err_t& err) {
+    err = pcnt_channel_set_edge_action(_channel, static_cast<pcnt_channel_edge_action_t>(positive),
+                                       static_cast<pcnt_channel_edge_action_t>(negative));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_channel_set_edge_action failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void Channel::setLevelAction(LevelAction high, LevelAction low, esp_err_t& err) {
+    err = pcnt_channel_set_level_action(_channel, static_cast<pcnt_channel_level_action_t>(high),
+                                        static_cast<pcnt_channel_level_action_t>(low));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_channel_set_level_action failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
@@ -0,0 +1,302 @@
+#include "PCNT/PulseCounter.hpp"
+
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <hal/pcnt_ll.h>
+#include <soc/soc_caps.h>
+
+#include <mutex>
+
+using namespace esp;
+using namespace pcnt;
+
+namespace esp::pcnt {
+    // Held while probing, so two units being created at once can't see each other's probe watch point.
+    static std::mutex unitProbeMutex;
+
+    bool IRAM_ATTR _onReach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t* eventData, void* userInfo) {
+        PulseCounter* counter = static_cast<PulseCounter*>(userInfo);
+        const int watchPoint = eventData->watch_point_value;
+        const bool limit = watchPoint == counter->_config.lowLimit || watchPoint == counter->_config.highLimit;
+
+        portENTER_CRITICAL_ISR(&counter->_lock);
+        const int64_t extension = counter->_extension() + (limit ? watchPoint : 0);
+        if (limit) {
+            counter->_setExtension(extension);
+        }
+        portEXIT_CRITICAL_ISR(&counter->_lock);
+
+        if (limit || counter->_callback == nullptr) {
+            return false;
+        }
+        return static_cast<bool>(counter->_callback(watchPoint, extension + watchPoint, counter->_userInfo));
+    }
+}  // namespace esp::pcnt
+
+PulseCounter::PulseCounter(const PulseCounterConfig& config, esp_err_t& err) : _config(config) {
+    const pcnt_unit_config_t unitConfig = {
+        .low_limit = config.lowLimit,
+        .high_limit = config.highLimit,
+        .intr_priority = config.interruptPriority,
+        .flags = {.accum_count = false}};
+    err = pcnt_new_unit(&unitConfig, &_unit);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_new_unit failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    for (int limit : {config.lowLimit, config.highLimit}) {
+        err = pcnt_unit_add_watch_point(_unit, limit);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "pcnt_unit_add_watch_point failed: %s", esp_err_to_name(err));
+            return;
+        }
+    }
+
+    _findUnitId(err);
+    if (err != ESP_OK) {
+        return;
+    }
+
+    const pcnt_event_callbacks_t callbacks = {.on_reach = _onReach};
+    err = pcnt_unit_register_event_callbacks(_unit, &callbacks, this);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_register_event_callbacks failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void PulseCounter::_findUnitId(esp_err_t& err) {
+    std::lock_guard lock(unitProbeMutex);
+    pcnt_dev_t* hardware = PCNT_LL_GET_HW(0);
+    auto thresholdsHold = [&](uint32_t unit, int value) {
+        return pcnt_ll_get_thres_value(hardware, unit, 0) == value || pcnt_ll_get_thres_value(hardware, unit, 1) == value;
+    };
+
+    // A value strictly between the limits, that isn't 0 and that no unit's thresholds hold yet.
+    int probe = 0;
+    for (int candidate = 1; candidate < _config.highLimit && probe == 0; candidate++) {
+        bool held = false;
+        for (uint32_t unit = 0; unit < SOC_PCNT_UNITS_PER_GROUP; unit++) {
+            held = held || thresholdsHold(unit, candidate);
+        }
+        probe = held ? 0 : candidate;
+    }
+    if (probe == 0) {
+        ESP_LOGE(_loggingTag, "No watch point free to find the unit with");
+        err = ESP_ERR_NOT_SUPPORTED;
+        return;
+    }
+
+    err = pcnt_unit_add_watch_point(_unit, probe);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_add_watch_point failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    err = ESP_ERR_NOT_FOUND;
+    for (uint32_t unit = 0; unit < SOC_PCNT_UNITS_PER_GROUP; unit++) {
+        if (thresholdsHold(unit, probe)) {
+            _unitId = unit;
+            err = ESP_OK;
+        }
+    }
+
+    const esp_err_t removeErr = pcnt_unit_remove_watch_point(_unit, probe);
+    if (removeErr != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_remove_watch_point failed: %s", esp_err_to_name(removeErr));
+        err = removeErr;
+        return;
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "Unit not found by its probe watch point");
+    }
+}
+
+PulseCounter::~PulseCounter() {
+    if (_unit == nullptr) {
+        return;
+    }
+
+    esp_err_t err = ESP_OK;
+    disable(err);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt::PulseCounter::disable failed: %s", esp_err_to_name(err));
+    }
+
+    err = pcnt_del_unit(_unit);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_del_unit failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+ChannelPtr PulseCounter::addChannel(const ChannelConfig& config, esp_err_t& err) {
+    // Can't use std::make_shared because we only have access through friendship
+    ChannelPtr channel = std::shared_ptr<Channel>(new Channel(shared_from_this(), config, err));
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt::Channel::Channel failed: %s", esp_err_to_name(err));
+        return nullptr;
+    }
+
+    return channel;
+}
+
+void PulseCounter::setGlitchFilter(uint32_t maxGlitchNs, esp_err_t& err) {
+    if (_enabled) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    const pcnt_glitch_filter_config_t filterConfig = {.max_glitch_ns = maxGlitchNs};
+    err = pcnt_unit_set_glitch_filter(_unit, maxGlitchNs == 0 ? nullptr : &filterConfig);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_set_glitch_filter failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void PulseCounter::addWatchPoint(int watchPoint, esp_err_t& err) {
+    if (watchPoint == _config.lowLimit || watchPoint == _config.highLimit) {
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    err = pcnt_unit_add_watch_point(_unit, watchPoint);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_add_watch_point failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void PulseCounter::removeWatchPoint(int watchPoint, esp_err_t& err) {
+    if (watchPoint == _config.lowLimit || watchPoint == _config.highLimit) {
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    err = pcnt_unit_remove_watch_point(_unit, watchPoint);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_remove_watch_point failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void PulseCounter::setWatchPointCallback(WatchPointCallback callback, void* userInfo, esp_err_t& err) {
+    if (_enabled) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    _callback = callback;
+    _userInfo = userInfo;
+    err = ESP_OK;
+}
+
+void PulseCounter::enable(esp_err_t& err) {
+    if (_enabled) {
+        return;
+    }
+
+    err = pcnt_unit_enable(_unit);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_enable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _enabled = true;
+}
+
+void PulseCounter::disable(esp_err_t& err) {
+    if (!_enabled) {
+        return;
+    }
+
+    err = pcnt_unit_disable(_unit);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_disable failed: %s", esp_err_to_name(err));
+        return;
+    }
+
+    _enabled = false;
+}
+
+void PulseCounter::start(esp_err_t& err) {
+    err = pcnt_unit_start(_unit);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_start failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void PulseCounter::stop(esp_err_t& err) {
+    err = pcnt_unit_stop(_unit);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_stop failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+void PulseCounter::clear(esp_err_t& err) {
+    portENTER_CRITICAL(&_lock);
+    err = pcnt_unit_clear_count(_unit);
+    if (err == ESP_OK) {
+        _setExtension(0);
+    }
+    portEXIT_CRITICAL(&_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "pcnt_unit_clear_count failed: %s", esp_err_to_name(err));
+        return;
+    }
+}
+
+int64_t IRAM_ATTR PulseCounter::position() const {
+    while (true) {
+        const uint32_t sequence = _sequence.load(std::memory_order_acquire);
+        if ((sequence & 1) != 0) {
+            continue;
+        }
+
+        const int64_t extension = _extension();
+        // The count before the interrupt status, so a wrap the count already shows is either still pending or, once handled, has moved
+        // the sequence on.
+        const int count = pcnt_ll_get_count(PCNT_LL_GET_HW(0), _unitId);
+        const int pending = _pendingWrap();
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_sequence.load(std::memory_order_relaxed) == sequence) {
+            return extension + pending + count;
+        }
+    }
+}
+
+int IRAM_ATTR PulseCounter::_pendingWrap() const {
+    pcnt_dev_t* hardware = PCNT_LL_GET_HW(0);
+    if ((pcnt_ll_get_intr_status(hardware) & PCNT_LL_UNIT_WATCH_EVENT(_unitId)) == 0) {
+        return 0;
+    }
+
+    const uint32_t events = pcnt_ll_get_event_status(hardware, _unitId);
+    if ((events & (1u << PCNT_LL_WATCH_EVENT_HIGH_LIMIT)) != 0) {
+        return _config.highLimit;
+    }
+    if ((events & (1u << PCNT_LL_WATCH_EVENT_LOW_LIMIT)) != 0) {
+        return _config.lowLimit;
+    }
+    return 0;
+}
+
+int64_t IRAM_ATTR PulseCounter::_extension() const {
+    const uint64_t high = _extensionHigh.load(std::memory_order_relaxed);
+    return static_cast<int64_t>((high << 32) | _extensionLow.load(std::memory_order_relaxed));
+}
+
+void IRAM_ATTR PulseCounter::_setExtension(int64_t extension) {
+    const uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+    _sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _extensionLow.store(static_cast<uint32_t>(extension), std::memory_order_relaxed);
+    _extensionHigh.store(static_cast<uint32_t>(static_cast<uint64_t>(extension) >> 32), std::memory_order_relaxed);
+    _sequence.store(sequence + 2, std::memory_order_release);
+}
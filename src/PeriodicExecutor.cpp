@@ -0,0 +1,154 @@
+#include "PeriodicExecutor.hpp"
+
+#include <esp_log.h>
+
+#include <algorithm>
+
+using namespace esp;
+
+PeriodicClock::PeriodicClock(const PeriodicClockConfig& config, esp_err_t& err) : _config(config) {
+    if (config.basePeriod.count() <= 0) {
+        ESP_LOGE(_loggingTag, "Invalid base period");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _epoch = Timer::now();
+}
+
+void PeriodicClock::_add(PeriodicExecutor* executor) {
+    std::lock_guard lock(_mutex);
+    _executors.push_back(executor);
+}
+
+void PeriodicClock::_remove(PeriodicExecutor* executor) {
+    std::lock_guard lock(_mutex);
+    std::erase(_executors, executor);
+    _arm();
+}
+
+std::chrono::microseconds PeriodicClock::_alignUp(std::chrono::microseconds time) const {
+    const int64_t base = _config.basePeriod.count();
+    const int64_t periods = (std::max<int64_t>((time - _epoch).count(), 0) + base - 1) / base;
+    return _epoch + std::chrono::microseconds(periods * base);
+}
+
+void PeriodicClock::_arm() {
+    if (_timer == nullptr) {
+        return;
+    }
+
+    std::chrono::microseconds earliest = std::chrono::microseconds::max();
+    for (PeriodicExecutor* executor : _executors) {
+        if (executor->_running) {
+            earliest = std::min(earliest, executor->_deadline);
+        }
+    }
+
+    if (_timer->isActive()) {
+        _timer->stop();
+    }
+    if (earliest != std::chrono::microseconds::max()) {
+        _timer->startOneshot(std::max(earliest - Timer::now(), std::chrono::microseconds(0)));
+    }
+}
+
+void PeriodicClock::_onTimer(Timer& timer, void* userInfo) {
+    (void)timer;
+    PeriodicClock* clock = static_cast<PeriodicClock*>(userInfo);
+    std::lock_guard lock(clock->_mutex);
+
+    // One pass, by index as callbacks can add executors.  Executors still due after it, catching up, are run from the next fire,
+    // which is immediate, so other esp_timer callbacks get a look in between.
+    const std::chrono::microseconds now = Timer::now();
+    for (size_t i = 0; i < clock->_executors.size(); i++) {
+        PeriodicExecutor* executor = clock->_executors[i];
+        if (executor->_running && executor->_deadline <= now) {
+            executor->_run(now);
+        }
+    }
+
+    clock->_arm();
+}
+
+PeriodicExecutor::PeriodicExecutor(const PeriodicExecutorConfig& config, esp_err_t& err) : _config(config) {
+    if (config.callback == nullptr || config.clock == nullptr || config.period.count() <= 0 ||
+        config.period.count() % config.clock->config().basePeriod.count() != 0) {
+        ESP_LOGE(_loggingTag, "Period must be a multiple of the clock's base period");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _config.clock->_add(this);
+}
+
+PeriodicExecutor::~PeriodicExecutor() {
+    if (_config.clock != nullptr) {
+        _config.clock->_remove(this);
+    }
+}
+
+void PeriodicExecutor::start(esp_err_t& err) {
+    std::lock_guard lock(_config.clock->_mutex);
+    if (_running) {
+        err = ESP_ERR_INVALID_STATE;
+        return;
+    }
+
+    _deadline = _config.clock->_alignUp(Timer::now() + _config.period);
+    _running = true;
+    _config.clock->_arm();
+    err = ESP_OK;
+}
+
+void PeriodicExecutor::stop() {
+    std::lock_guard lock(_config.clock->_mutex);
+    _running = false;
+    _config.clock->_arm();
+}
+
+bool PeriodicExecutor::isRunning() const {
+    std::lock_guard lock(_config.clock->_mutex);
+    return _running;
+}
+
+std::chrono::microseconds PeriodicExecutor::nextDeadline() const {
+    std::lock_guard lock(_config.clock->_mutex);
+    return _deadline;
+}
+
+PeriodicExecutorStats PeriodicExecutor::stats() const {
+    std::lock_guard lock(_config.clock->_mutex);
+    return _stats;
+}
+
+void PeriodicExecutor::resetStats() {
+    std::lock_guard lock(_config.clock->_mutex);
+    _stats = {};
+}
+
+void PeriodicExecutor::_run(std::chrono::microseconds now) {
+    const std::chrono::microseconds lateness = now - _deadline;
+    // Later deadlines that have also passed.
+    const uint32_t behind = lateness / _config.period;
+
+    _stats.runs++;
+    _stats.worstLateness = std::max(_stats.worstLateness, lateness);
+
+    uint32_t periods = 1;
+    switch (_config.overrunPolicy) {
+        case OverrunPolicy::CatchUp:
+            _stats.missedDeadlines += behind > 0 ? 1 : 0;
+            _deadline += _config.period;
+            break;
+        case OverrunPolicy::Coalesce:
+            periods = behind + 1;
+            [[fallthrough]];
+        case OverrunPolicy::Skip:
+            _stats.missedDeadlines += behind > 0 ? behind + 1 : 0;
+            _deadline += _config.period * (behind + 1);
+            break;
+    }
+
+    _config.callback(*this, periods, _config.userInfo);
+}
@@ -3,6 +3,10 @@
 #include <esp_log.h>
 #include <esp_timer.h>
 
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
 using namespace esp;
 using namespace std::chrono_literals;
 
@@ -12,9 +16,55 @@ namespace esp {
             auto [timer, userInfo] = *reinterpret_cast<std::pair<Timer*, void*>*>(userData);
             timer->_timerCallback(userInfo);
         }
+
+        struct TimerStatsState {
+            std::string name;
+            bool skipUnhandledEvents = false;
+
+            // Guards everything below, which the callback updates from the esp_timer task or ISR.
+            portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+            TimerStats stats;
+            // When the next fire is due, tracked here as esp_timer only reports the expiry of one shot timers.
+            int64_t scheduled = 0;
+            int64_t period = 0;
+
+            // Registry of live timers collecting stats, guarded by statsMutex.
+            TimerStatsState* previous = nullptr;
+            TimerStatsState* next = nullptr;
+        };
+
+        static std::mutex statsMutex;
+        static TimerStatsState* statsList = nullptr;
     }
 }
 
+void TimerHistogram::record(std::chrono::microseconds value) {
+    const uint64_t micros = std::max<int64_t>(value.count(), 0);
+    const size_t bucket = micros == 0 ? 0 : std::min<size_t>(64 - __builtin_clzll(micros), kBuckets - 1);
+    buckets[bucket]++;
+    min = count == 0 ? value : std::min(min, value);
+    max = count == 0 ? value : std::max(max, value);
+    total += value;
+    count++;
+}
+
+std::chrono::microseconds TimerHistogram::mean() const {
+    return count == 0 ? 0us : total / count;
+}
+
+std::chrono::microseconds TimerHistogram::percentile(float fraction) const {
+    const uint32_t target = std::max<uint32_t>(1, static_cast<uint32_t>(std::ceil(std::clamp(fraction, 0.0f, 1.0f) * count)));
+    uint32_t seen = 0;
+    for (size_t bucket = 0; bucket < kBuckets; bucket++) {
+        seen += buckets[bucket];
+        if (seen >= target) {
+            const std::chrono::microseconds upper((int64_t(1) << bucket) - 1);
+            return std::min(upper, max);
+        }
+    }
+    return max;
+}
+
 std::chrono::microseconds Timer::now() {
     return std::chrono::microseconds(esp_timer_get_time());
 }
@@ -34,11 +84,13 @@ void Timer::requestISRYield() {
 }
 
 Timer::Timer(const TimerConfig& config, esp_err_t& err) {
-    _userInfo = std::make_pair(this, config.userInfo);
+    _userInfo = std::make_unique<std::pair<Timer*, void*>>(this, config.userInfo);
     _callback = config.callback;
+    _dispatchMethod = config.dispatchMethod;
+    _skipUnhandledEvents = config.skipUnhandledEvents;
     esp_timer_create_args_t conf = {
         .callback = esp::priv::timerCallback,
-        .arg = &_userInfo,
+        .arg = _userInfo.get(),
         .dispatch_method = static_cast<esp_timer_dispatch_t>(config.dispatchMethod),
         .name = config.name.c_str(),
         .skip_unhandled_events = config.skipUnhandledEvents
@@ -49,13 +101,35 @@ Timer::Timer(const TimerConfig& config, esp_err_t& err) {
         ESP_LOGE(_loggingTag, "esp_timer_create failed: %s", esp_err_to_name(err));
         return;
     }
+
+    if (config.collectStats) {
+        _stats = std::make_unique<priv::TimerStatsState>();
+        _stats->name = config.name;
+        _stats->skipUnhandledEvents = config.skipUnhandledEvents;
+
+        std::lock_guard lock(priv::statsMutex);
+        _stats->next = priv::statsList;
+        if (priv::statsList != nullptr) {
+            priv::statsList->previous = _stats.get();
+        }
+        priv::statsList = _stats.get();
+    }
 }
 
 Timer::Timer(Timer&& other) {
-    _userInfo = std::make_pair(this, other._userInfo.second);
+    _userInfo = std::move(other._userInfo);
     _callback = other._callback;
+    _function = std::move(other._function);
     _timerHandle = other._timerHandle;
     other._timerHandle = nullptr;
+    _dispatchMethod = other._dispatchMethod;
+    _skipUnhandledEvents = other._skipUnhandledEvents;
+    _stats = std::move(other._stats);
+    _takeSlack(other);
+    // Last, so the callback only finds this timer once everything it uses is here.
+    if (_userInfo != nullptr) {
+        _userInfo->first = this;
+    }
 }
 
 Timer::~Timer() {
@@ -68,15 +142,33 @@ Timer& Timer::operator=(Timer&& other) {
     } 
 
     _teardown();
-    _userInfo = std::make_pair(this, other._userInfo.second);
+    _userInfo = std::move(other._userInfo);
     _callback = other._callback;
+    _function = std::move(other._function);
     _timerHandle = other._timerHandle;
     other._timerHandle = nullptr;
+    _dispatchMethod = other._dispatchMethod;
+    _skipUnhandledEvents = other._skipUnhandledEvents;
+    _stats = std::move(other._stats);
+    _takeSlack(other);
+    // Last, so the callback only finds this timer once everything it uses is here.
+    if (_userInfo != nullptr) {
+        _userInfo->first = this;
+    }
     return *this;
 }
 
-esp_err_t Timer::startOneshot(std::chrono::microseconds duration) {
+esp_err_t Timer::startOneshot(std::chrono::microseconds duration, std::chrono::microseconds slack) {
+    if (slack.count() > 0) {
+        return _startWithSlack(duration, slack, false);
+    }
+
     esp_err_t err = ESP_OK;
+    if (_hasSlack) {
+        _clearSlack();
+    }
+    // Before starting, as a short enough timer can fire before esp_timer_start_once returns.
+    _scheduled(duration, false);
     err = esp_timer_start_once(_timerHandle, duration.count());
     if (err != ESP_OK) {
         ESP_LOGE(_loggingTag, "esp_timer_start_once failed: %s", esp_err_to_name(err));
@@ -86,8 +178,16 @@ esp_err_t Timer::startOneshot(std::chrono::microseconds duration) {
     return err;
 }
 
-esp_err_t Timer::startPeriodic(std::chrono::microseconds duration) {
+esp_err_t Timer::startPeriodic(std::chrono::microseconds duration, std::chrono::microseconds slack) {
+    if (slack.count() > 0) {
+        return _startWithSlack(duration, slack, true);
+    }
+
     esp_err_t err = ESP_OK;
+    if (_hasSlack) {
+        _clearSlack();
+    }
+    _scheduled(duration, true);
     err = esp_timer_start_periodic(_timerHandle, duration.count());
     if (err != ESP_OK) {
         ESP_LOGE(_loggingTag, "esp_timer_start_periodic failed: %s", esp_err_to_name(err));
@@ -98,7 +198,28 @@ esp_err_t Timer::startPeriodic(std::chrono::microseconds duration) {
 }
 
 esp_err_t Timer::restart(std::chrono::microseconds duration) {
+    if (_hasSlack) {
+        portENTER_CRITICAL_SAFE(&_slackLock);
+        if (!_slackArmed) {
+            portEXIT_CRITICAL_SAFE(&_slackLock);
+            return ESP_ERR_INVALID_STATE;
+        }
+
+        _unlinkSlack();
+        esp_timer_stop(_timerHandle);
+        _period = _period != 0 ? duration.count() : 0;
+        _scheduled(duration, _period != 0);
+        const esp_err_t err = _armWithSlack(esp_timer_get_time() + duration.count());
+        portEXIT_CRITICAL_SAFE(&_slackLock);
+        if (err != ESP_OK) {
+            ESP_LOGE(_loggingTag, "esp_timer_start_once failed: %s", esp_err_to_name(err));
+        }
+        return err;
+    }
+
     esp_err_t err = ESP_OK;
+    // Restarting keeps a periodic timer periodic.
+    _scheduled(duration, _stats != nullptr && _stats->period != 0);
     err = esp_timer_restart(_timerHandle, duration.count());
     if (err != ESP_OK) {
         ESP_LOGE(_loggingTag, "esp_timer_restart failed: %s", esp_err_to_name(err));
@@ -110,7 +231,15 @@ esp_err_t Timer::restart(std::chrono::microseconds duration) {
 
 esp_err_t Timer::stop() {
     esp_err_t err = ESP_OK;
-    err = esp_timer_stop(_timerHandle);
+    if (_hasSlack) {
+        // Under the lock, so a periodic fire in progress can't rearm the timer after it's stopped.
+        portENTER_CRITICAL_SAFE(&_slackLock);
+        _unlinkSlack();
+        err = esp_timer_stop(_timerHandle);
+        portEXIT_CRITICAL_SAFE(&_slackLock);
+    } else {
+        err = esp_timer_stop(_timerHandle);
+    }
     if (err != ESP_OK) {
         ESP_LOGE(_loggingTag, "esp_timer_stop failed: %s", esp_err_to_name(err));
         return err;
@@ -120,6 +249,14 @@ esp_err_t Timer::stop() {
 }
 
 std::expected<std::chrono::microseconds, esp_err_t> Timer::duration() const  {
+    // Underneath it's a one shot.
+    if (_hasSlack) {
+        portENTER_CRITICAL_SAFE(&_slackLock);
+        const int64_t period = _period;
+        portEXIT_CRITICAL_SAFE(&_slackLock);
+        return std::chrono::microseconds(period);
+    }
+
     esp_err_t err = ESP_OK;
     uint64_t period;
     err = esp_timer_get_period(_timerHandle, &period);
@@ -147,13 +284,267 @@ bool Timer::isActive() const {
     return esp_timer_is_active(_timerHandle);
 }
 
+std::expected<TimerStats, esp_err_t> Timer::stats() const {
+    if (_stats == nullptr) {
+        return std::unexpected(ESP_ERR_INVALID_STATE);
+    }
+
+    portENTER_CRITICAL(&_stats->lock);
+    const TimerStats stats = _stats->stats;
+    portEXIT_CRITICAL(&_stats->lock);
+    return stats;
+}
+
+void Timer::resetStats() {
+    if (_stats == nullptr) {
+        return;
+    }
+
+    portENTER_CRITICAL(&_stats->lock);
+    _stats->stats = {};
+    portEXIT_CRITICAL(&_stats->lock);
+}
+
+std::vector<std::pair<std::string, TimerStats>> Timer::allStats() {
+    std::vector<std::pair<std::string, TimerStats>> result;
+    std::lock_guard lock(priv::statsMutex);
+    for (priv::TimerStatsState* state = priv::statsList; state != nullptr; state = state->next) {
+        portENTER_CRITICAL(&state->lock);
+        const TimerStats stats = state->stats;
+        portEXIT_CRITICAL(&state->lock);
+        result.emplace_back(state->name, stats);
+    }
+    return result;
+}
+
+void Timer::logStats() {
+    auto micros = [](std::chrono::microseconds value) { return static_cast<long long>(value.count()); };
+    for (const auto& [name, stats] : allStats()) {
+        ESP_LOGI(_loggingTag, "%s: %lu fires, late mean %lld us p99 %lld us max %lld us, ran mean %lld us p99 %lld us max %lld us", name.c_str(),
+                 static_cast<unsigned long>(stats.lateness.count), micros(stats.lateness.mean()), micros(stats.lateness.percentile(0.99f)),
+                 micros(stats.lateness.max), micros(stats.duration.mean()), micros(stats.duration.percentile(0.99f)), micros(stats.duration.max));
+    }
+}
+
+TimerCoalescingStats Timer::coalescingStats() {
+    portENTER_CRITICAL(&_slackLock);
+    const TimerCoalescingStats stats = _coalescingStats;
+    portEXIT_CRITICAL(&_slackLock);
+    return stats;
+}
+
 void Timer::_timerCallback(void* userInfo) {
-    if (_callback != nullptr) {
+    if (_hasSlack) {
+        _onSlackFire();
+    }
+
+    if (_stats == nullptr) {
+        _call(userInfo);
+        return;
+    }
+
+    priv::TimerStatsState& state = *_stats;
+    const int64_t fired = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&state.lock);
+    state.stats.lateness.record(std::chrono::microseconds(fired - state.scheduled));
+    // Follow esp_timer's own rescheduling, before the callback can restart the timer.
+    if (state.period != 0) {
+        const int64_t skipped = (fired - state.scheduled) / state.period;
+        state.scheduled = state.skipUnhandledEvents && skipped > 1 ? fired + state.period : state.scheduled + state.period;
+    }
+    portEXIT_CRITICAL_SAFE(&state.lock);
+
+    _call(userInfo);
+
+    const int64_t finished = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&state.lock);
+    state.stats.duration.record(std::chrono::microseconds(finished - fired));
+    portEXIT_CRITICAL_SAFE(&state.lock);
+}
+
+void Timer::_call(void* userInfo) {
+    if (_function) {
+        _function(*this);
+    } else if (_callback != nullptr) {
         _callback(*this, userInfo);
     }
 }
 
+void Timer::_scheduled(std::chrono::microseconds duration, bool periodic) {
+    if (_stats == nullptr) {
+        return;
+    }
+
+    portENTER_CRITICAL_SAFE(&_stats->lock);
+    _stats->scheduled = esp_timer_get_time() + duration.count();
+    _stats->period = periodic ? duration.count() : 0;
+    portEXIT_CRITICAL_SAFE(&_stats->lock);
+}
+
+esp_err_t Timer::_startWithSlack(std::chrono::microseconds duration, std::chrono::microseconds slack, bool periodic) {
+    // Coalesced timers share the esp_timer task's wakeups, which ISR dispatched timers don't have.
+    if (_dispatchMethod != TimerDispatchMethod::Task) {
+        ESP_LOGE(_loggingTag, "Slack needs Task dispatch");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    portENTER_CRITICAL_SAFE(&_slackLock);
+    if (isActive()) {
+        portEXIT_CRITICAL_SAFE(&_slackLock);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Still linked if it fired but its callback hasn't run yet.
+    _unlinkSlack();
+    _slack = slack;
+    _hasSlack = true;
+    _period = periodic ? duration.count() : 0;
+    _scheduled(duration, periodic);
+    const esp_err_t err = _armWithSlack(esp_timer_get_time() + duration.count());
+    portEXIT_CRITICAL_SAFE(&_slackLock);
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp_timer_start_once failed: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+esp_err_t Timer::_armWithSlack(int64_t deadline) {
+    // The earliest alarm already set inside this timer's window, if any, otherwise as late as the slack allows, leaving the most room
+    // for timers started after it to join.
+    int64_t alarm = deadline + _slack.count();
+    const SlackAlarm* shared = _findSlackAlarm(deadline);
+    if (shared != _slackAlarms.data() + _slackAlarmCount && shared->at <= alarm) {
+        alarm = shared->at;
+    }
+
+    // Not logged, as _slackLock is held.
+    esp_err_t err = ESP_OK;
+    err = esp_timer_start_once(_timerHandle, std::max<int64_t>(alarm - esp_timer_get_time(), 0));
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    _deadline = deadline;
+    _alarm = alarm;
+    _linkSlack();
+    _coalescingStats.arms++;
+    return err;
+}
+
+void Timer::_onSlackFire() {
+    portENTER_CRITICAL_SAFE(&_slackLock);
+    // Stopped as it fired.
+    if (!_slackArmed) {
+        portEXIT_CRITICAL_SAFE(&_slackLock);
+        return;
+    }
+
+    _coalescingStats.fires++;
+    if (_slackIndexed && _findSlackAlarm(_alarm)->fired++ > 0) {
+        _coalescingStats.coalesced++;
+    }
+    _unlinkSlack();
+    esp_err_t err = ESP_OK;
+    if (_period != 0) {
+        // Keep to the deadlines rather than the alarms, so slack doesn't accumulate as drift.
+        const int64_t now = esp_timer_get_time();
+        const int64_t skipped = (now - _deadline) / _period;
+        const int64_t deadline = _skipUnhandledEvents && skipped > 1 ? now + _period : _deadline + _period;
+        err = _armWithSlack(deadline);
+    }
+    portEXIT_CRITICAL_SAFE(&_slackLock);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(_loggingTag, "esp_timer_start_once failed: %s", esp_err_to_name(err));
+    }
+}
+
+void Timer::_clearSlack() {
+    portENTER_CRITICAL_SAFE(&_slackLock);
+    // An armed timer fails to start anyway, and must keep its slack until it's stopped.
+    if (!_slackArmed) {
+        _slack = std::chrono::microseconds(0);
+        _hasSlack = false;
+    }
+    portEXIT_CRITICAL_SAFE(&_slackLock);
+}
+
+void Timer::_linkSlack() {
+    _slackArmed = true;
+    SlackAlarm* entry = _findSlackAlarm(_alarm);
+    SlackAlarm* end = _slackAlarms.data() + _slackAlarmCount;
+    if (entry != end && entry->at == _alarm) {
+        entry->timers++;
+        _slackIndexed = true;
+        return;
+    }
+
+    _slackIndexed = _slackAlarmCount < kSlackAlarms;
+    if (_slackIndexed) {
+        std::move_backward(entry, end, end + 1);
+        *entry = {.at = _alarm, .timers = 1, .fired = 0};
+        _slackAlarmCount++;
+    }
+}
+
+void Timer::_unlinkSlack() {
+    if (!_slackArmed) {
+        return;
+    }
+
+    if (_slackIndexed) {
+        SlackAlarm* entry = _findSlackAlarm(_alarm);
+        if (--entry->timers == 0) {
+            std::move(entry + 1, _slackAlarms.data() + _slackAlarmCount, entry);
+            _slackAlarmCount--;
+        }
+    }
+    _slackArmed = false;
+    _slackIndexed = false;
+}
+
+Timer::SlackAlarm* Timer::_findSlackAlarm(int64_t at) {
+    return std::lower_bound(_slackAlarms.data(), _slackAlarms.data() + _slackAlarmCount, at,
+                            [](const SlackAlarm& alarm, int64_t time) { return alarm.at < time; });
+}
+
+void Timer::_takeSlack(Timer& other) {
+    _hasSlack = other._hasSlack.exchange(false);
+    if (!_hasSlack) {
+        _slack = std::chrono::microseconds(0);
+        return;
+    }
+
+    // The index only holds alarm times, so the moved timer takes over other's place in it as is.
+    portENTER_CRITICAL_SAFE(&_slackLock);
+    _slack = std::exchange(other._slack, std::chrono::microseconds(0));
+    _period = other._period;
+    _deadline = other._deadline;
+    _alarm = other._alarm;
+    _slackArmed = std::exchange(other._slackArmed, false);
+    _slackIndexed = std::exchange(other._slackIndexed, false);
+    portEXIT_CRITICAL_SAFE(&_slackLock);
+}
+
 void Timer::_teardown() {
+    if (_hasSlack) {
+        portENTER_CRITICAL_SAFE(&_slackLock);
+        _unlinkSlack();
+        portEXIT_CRITICAL_SAFE(&_slackLock);
+    }
+
+    if (_stats != nullptr) {
+        std::lock_guard lock(priv::statsMutex);
+        if (_stats->previous != nullptr) {
+            _stats->previous->next = _stats->next;
+        } else {
+            priv::statsList = _stats->next;
+        }
+        if (_stats->next != nullptr) {
+            _stats->next->previous = _stats->previous;
+        }
+    }
+
     if (_timerHandle == nullptr) {
         return;
     }
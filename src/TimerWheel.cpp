@@ -0,0 +1,193 @@
+#include "TimerWheel.hpp"
+
+#include <esp_log.h>
+
+#include <algorithm>
+
+using namespace esp;
+
+TimerWheel::TimerWheel(const TimerWheelConfig& config, esp_err_t& err) : _config(config) {
+    if (config.tick.count() <= 0 || config.capacity == 0 || config.capacity >= kNil) {
+        ESP_LOGE(_loggingTag, "Invalid tick or capacity");
+        err = ESP_ERR_INVALID_ARG;
+        return;
+    }
+
+    _nodes.resize(config.capacity);
+    for (uint32_t i = 0; i < _nodes.size(); i++) {
+        _nodes[i].next = i + 1 < _nodes.size() ? i + 1 : kNil;
+    }
+    _freeList = 0;
+    _lists.fill(kNil);
+}
+
+TimerWheelHandle TimerWheel::start(std::chrono::microseconds duration, TimerWheelCallback callback, void* userInfo, esp_err_t& err) {
+    std::lock_guard lock(_mutex);
+    if (_freeList == kNil) {
+        err = ESP_ERR_NO_MEM;
+        return {};
+    }
+
+    // Read once, so a wheel starting from idle counts this start as exactly on tick 0.
+    const std::chrono::microseconds now = Timer::now();
+    if (!_running && _active == 0) {
+        _epoch = now;
+        _now = 0;
+    }
+
+    const uint32_t index = _freeList;
+    Node& node = _nodes[index];
+    _freeList = node.next;
+
+    // Round the deadline, not the duration, up to a tick, so a timer started part way through a tick never fires early.
+    const std::chrono::microseconds elapsed = std::max(now - _epoch, static_cast<int64_t>(_now) * _config.tick);
+    const int64_t deadline = (elapsed + std::max(duration, std::chrono::microseconds(0))).count();
+    node.expiry = std::max<uint64_t>(_now + 1, (deadline + _config.tick.count() - 1) / _config.tick.count());
+    node.callback = callback;
+    node.userInfo = userInfo;
+    _insert(index);
+    _active++;
+
+    if (!_running && _timer != nullptr) {
+        err = _timer->startPeriodic(_config.tick);
+        if (err != ESP_OK) {
+            _unlink(index);
+            _free(index);
+            return {};
+        }
+        _running = true;
+    }
+
+    err = ESP_OK;
+    return {.index = index, .generation = node.generation, .expiry = node.expiry};
+}
+
+bool TimerWheel::cancel(TimerWheelHandle handle) {
+    std::lock_guard lock(_mutex);
+    if (handle.index >= _nodes.size()) {
+        return false;
+    }
+    Node& node = _nodes[handle.index];
+    if (node.generation != handle.generation || node.list == kNil) {
+        return false;
+    }
+
+    _unlink(handle.index);
+    _free(handle.index);
+    return true;
+}
+
+bool TimerWheel::isActive(TimerWheelHandle handle) const {
+    std::lock_guard lock(_mutex);
+    return handle.index < _nodes.size() && _nodes[handle.index].generation == handle.generation && _nodes[handle.index].list != kNil;
+}
+
+size_t TimerWheel::activeTimers() const {
+    std::lock_guard lock(_mutex);
+    return _active;
+}
+
+void TimerWheel::advance(uint64_t tick) {
+    std::unique_lock lock(_mutex);
+    while (_now < tick) {
+        _now++;
+
+        // Top down, so timers cascading out of a higher level land in lower slots before those are cascaded in turn.
+        for (size_t level = kLevels - 1; level > 0; level--) {
+            if ((_now & ((uint64_t(1) << (level * kSlotBits)) - 1)) == 0) {
+                _cascade(level);
+            }
+        }
+
+        // Run each timer with the lock released, so callbacks can start and cancel timers.  Nothing new can land in this slot, as
+        // new timers always expire after _now.
+        uint32_t& list = _lists[_now & (kSlots - 1)];
+        while (list != kNil) {
+            const uint32_t index = list;
+            const TimerWheelCallback callback = _nodes[index].callback;
+            void* userInfo = _nodes[index].userInfo;
+            _unlink(index);
+            _free(index);
+
+            if (callback != nullptr) {
+                lock.unlock();
+                callback(*this, userInfo);
+                lock.lock();
+            }
+        }
+    }
+}
+
+uint64_t TimerWheel::_currentTick() const {
+    return (Timer::now() - _epoch) / _config.tick;
+}
+
+void TimerWheel::_insert(uint32_t index) {
+    Node& node = _nodes[index];
+    const uint64_t delta = std::min(node.expiry - _now, kMaxDelta);
+    const uint64_t slotTick = _now + delta;
+
+    size_t level = 0;
+    while (level + 1 < kLevels && delta >= (uint64_t(1) << ((level + 1) * kSlotBits))) {
+        level++;
+    }
+    const uint32_t list = level * kSlots + ((slotTick >> (level * kSlotBits)) & (kSlots - 1));
+
+    node.list = list;
+    node.previous = kNil;
+    node.next = _lists[list];
+    if (node.next != kNil) {
+        _nodes[node.next].previous = index;
+    }
+    _lists[list] = index;
+}
+
+void TimerWheel::_unlink(uint32_t index) {
+    Node& node = _nodes[index];
+    if (node.previous != kNil) {
+        _nodes[node.previous].next = node.next;
+    } else {
+        _lists[node.list] = node.next;
+    }
+    if (node.next != kNil) {
+        _nodes[node.next].previous = node.previous;
+    }
+    node.list = kNil;
+}
+
+void TimerWheel::_free(uint32_t index) {
+    Node& node = _nodes[index];
+    node.generation++;
+    node.callback = nullptr;
+    node.userInfo = nullptr;
+    node.next = _freeList;
+    _freeList = index;
+    _active--;
+}
+
+void TimerWheel::_cascade(size_t level) {
+    const uint32_t list = level * kSlots + ((_now >> (level * kSlotBits)) & (kSlots - 1));
+    uint32_t index = _lists[list];
+    _lists[list] = kNil;
+    while (index != kNil) {
+        const uint32_t next = _nodes[index].next;
+        _insert(index);
+        index = next;
+    }
+}
+
+void TimerWheel::_onTick(Timer& timer, void* userInfo) {
+    TimerWheel* wheel = static_cast<TimerWheel*>(userInfo);
+    uint64_t tick = 0;
+    {
+        std::lock_guard lock(wheel->_mutex);
+        tick = wheel->_currentTick();
+    }
+    wheel->advance(tick);
+
+    std::lock_guard lock(wheel->_mutex);
+    if (wheel->_active == 0 && wheel->_running) {
+        wheel->_running = false;
+        timer.stop();
+    }
+}
@@ -0,0 +1,189 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "ADC/Broadcast.hpp"
+#include "ADC/Continuous.hpp"
+#include "ESP32.hpp"
+
+#include <vector>
+
+using namespace esp;
+using namespace esp::adc;
+
+static ADCContinuousConfig broadcastAdcConfig() {
+    return ADCContinuousConfig{
+        .maximumStoredValues = 256,
+        .numberOfValuesPerConversionFrame = 16,
+        .channels =
+            {
+                {
+                    .unit = ADC_UNIT_1,
+                    .channel = ADC_CHANNEL_0,
+                    .attenuation = Attenuation::Decibels12,
+                    .bitwidth = BitWidth::Bits12,
+                },
+            },
+        .samplingFrequencyHz = 20000,
+    };
+}
+
+static ADCBroadcastConfig broadcastConfig() {
+    return ADCBroadcastConfig{
+        .frameCount = 4,
+        .taskInfo = TaskInfo{.name = "TestADCBroadcast", .priority = 5, .stackSize = 4096},
+        .readTimeoutMs = 10,
+    };
+}
+
+static void publishFrame(ADCBroadcastPtr broadcast, uint8_t value, esp_err_t& err) {
+    std::vector<uint8_t> frame(broadcast->frameSize(), value);
+    broadcast->publish(frame, err);
+}
+
+TEST_CASE("Consumers share one copy of each frame", "[ADCBroadcast]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(broadcastAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastPtr broadcast = adc->addBroadcast(broadcastConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastConsumerPtr first = broadcast->addConsumer({.policy = ADCSlowConsumerPolicy::Block}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastConsumerPtr second = broadcast->addConsumer({.policy = ADCSlowConsumerPolicy::Drop}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    publishFrame(broadcast, 7, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::span<const uint8_t> firstFrame = first->acquire(0, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    std::span<const uint8_t> secondFrame = second->acquire(0, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(broadcast->frameSize(), firstFrame.size());
+    TEST_ASSERT_EQUAL(firstFrame.data(), secondFrame.data());
+    TEST_ASSERT_EQUAL(7, secondFrame[0]);
+
+    first->release(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    second->release(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    first->acquire(0, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, err);
+}
+
+TEST_CASE("Drop consumers lose their oldest frames", "[ADCBroadcast]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(broadcastAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastPtr broadcast = adc->addBroadcast(broadcastConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastConsumerPtr consumer = broadcast->addConsumer({.policy = ADCSlowConsumerPolicy::Drop}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    for (uint8_t i = 0; i < 6; i++) {
+        publishFrame(broadcast, i, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    TEST_ASSERT_EQUAL(2, consumer->framesDropped());
+
+    std::span<const uint8_t> frame = consumer->acquire(0, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(2, frame[0]);
+
+    // The held frame can't be dropped, so the producer waits for it.
+    publishFrame(broadcast, 6, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, err);
+    consumer->release(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    publishFrame(broadcast, 6, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(2, consumer->framesDropped());
+}
+
+TEST_CASE("Block consumers hold back the producer", "[ADCBroadcast]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(broadcastAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastPtr broadcast = adc->addBroadcast(broadcastConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastConsumerPtr consumer = broadcast->addConsumer({.policy = ADCSlowConsumerPolicy::Block}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    for (uint8_t i = 0; i < 4; i++) {
+        publishFrame(broadcast, i, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    publishFrame(broadcast, 4, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, err);
+
+    std::span<const uint8_t> frame = consumer->acquire(0, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(0, frame[0]);
+    consumer->release(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    publishFrame(broadcast, 4, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(0, consumer->framesDropped());
+
+    // Once the consumer goes away it no longer holds anything back.
+    consumer = nullptr;
+    for (uint8_t i = 5; i < 10; i++) {
+        publishFrame(broadcast, i, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+}
+
+TEST_CASE("Lag consumers skip to the newest frame", "[ADCBroadcast]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(broadcastAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastPtr broadcast = adc->addBroadcast(broadcastConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastConsumerPtr consumer = broadcast->addConsumer({.policy = ADCSlowConsumerPolicy::Lag}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    for (uint8_t i = 0; i < 6; i++) {
+        publishFrame(broadcast, i, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    std::span<const uint8_t> frame = consumer->acquire(0, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(5, frame[0]);
+    TEST_ASSERT_EQUAL(5, consumer->framesDropped());
+
+    // The producer never waits for a Lag consumer, so the held frame is overwritten.
+    for (uint8_t i = 6; i < 10; i++) {
+        publishFrame(broadcast, i, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    consumer->release(err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+}
+
+TEST_CASE("Broadcast while acquiring", "[ADCBroadcast]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(broadcastAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastPtr broadcast = adc->addBroadcast(broadcastConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCBroadcastConsumerPtr consumer = broadcast->addConsumer({.policy = ADCSlowConsumerPolicy::Block}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    err = adc->start();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    broadcast->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    for (size_t i = 0; i < 20; i++) {
+        std::span<const uint8_t> frame = consumer->acquire(1000, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        TEST_ASSERT_EQUAL(broadcast->frameSize(), frame.size());
+        consumer->release(err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+
+    broadcast->stop(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    err = adc->stop();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
@@ -0,0 +1,204 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "ADC/Codec.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+using namespace esp;
+using namespace esp::adc;
+
+static uint32_t nextRandom(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 20;
+}
+
+static std::vector<ADCSample> makeSamples(size_t count, uint32_t (*generate)(size_t i, uint32_t& state)) {
+    std::vector<ADCSample> samples;
+    uint32_t state = 1;
+    for (size_t i = 0; i < count; i++) {
+        samples.push_back({.index = 100 + i, .timeNanoseconds = 5'000 + i * 20'000, .value = generate(i, state)});
+    }
+    return samples;
+}
+
+static uint32_t noisySine(size_t i, uint32_t& state) {
+    return static_cast<uint32_t>(2048 + 1500 * std::sin(i * 0.01) + (nextRandom(state) & 7));
+}
+
+static uint32_t drift(size_t i, uint32_t& state) {
+    return static_cast<uint32_t>(1000 + i / 16 + (nextRandom(state) & 1));
+}
+
+static uint32_t square(size_t i, uint32_t&) {
+    return (i / 64) % 2 == 0 ? 200 : 3900;
+}
+
+static uint32_t whiteNoise(size_t, uint32_t& state) {
+    return nextRandom(state);
+}
+
+static void assertRoundTrip(const std::vector<ADCSample>& samples) {
+    std::vector<uint8_t> block(ADCCodec::maximumBlockSize(samples.size()));
+    esp_err_t err = ESP_OK;
+    const size_t size = ADCCodec::encodeBlock(samples, block, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_LESS_OR_EQUAL(block.size(), size);
+    TEST_ASSERT_EQUAL(samples.size(), ADCCodec::blockSamples(block, err));
+
+    std::vector<ADCSample> decoded(samples.size());
+    size_t samplesDecoded = 0;
+    TEST_ASSERT_EQUAL(size, ADCCodec::decodeBlock(std::span<const uint8_t>(block.data(), size), decoded, samplesDecoded, err));
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(samples.size(), samplesDecoded);
+    for (size_t i = 0; i < samples.size(); i++) {
+        TEST_ASSERT_EQUAL(samples[i].value, decoded[i].value);
+        TEST_ASSERT_EQUAL(samples[i].index, decoded[i].index);
+        TEST_ASSERT_EQUAL(samples[i].timeNanoseconds, decoded[i].timeNanoseconds);
+    }
+}
+
+TEST_CASE("Codec round trips every corpus", "[ADCCodec]") {
+    for (auto generate : {noisySine, drift, square, whiteNoise}) {
+        for (size_t count : {1, 2, 3, 256, 1000}) {
+            assertRoundTrip(makeSamples(count, generate));
+        }
+    }
+}
+
+TEST_CASE("Codec round trips extremes", "[ADCCodec]") {
+    std::vector<ADCSample> samples = makeSamples(64, square);
+    for (size_t i = 0; i < samples.size(); i++) {
+        samples[i].value = i % 2 == 0 ? 0 : UINT16_MAX;
+    }
+    assertRoundTrip(samples);
+
+    for (ADCSample& sample : samples) {
+        sample.value = 0;
+    }
+    assertRoundTrip(samples);
+}
+
+TEST_CASE("Codec keeps index gaps and jittered times", "[ADCCodec]") {
+    // Conversions 100 to 119 dropped, and every time a few nanoseconds off the 20us step.
+    std::vector<ADCSample> samples = makeSamples(256, noisySine);
+    uint32_t state = 7;
+    for (size_t i = 0; i < samples.size(); i++) {
+        if (i >= 100) {
+            samples[i].index += 20;
+            samples[i].timeNanoseconds += 20 * 20'000;
+        }
+        samples[i].timeNanoseconds += nextRandom(state) & 15;
+    }
+    assertRoundTrip(samples);
+
+    // Out of order indices and times round trip too.
+    std::swap(samples[10].index, samples[11].index);
+    std::swap(samples[50].timeNanoseconds, samples[51].timeNanoseconds);
+    assertRoundTrip(samples);
+
+    samples[200].index += 1ull << 40;
+    std::vector<uint8_t> block(ADCCodec::maximumBlockSize(samples.size()));
+    esp_err_t err = ESP_OK;
+    ADCCodec::encodeBlock(samples, block, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+}
+
+TEST_CASE("Codec compresses smooth signals", "[ADCCodec]") {
+    const std::vector<ADCSample> samples = makeSamples(1024, drift);
+    std::vector<uint8_t> block(ADCCodec::maximumBlockSize(samples.size()));
+    esp_err_t err = ESP_OK;
+    const size_t size = ADCCodec::encodeBlock(samples, block, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_LESS_THAN(samples.size() / 2, size);
+}
+
+TEST_CASE("Codec rejects wide samples", "[ADCCodec]") {
+    std::vector<ADCSample> samples = makeSamples(8, drift);
+    samples[3].value = 0x10000;
+    std::vector<uint8_t> block(ADCCodec::maximumBlockSize(samples.size()));
+    esp_err_t err = ESP_OK;
+    ADCCodec::encodeBlock(samples, block, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+
+    block.resize(ADCCodec::kHeaderSize);
+    samples[3].value = 0;
+    ADCCodec::encodeBlock(samples, block, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, err);
+}
+
+static void collectBlock(std::span<const uint8_t> block, void* userInfo) {
+    std::vector<uint8_t>* stream = static_cast<std::vector<uint8_t>*>(userInfo);
+    stream->insert(stream->end(), block.begin(), block.end());
+}
+
+TEST_CASE("Encoder stream decodes block by block", "[ADCEncoder]") {
+    std::vector<uint8_t> stream;
+    esp_err_t err = ESP_OK;
+    ADCEncoder encoder({.samplesPerBlock = 100, .onBlock = collectBlock}, &stream, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    const std::vector<ADCSample> samples = makeSamples(1050, noisySine);
+    encoder.process(std::span<const ADCSample>(samples).first(500), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    encoder.process(std::span<const ADCSample>(samples).subspan(500), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    encoder.flush(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(samples.size(), encoder.samplesEncoded());
+    TEST_ASSERT_EQUAL(stream.size(), encoder.bytesEncoded());
+
+    std::vector<ADCSample> decoded(samples.size());
+    size_t offset = 0;
+    size_t total = 0;
+    while (offset < stream.size()) {
+        size_t samplesDecoded = 0;
+        offset += ADCCodec::decodeBlock(std::span<const uint8_t>(stream).subspan(offset), std::span<ADCSample>(decoded).subspan(total), samplesDecoded, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        total += samplesDecoded;
+    }
+    TEST_ASSERT_EQUAL(samples.size(), total);
+    for (size_t i = 0; i < samples.size(); i++) {
+        TEST_ASSERT_EQUAL(samples[i].value, decoded[i].value);
+        TEST_ASSERT_EQUAL(samples[i].index, decoded[i].index);
+    }
+}
+
+TEST_CASE("Codec benchmark", "[ADCCodec][benchmark]") {
+    constexpr size_t kSamples = 16'384;
+    constexpr size_t kSamplesPerBlock = 256;
+    const char* names[] = {"noisy sine", "drift", "square", "random"};
+    size_t corpus = 0;
+    for (auto generate : {noisySine, drift, square, whiteNoise}) {
+        const std::vector<ADCSample> samples = makeSamples(kSamples, generate);
+        std::vector<uint8_t> block(ADCCodec::maximumBlockSize(kSamplesPerBlock));
+        std::vector<ADCSample> decoded(kSamplesPerBlock);
+        esp_err_t err = ESP_OK;
+
+        size_t bytes = 0;
+        std::chrono::nanoseconds encodeTime{0};
+        std::chrono::nanoseconds decodeTime{0};
+        for (size_t offset = 0; offset < kSamples; offset += kSamplesPerBlock) {
+            auto start = std::chrono::steady_clock::now();
+            const size_t size = ADCCodec::encodeBlock(std::span<const ADCSample>(samples).subspan(offset, kSamplesPerBlock), block, err);
+            encodeTime += std::chrono::steady_clock::now() - start;
+            TEST_ASSERT_EQUAL(ESP_OK, err);
+            bytes += size;
+
+            size_t samplesDecoded = 0;
+            start = std::chrono::steady_clock::now();
+            ADCCodec::decodeBlock(block, decoded, samplesDecoded, err);
+            decodeTime += std::chrono::steady_clock::now() - start;
+            TEST_ASSERT_EQUAL(ESP_OK, err);
+        }
+
+        // Compared with the 2 bytes per sample a raw 12 bit stream normally occupies.
+        printf("%-10s: ratio %5.2f, encode %5lld ns/sample, decode %5lld ns/sample\n", names[corpus++], 2.0 * kSamples / bytes,
+               static_cast<long long>(encodeTime.count() / kSamples), static_cast<long long>(decodeTime.count() / kSamples));
+    }
+}
@@ -0,0 +1,139 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "ADC/Deinterleaver.hpp"
+
+#include <vector>
+
+using namespace esp;
+using namespace esp::adc;
+
+static ADCContinuousConfig dualUnitConfig(ConversionMode mode) {
+    return ADCContinuousConfig{
+        .maximumStoredValues = 32,
+        .numberOfValuesPerConversionFrame = 16,
+        .channels =
+            {
+                {
+                    .unit = ADC_UNIT_1,
+                    .channel = ADC_CHANNEL_0,
+                    .attenuation = Attenuation::Decibels12,
+                    .bitwidth = BitWidth::Bits12,
+                },
+                {
+                    .unit = ADC_UNIT_2,
+                    .channel = ADC_CHANNEL_1,
+                    .attenuation = Attenuation::Decibels12,
+                    .bitwidth = BitWidth::Bits12,
+                },
+            },
+        .samplingFrequencyHz = 1000,
+        .conversionMode = mode,
+    };
+}
+
+TEST_CASE("Split single unit streams", "[ADCDeinterleaver]") {
+    ADCContinuousConfig config = dualUnitConfig(ConversionMode::SingleUnit1);
+    config.channels[1].unit = ADC_UNIT_1;
+
+    esp_err_t err = ESP_OK;
+    ADCDeinterleaver deinterleaver(config, {.maximumSamplesPerChannel = 8}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::vector<adc_continuous_data_t> data;
+    for (uint32_t i = 0; i < 4; i++) {
+        data.push_back({.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .raw_data = i, .valid = true});
+        data.push_back({.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_1, .raw_data = 100 + i, .valid = true});
+    }
+    deinterleaver.process(data, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::span<const ADCSample> channel0 = deinterleaver.samples(ADC_UNIT_1, ADC_CHANNEL_0);
+    std::span<const ADCSample> channel1 = deinterleaver.samples(ADC_UNIT_1, ADC_CHANNEL_1);
+    TEST_ASSERT_EQUAL(4, channel0.size());
+    TEST_ASSERT_EQUAL(4, channel1.size());
+    for (uint32_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(i, channel0[i].index);
+        TEST_ASSERT_EQUAL(i, channel0[i].value);
+        TEST_ASSERT_EQUAL(2 * i * 1'000'000, channel0[i].timeNanoseconds);
+        TEST_ASSERT_EQUAL(100 + i, channel1[i].value);
+        TEST_ASSERT_EQUAL((2 * i + 1) * 1'000'000, channel1[i].timeNanoseconds);
+    }
+}
+
+TEST_CASE("Indices continue across frames", "[ADCDeinterleaver]") {
+    esp_err_t err = ESP_OK;
+    ADCDeinterleaver deinterleaver(dualUnitConfig(ConversionMode::BothUnit), {.maximumSamplesPerChannel = 8}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::vector<adc_continuous_data_t> data = {
+        {.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .raw_data = 1, .valid = true},
+        {.unit = ADC_UNIT_2, .channel = ADC_CHANNEL_1, .raw_data = 2, .valid = true},
+    };
+    deinterleaver.process(data, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    deinterleaver.process(data, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::span<const ADCSample> unit1 = deinterleaver.samples(ADC_UNIT_1, ADC_CHANNEL_0);
+    std::span<const ADCSample> unit2 = deinterleaver.samples(ADC_UNIT_2, ADC_CHANNEL_1);
+    TEST_ASSERT_EQUAL(1, unit1.size());
+    TEST_ASSERT_EQUAL(1, unit1[0].index);
+    TEST_ASSERT_EQUAL(1'000'000, unit1[0].timeNanoseconds);
+    TEST_ASSERT_EQUAL(1, unit2.size());
+    TEST_ASSERT_EQUAL(1, unit2[0].index);
+    TEST_ASSERT_EQUAL(1'000'000, unit2[0].timeNanoseconds);
+
+    deinterleaver.reset();
+    deinterleaver.process(data, err);
+    TEST_ASSERT_EQUAL(0, deinterleaver.samples(ADC_UNIT_1, ADC_CHANNEL_0)[0].index);
+}
+
+TEST_CASE("Interpolate unit 2 onto unit 1 grid", "[ADCDeinterleaver]") {
+    esp_err_t err = ESP_OK;
+    ADCDeinterleaver deinterleaver(dualUnitConfig(ConversionMode::AlterUnit),
+                                   {.maximumSamplesPerChannel = 8, .unit2OffsetNanoseconds = 250'000, .interpolateUnit2 = true}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // A ramp of 100 counts per millisecond, with ADC2 sampled a quarter of a slot after ADC1.
+    std::vector<adc_continuous_data_t> data;
+    for (uint32_t i = 0; i < 4; i++) {
+        data.push_back({.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .raw_data = 100 * i, .valid = true});
+        data.push_back({.unit = ADC_UNIT_2, .channel = ADC_CHANNEL_1, .raw_data = 100 * i + 25, .valid = true});
+    }
+    deinterleaver.process(data, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::span<const ADCSample> unit1 = deinterleaver.samples(ADC_UNIT_1, ADC_CHANNEL_0);
+    std::span<const ADCSample> unit2 = deinterleaver.samples(ADC_UNIT_2, ADC_CHANNEL_1);
+    TEST_ASSERT_EQUAL(4, unit1.size());
+    TEST_ASSERT_EQUAL(3, unit2.size());
+    for (size_t i = 0; i < unit2.size(); i++) {
+        const ADCSample& reference = unit1[unit2[i].index];
+        TEST_ASSERT_EQUAL(reference.timeNanoseconds, unit2[i].timeNanoseconds);
+        TEST_ASSERT_EQUAL(reference.value, unit2[i].value);
+    }
+}
+
+TEST_CASE("Overflowing a stream drops samples", "[ADCDeinterleaver]") {
+    esp_err_t err = ESP_OK;
+    ADCDeinterleaver deinterleaver(dualUnitConfig(ConversionMode::BothUnit), {.maximumSamplesPerChannel = 1}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::vector<adc_continuous_data_t> data = {
+        {.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .raw_data = 1, .valid = true},
+        {.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .raw_data = 2, .valid = true},
+        {.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_5, .raw_data = 3, .valid = true},
+    };
+    deinterleaver.process(data, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, err);
+    TEST_ASSERT_EQUAL(1, deinterleaver.droppedSamples());
+    TEST_ASSERT_EQUAL(1, deinterleaver.unknownSamples());
+}
+
+TEST_CASE("Interpolation needs a dual unit mode", "[ADCDeinterleaver]") {
+    esp_err_t err = ESP_OK;
+    ADCDeinterleaver deinterleaver(dualUnitConfig(ConversionMode::SingleUnit1), {.maximumSamplesPerChannel = 8, .interpolateUnit2 = true}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+}
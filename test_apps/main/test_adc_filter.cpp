@@ -0,0 +1,118 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "ADC/Continuous.hpp"
+#include "ADC/Filter.hpp"
+#include "ADC/Monitor.hpp"
+#include "ESP32.hpp"
+
+#include <vector>
+
+using namespace esp;
+using namespace esp::adc;
+
+static ADCContinuousConfig singleChannelConfig() {
+    return ADCContinuousConfig{
+        .maximumStoredValues = 32,
+        .numberOfValuesPerConversionFrame = 16,
+        .channels =
+            {
+                {
+                    .unit = ADC_UNIT_1,
+                    .channel = ADC_CHANNEL_0,
+                    .attenuation = Attenuation::Decibels12,
+                    .bitwidth = BitWidth::Bits12,
+                },
+            },
+        .samplingFrequencyHz = 20000,
+    };
+}
+
+struct MonitorCounts {
+    size_t high = 0;
+    size_t low = 0;
+};
+
+static InterruptResult onHigh(void* userInfo) {
+    reinterpret_cast<MonitorCounts*>(userInfo)->high++;
+    return InterruptResult::NoHighPriorityTaskWoken;
+}
+
+static InterruptResult onLow(void* userInfo) {
+    reinterpret_cast<MonitorCounts*>(userInfo)->low++;
+    return InterruptResult::HighPriorityTaskWoken;
+}
+
+TEST_CASE("IIR filter model", "[ADCFilter]") {
+    ADCIIRFilterModel filter(IIRFilterCoefficient::K4);
+    TEST_ASSERT_EQUAL(1000, filter.push(1000));
+    TEST_ASSERT_EQUAL(1250, filter.push(2000));
+    TEST_ASSERT_EQUAL(1437, filter.push(2000));
+
+    filter.reset();
+    std::vector<ADCSample> samples = {{.index = 0, .timeNanoseconds = 0, .value = 400}, {.index = 1, .timeNanoseconds = 1000, .value = 0}};
+    filter.process(samples);
+    TEST_ASSERT_EQUAL(400, samples[0].value);
+    TEST_ASSERT_EQUAL(300, samples[1].value);
+}
+
+TEST_CASE("Monitor model", "[ADCFilter]") {
+    ADCMonitorModel monitor({.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .highThreshold = 3000, .lowThreshold = 100});
+    MonitorCounts counts;
+    monitor.setEventCallbacks({.onAboveHighThreshold = onHigh, .onBelowLowThreshold = onLow}, &counts);
+
+    std::vector<ADCSample> samples;
+    for (uint32_t value : {50u, 2000u, 3500u, 3001u, 3000u, 99u}) {
+        samples.push_back({.index = samples.size(), .timeNanoseconds = 0, .value = value});
+    }
+    TEST_ASSERT_EQUAL(InterruptResult::HighPriorityTaskWoken, monitor.process(samples));
+    TEST_ASSERT_EQUAL(2, counts.high);
+    TEST_ASSERT_EQUAL(2, counts.low);
+}
+
+TEST_CASE("Add IIR filter", "[ADCFilter]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(singleChannelConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(adc);
+
+    ADCIIRFilterPtr filter = adc->addIIRFilter({.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .coefficient = IIRFilterCoefficient::K16}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(filter);
+    filter->enable(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    err = adc->start();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    std::vector<uint8_t> rawData = adc->read<256>(1000, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_FALSE(rawData.empty());
+    err = adc->stop();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("Add monitor", "[ADCFilter]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(singleChannelConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(adc);
+
+    ADCMonitorPtr monitor = adc->addMonitor({.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .highThreshold = 4000, .lowThreshold = 10}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(monitor);
+
+    MonitorCounts counts;
+    monitor->setEventCallbacks({.onAboveHighThreshold = onHigh, .onBelowLowThreshold = onLow}, &counts, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    monitor->enable(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    err = adc->start();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCMonitorPtr runningMonitor = adc->addMonitor({.unit = ADC_UNIT_1, .channel = ADC_CHANNEL_0, .highThreshold = 10, .lowThreshold = std::nullopt}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_NULL(runningMonitor);
+    err = adc->stop();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
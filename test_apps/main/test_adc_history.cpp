@@ -0,0 +1,155 @@
+extern "C" {
+#include <unity.h>
+}
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "ADC/Continuous.hpp"
+#include "ADC/History.hpp"
+#include "ESP32.hpp"
+
+#include <vector>
+
+using namespace esp;
+using namespace esp::adc;
+
+static ADCContinuousConfig historyAdcConfig() {
+    return ADCContinuousConfig{
+        .maximumStoredValues = 256,
+        .numberOfValuesPerConversionFrame = 64,
+        .channels =
+            {
+                {
+                    .unit = ADC_UNIT_1,
+                    .channel = ADC_CHANNEL_0,
+                    .attenuation = Attenuation::Decibels12,
+                    .bitwidth = BitWidth::Bits12,
+                },
+            },
+        .samplingFrequencyHz = 20000,
+    };
+}
+
+static ADCHistoryConfig historyConfig() {
+    return ADCHistoryConfig{
+        .blockSize = 500,
+        .blockCount = 16,
+        // The test app doesn't enable PSRAM.
+        .memoryCapabilities = MALLOC_CAP_DEFAULT,
+        .taskInfo = TaskInfo{.name = "TestADCHistory", .priority = 5, .stackSize = 4096},
+    };
+}
+
+TEST_CASE("Block size is rounded to cache lines", "[ADCHistory]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(historyAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCHistoryPtr history = adc->addHistory(historyConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(history);
+    TEST_ASSERT_EQUAL(0, history->blockSize() % kCacheLineSize);
+    TEST_ASSERT_GREATER_OR_EQUAL(500, history->blockSize());
+}
+
+TEST_CASE("Invalid history configuration", "[ADCHistory]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(historyAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCHistoryConfig config = historyConfig();
+    config.blockCount = 1;
+    ADCHistoryPtr history = adc->addHistory(config, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(history);
+}
+
+TEST_CASE("Read history while acquiring", "[ADCHistory]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(historyAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCHistoryPtr history = adc->addHistory(historyConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    err = adc->start();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    history->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // 20k conversions a second fills a 512 byte block roughly every 6ms, so this wraps the ring several times.
+    vTaskDelay(500 / portTICK_PERIOD_MS);
+    TEST_ASSERT_GREATER_THAN(16, history->blocksWritten());
+
+    auto [from, to] = history->availableRange();
+    TEST_ASSERT(from < to);
+
+    std::vector<uint8_t> buffer(history->blockSize() * 4);
+    const std::chrono::microseconds end = from + std::chrono::milliseconds(5);
+    size_t bytes = history->read(from, end, buffer, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(100 * SOC_ADC_DIGI_RESULT_BYTES, bytes);
+
+    history->stop(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    err = adc->stop();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+struct Stall {
+    uint32_t milliseconds;
+    TaskHandle_t waiting;
+};
+
+static void stallTask(void* userInfo) {
+    Stall* stall = static_cast<Stall*>(userInfo);
+    esp_rom_delay_us(stall->milliseconds * 1000);
+    xTaskNotifyGive(stall->waiting);
+    vTaskDelete(nullptr);
+}
+
+TEST_CASE("History counts conversions dropped while the drain is stalled", "[ADCHistory]") {
+    esp_err_t err = ESP_OK;
+    ADCContinuousPtr adc = ESP32::sharedESP32()->adcContinuous(historyAdcConfig(), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ADCHistoryConfig config = historyConfig();
+    config.blockCount = 64;
+    config.taskInfo.coreId = 1;
+    ADCHistoryPtr history = adc->addHistory(config, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    err = adc->start();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    history->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(0, history->droppedConversions());
+
+    // A busy task above the drain task on its core keeps it off for 100ms, some 2000 conversions against a 256 value pool.
+    const std::chrono::microseconds stallStart(esp_timer_get_time());
+    Stall stall = {.milliseconds = 100, .waiting = xTaskGetCurrentTaskHandle()};
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(stallTask, "TestADCStall", 2048, &stall, config.taskInfo.priority + 1, nullptr, 1));
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    const std::chrono::microseconds stallEnd(esp_timer_get_time());
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+
+    TEST_ASSERT_GREATER_THAN(1000, history->droppedConversions());
+    TEST_ASSERT_GREATER_THAN(0, adc->poolOverflows());
+
+    // Later times stay on the sampling clock rather than falling behind by the conversions lost.
+    auto [from, to] = history->availableRange();
+    const std::chrono::microseconds now(esp_timer_get_time());
+    TEST_ASSERT_LESS_THAN(30'000, std::chrono::abs(now - to).count());
+
+    // Either side of the stall is still there, with the gap reported.
+    TEST_ASSERT(from < stallStart - std::chrono::milliseconds(20));
+    std::vector<uint8_t> buffer(history->blockSize() * 32);
+    const size_t bytes = history->read(stallStart - std::chrono::milliseconds(20), stallEnd + std::chrono::milliseconds(20), buffer, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, err);
+    TEST_ASSERT_GREATER_THAN(0, bytes);
+    TEST_ASSERT_LESS_THAN((stallEnd - stallStart + std::chrono::milliseconds(40)).count() * 20 * SOC_ADC_DIGI_RESULT_BYTES / 1000, bytes);
+
+    history->stop(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    err = adc->stop();
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
@@ -0,0 +1,113 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "ADC/MedianFilter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace esp;
+using namespace esp::adc;
+
+static uint32_t nextRandom(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 20;
+}
+
+static uint32_t sortedMedian(std::vector<uint32_t> window) {
+    std::sort(window.begin(), window.end());
+    const size_t middle = window.size() / 2;
+    if ((window.size() & 1) == 0) {
+        return window[middle - 1] + (window[middle] - window[middle - 1]) / 2;
+    }
+    return window[middle];
+}
+
+TEST_CASE("Median matches sorted window", "[ADCMedianFilter]") {
+    for (size_t windowSize : {1, 2, 3, 8, 31}) {
+        esp_err_t err = ESP_OK;
+        ADCMedianFilter filter({.windowSize = windowSize, .spikeThreshold = std::nullopt}, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+
+        uint32_t state = 1;
+        std::vector<uint32_t> history;
+        for (size_t i = 0; i < 500; i++) {
+            const uint32_t value = nextRandom(state);
+            history.push_back(value);
+            const size_t start = history.size() > windowSize ? history.size() - windowSize : 0;
+            const uint32_t expected = sortedMedian(std::vector<uint32_t>(history.begin() + start, history.end()));
+            TEST_ASSERT_EQUAL(expected, filter.push(value));
+        }
+    }
+}
+
+TEST_CASE("Spike rejection", "[ADCMedianFilter]") {
+    esp_err_t err = ESP_OK;
+    ADCMedianFilter filter({.windowSize = 5, .spikeThreshold = 50}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::vector<ADCSample> samples;
+    for (uint64_t i = 0; i < 10; i++) {
+        samples.push_back({.index = i, .timeNanoseconds = i * 1000, .value = 1000 + static_cast<uint32_t>(i)});
+    }
+    samples[6].value = 4095;
+    filter.process(samples);
+
+    TEST_ASSERT_EQUAL(1, filter.rejectedSamples());
+    TEST_ASSERT_EQUAL(1004, samples[6].value);
+    TEST_ASSERT_EQUAL(1005, samples[5].value);
+    TEST_ASSERT_EQUAL(1007, samples[7].value);
+}
+
+TEST_CASE("Reset empties the window", "[ADCMedianFilter]") {
+    esp_err_t err = ESP_OK;
+    ADCMedianFilter filter({.windowSize = 4, .spikeThreshold = std::nullopt}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    filter.push(10);
+    filter.push(20);
+    filter.reset();
+    TEST_ASSERT_EQUAL(0, filter.median());
+    TEST_ASSERT_EQUAL(7, filter.push(7));
+}
+
+TEST_CASE("Invalid window size", "[ADCMedianFilter]") {
+    esp_err_t err = ESP_OK;
+    ADCMedianFilter filter({.windowSize = 0, .spikeThreshold = std::nullopt}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+}
+
+TEST_CASE("Median filter benchmark", "[ADCMedianFilter][benchmark]") {
+    constexpr size_t kSamples = 20'000;
+    for (size_t windowSize : {5, 15, 63, 255}) {
+        esp_err_t err = ESP_OK;
+        ADCMedianFilter filter({.windowSize = windowSize, .spikeThreshold = std::nullopt}, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+
+        uint32_t state = 1;
+        uint32_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kSamples; i++) {
+            sink += filter.push(nextRandom(state));
+        }
+        const auto heapTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        state = 1;
+        std::vector<uint32_t> ring(windowSize);
+        std::vector<uint32_t> scratch(windowSize);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kSamples; i++) {
+            ring[i % windowSize] = nextRandom(state);
+            const size_t count = std::min(i + 1, windowSize);
+            std::copy_n(ring.begin(), count, scratch.begin());
+            std::sort(scratch.begin(), scratch.begin() + count);
+            sink += scratch[count / 2];
+        }
+        const auto sortTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+        printf("window %3zu: heap %6lld ns/sample, sort %6lld ns/sample (%lu)\n", windowSize, static_cast<long long>(heapTime.count() / kSamples),
+               static_cast<long long>(sortTime.count() / kSamples), static_cast<unsigned long>(sink & 1));
+    }
+}
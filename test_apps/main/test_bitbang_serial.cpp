@@ -0,0 +1,206 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "BitBangSerial.hpp"
+#include "ESP32.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace esp;
+
+// Records every pin change against a simulated cycle counter, with data in looped back from data out.
+struct TracePort {
+    struct Event {
+        uint32_t time;
+        bool clock;
+        Level level;
+    };
+
+    uint32_t now = 0;
+    Level data = Level::Low;
+    bool inWord = false;
+    size_t outsideWord = 0;
+    size_t words = 0;
+    std::vector<Event> events;
+
+    void setClock(Level level) { record(true, level); }
+    void setData(Level level) {
+        data = level;
+        record(false, level);
+    }
+    Level sample() const { return data; }
+    uint32_t cycles() { return now++; }
+    void beginWord() { inWord = true; }
+    void endWord() {
+        inWord = false;
+        words++;
+    }
+
+    void record(bool clock, Level level) {
+        outsideWord += inWord ? 0 : 1;
+        events.push_back({.time = now, .clock = clock, .level = level});
+    }
+};
+
+// Decode the trace the way the peripheral would, sampling data on the edge the mode says to.
+static uint32_t decode(const TracePort& port, const BitBangSerialConfig& config) {
+    const Level active = config.clockPolarity == Level::Low ? Level::High : Level::Low;
+    const Level sampleEdge = config.clockPhase ? config.clockPolarity : active;
+    Level data = Level::Low;
+    uint32_t word = 0;
+    for (const TracePort::Event& event : port.events) {
+        if (!event.clock) {
+            data = event.level;
+        } else if (event.level == sampleEdge) {
+            word = (word << 1) | (data == Level::High ? 1 : 0);
+        }
+    }
+
+    if (config.bitOrder == BitOrder::MSBFirst) {
+        return word;
+    }
+    uint32_t reversed = 0;
+    for (uint32_t i = 0; i < config.wordSize; i++) {
+        reversed |= ((word >> i) & 1) << (config.wordSize - 1 - i);
+    }
+    return reversed;
+}
+
+TEST_CASE("Bit-bang trace matches every mode", "[BitBangSerial]") {
+    constexpr uint32_t kHalfPeriod = 20;
+    constexpr uint32_t kWord = 0xA5C;
+
+    for (Level polarity : {Level::Low, Level::High}) {
+        for (bool phase : {false, true}) {
+            for (BitOrder order : {BitOrder::MSBFirst, BitOrder::LSBFirst}) {
+                const BitBangSerialConfig config = {
+                    .clock = GPIO_NUM_4, .clockPolarity = polarity, .clockPhase = phase, .bitOrder = order, .wordSize = 12};
+                TracePort port;
+                const uint32_t received = BitBangSerial::shiftWord(port, config, kHalfPeriod, kWord);
+                TEST_ASSERT_EQUAL_HEX32(kWord, received);
+                TEST_ASSERT_EQUAL_HEX32(kWord, decode(port, config));
+                TEST_ASSERT_EQUAL(0, port.outsideWord);
+
+                std::vector<TracePort::Event> clockEdges;
+                for (const TracePort::Event& event : port.events) {
+                    if (event.clock) {
+                        clockEdges.push_back(event);
+                    }
+                }
+                TEST_ASSERT_EQUAL(2 * config.wordSize, clockEdges.size());
+                TEST_ASSERT_EQUAL(polarity, clockEdges.back().level);
+                for (size_t i = 1; i < clockEdges.size(); i++) {
+                    TEST_ASSERT_NOT_EQUAL(clockEdges[i - 1].level, clockEdges[i].level);
+                    // Deadlines absorb the cost of the pin writes, so every half period is the same length.
+                    const uint32_t halfPeriod = clockEdges[i].time - clockEdges[i - 1].time;
+                    TEST_ASSERT_UINT32_WITHIN(2, kHalfPeriod, halfPeriod);
+                }
+            }
+        }
+    }
+}
+
+// A shared open drain data line: low if either the master or the peripheral pulls it low.  The peripheral drives the next bit of its
+// reply each time the line is sampled.
+struct OpenDrainPort {
+    Level master = Level::High;
+    uint32_t reply = 0;
+    uint32_t bit = 0;
+    uint32_t wordSize = 8;
+    uint32_t now = 0;
+
+    void setClock(Level) {}
+    void setData(Level level) { master = level; }
+    Level sample() {
+        const bool peripheral = ((reply >> (wordSize - 1 - bit++)) & 1) != 0;
+        return master == Level::High && peripheral ? Level::High : Level::Low;
+    }
+    uint32_t cycles() { return now++; }
+    void beginWord() {}
+    void endWord() {}
+};
+
+TEST_CASE("Bit-bang read only transfer releases the shared line", "[BitBangSerial]") {
+    const BitBangSerialConfig config = {.clock = GPIO_NUM_4, .dataOut = GPIO_NUM_5, .dataIn = GPIO_NUM_5};
+    OpenDrainPort port = {.reply = 0xA7};
+    TEST_ASSERT_EQUAL_HEX32(0xA7, BitBangSerial::shiftWord(port, config, 0, BitBangSerial::kReleasedWord));
+    TEST_ASSERT_EQUAL(Level::High, port.master);
+
+    // Written bits are released once the word is done, so a read straight after still sees the peripheral.
+    port.bit = 0;
+    BitBangSerial::shiftWord(port, config, 0, 0x00);
+    TEST_ASSERT_EQUAL(Level::High, port.master);
+
+    // With nothing driving the line the pull up reads back as ones.
+    esp_err_t err = ESP_OK;
+    BitBangSerialPtr serial =
+        ESP32::sharedESP32()->bitBangSerial({.clock = GPIO_NUM_4, .dataOut = GPIO_NUM_5, .dataIn = GPIO_NUM_5, .clockHz = 100'000}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    std::vector<uint8_t> in(4);
+    serial->transfer<uint8_t>({}, in, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    for (uint8_t word : in) {
+        TEST_ASSERT_EQUAL_HEX32(0xFF, word);
+    }
+}
+
+TEST_CASE("Bit-bang loopback on one open drain pin", "[BitBangSerial]") {
+    esp_err_t err = ESP_OK;
+    BitBangSerialPtr serial =
+        ESP32::sharedESP32()->bitBangSerial({.clock = GPIO_NUM_4, .dataOut = GPIO_NUM_5, .dataIn = GPIO_NUM_5, .clockHz = 100'000}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(serial);
+
+    const std::vector<uint8_t> out = {0x00, 0x5A, 0xFF, 0x81};
+    std::vector<uint8_t> in(out.size());
+    serial->transfer<uint8_t>(out, in, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(out.data(), in.data(), out.size());
+
+    std::vector<uint8_t> shortIn(2);
+    serial->transfer<uint8_t>(out, shortIn, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, err);
+}
+
+TEST_CASE("Invalid bit-bang configuration", "[BitBangSerial]") {
+    esp_err_t err = ESP_OK;
+    BitBangSerialPtr serial = ESP32::sharedESP32()->bitBangSerial({.clock = GPIO_NUM_4}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(serial);
+
+    serial = ESP32::sharedESP32()->bitBangSerial({.clock = GPIO_NUM_4, .dataOut = GPIO_NUM_5, .wordSize = 33}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(serial);
+
+    // 32 bits at 100 kHz would mask interrupts for 320 us.
+    serial = ESP32::sharedESP32()->bitBangSerial({.clock = GPIO_NUM_4, .dataOut = GPIO_NUM_5, .wordSize = 32, .clockHz = 100'000}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(serial);
+
+    serial = ESP32::sharedESP32()->bitBangSerial({.clock = GPIO_NUM_4, .dataOut = GPIO_NUM_5, .wordSize = 8, .clockHz = 80'000}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(serial);
+}
+
+TEST_CASE("BitBangSerial benchmark", "[BitBangSerial][benchmark]") {
+    constexpr size_t kBytes = 1024;
+    const std::vector<uint8_t> out(kBytes, 0x5A);
+
+    for (uint32_t clockHz : {1'000'000u, 0u}) {
+        esp_err_t err = ESP_OK;
+        BitBangSerialPtr serial =
+            ESP32::sharedESP32()->bitBangSerial({.clock = GPIO_NUM_4, .dataOut = GPIO_NUM_5, .clockHz = clockHz}, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+
+        const auto start = std::chrono::steady_clock::now();
+        serial->transfer<uint8_t>(out, {}, err);
+        const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+
+        printf("clockHz %lu: %.0f bits per second\n", static_cast<unsigned long>(clockHz),
+               kBytes * 8 / std::chrono::duration<double>(elapsed).count());
+    }
+}
@@ -0,0 +1,144 @@
+extern "C" {
+#include <unity.h>
+}
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "Coroutine.hpp"
+#include "ESP32.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace esp;
+using namespace std::chrono_literals;
+
+static Coroutine<void> sleeper(std::chrono::milliseconds duration, std::vector<int>* order, int id) {
+    co_await sleepFor(duration);
+    order->push_back(id);
+}
+
+static Coroutine<int> slowValue(std::chrono::milliseconds duration, int value, std::atomic<bool>* finished) {
+    co_await sleepFor(duration);
+    *finished = true;
+    co_return value;
+}
+
+struct TimeoutResults {
+    std::atomic<int> fast = 0;
+    std::atomic<esp_err_t> slow = ESP_OK;
+    std::atomic<bool> fastFinished = false;
+    std::atomic<bool> slowFinished = false;
+    std::atomic<bool> done = false;
+};
+
+static Coroutine<void> timeouts(TimeoutResults* results) {
+    std::expected<int, esp_err_t> fast = co_await withTimeout(slowValue(5ms, 42, &results->fastFinished), 50ms);
+    results->fast = fast.value_or(-1);
+    std::expected<int, esp_err_t> slow = co_await withTimeout(slowValue(50ms, 7, &results->slowFinished), 5ms);
+    results->slow = slow ? ESP_OK : slow.error();
+    results->done = true;
+}
+
+static void sleepsWakeInOrder(TimerDispatchMethod dispatchMethod) {
+    esp_err_t err = ESP_OK;
+    CoroutineExecutorPtr executor = ESP32::sharedESP32()->coroutineExecutor({.dispatchMethod = dispatchMethod}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(executor);
+
+    std::vector<int> order;
+    executor->spawn(sleeper(30ms, &order, 3), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    executor->spawn(sleeper(10ms, &order, 1), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    executor->spawn(sleeper(20ms, &order, 2), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    vTaskDelay(60 / portTICK_PERIOD_MS);
+    const std::vector<int> expected = {1, 2, 3};
+    TEST_ASSERT_TRUE(order == expected);
+}
+
+TEST_CASE("Coroutine sleeps wake in deadline order", "[Coroutine]") {
+    sleepsWakeInOrder(TimerDispatchMethod::Task);
+}
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+TEST_CASE("Coroutine sleeps with ISR dispatch", "[Coroutine]") {
+    sleepsWakeInOrder(TimerDispatchMethod::ISR);
+}
+#endif
+
+TEST_CASE("Coroutine timeouts cancel the operation", "[Coroutine]") {
+    esp_err_t err = ESP_OK;
+    CoroutineExecutorPtr executor = ESP32::sharedESP32()->coroutineExecutor({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    TimeoutResults results;
+    executor->spawn(timeouts(&results), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+    TEST_ASSERT_TRUE(results.done.load());
+    TEST_ASSERT_EQUAL(42, results.fast.load());
+    TEST_ASSERT_TRUE(results.fastFinished.load());
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, results.slow.load());
+    TEST_ASSERT_FALSE(results.slowFinished.load());
+}
+
+TEST_CASE("Destroying an executor cancels its sleepers", "[Coroutine]") {
+    esp_err_t err = ESP_OK;
+    CoroutineExecutorPtr executor = ESP32::sharedESP32()->coroutineExecutor({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::vector<int> order;
+    executor->spawn(sleeper(20ms, &order, 1), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    vTaskDelay(5 / portTICK_PERIOD_MS);
+    executor.reset();
+
+    vTaskDelay(40 / portTICK_PERIOD_MS);
+    TEST_ASSERT_TRUE(order.empty());
+}
+
+static void sleeperTask(void* userInfo) {
+    vTaskDelay(500 / portTICK_PERIOD_MS);
+    xTaskNotifyGive(static_cast<TaskHandle_t>(userInfo));
+    vTaskDelete(nullptr);
+}
+
+TEST_CASE("Coroutine memory benchmark", "[Coroutine][benchmark]") {
+    constexpr size_t kSleepers = 100;
+    // About the smallest stack a task that logs can get away with.
+    constexpr uint32_t kTaskStackSize = 2048;
+
+    esp_err_t err = ESP_OK;
+    CoroutineExecutorPtr executor = ESP32::sharedESP32()->coroutineExecutor({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::vector<int> order;
+    order.reserve(kSleepers);
+    size_t before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    for (size_t i = 0; i < kSleepers; i++) {
+        executor->spawn(sleeper(500ms, &order, static_cast<int>(i)), err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    const size_t coroutineBytes = before - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    vTaskDelay(600 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(kSleepers, order.size());
+
+    before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    for (size_t i = 0; i < kSleepers; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreate(sleeperTask, "sleeper", kTaskStackSize, xTaskGetCurrentTaskHandle(), 1, nullptr));
+    }
+    const size_t taskBytes = before - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    for (size_t i = 0; i < kSleepers; i++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+
+    printf("%zu sleepers: coroutines %zu bytes, tasks %zu bytes\n", kSleepers, coroutineBytes, taskBytes);
+}
@@ -0,0 +1,106 @@
+extern "C" {
+#include <unity.h>
+}
+#include <freertos/FreeRTOS.h>
+
+#include "Debounce.hpp"
+#include "ESP32.hpp"
+
+#include <vector>
+
+using namespace esp;
+
+struct DebounceEdge {
+    size_t input;
+    Level level;
+};
+
+static void recordEdge(size_t input, Level level, void* userInfo) {
+    static_cast<std::vector<DebounceEdge>*>(userInfo)->push_back({input, level});
+}
+
+static DebounceGroupPtr makeGroup(std::vector<DebounceEdge>& edges, esp_err_t& err) {
+    std::vector<GPIOPtr> inputs;
+    for (gpio_num_t pin : {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_40}) {
+        GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(pin, GPIOModeInputOutput), err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        gpio->setLevel(Level::Low, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        inputs.push_back(gpio);
+    }
+
+    return ESP32::sharedESP32()->debounceGroup({.inputs = inputs, .callback = recordEdge, .userInfo = &edges}, err);
+}
+
+TEST_CASE("Inputs settle after consecutive samples", "[DebounceGroup]") {
+    esp_err_t err = ESP_OK;
+    std::vector<DebounceEdge> edges;
+    DebounceGroupPtr group = makeGroup(edges, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(group);
+
+    const uint32_t pin4 = 1u << 4;
+    const uint32_t pin40 = 1u << (40 - 32);
+    for (size_t i = 0; i < DebounceGroup::kSamplesToSettle - 1; i++) {
+        group->sample(std::vector<uint32_t>{pin4, pin40});
+    }
+    TEST_ASSERT_EQUAL(0, edges.size());
+    group->sample(std::vector<uint32_t>{pin4, pin40});
+    TEST_ASSERT_EQUAL(2, edges.size());
+    TEST_ASSERT_EQUAL(0, edges[0].input);
+    TEST_ASSERT_EQUAL(Level::High, edges[0].level);
+    TEST_ASSERT_EQUAL(2, edges[1].input);
+    TEST_ASSERT_EQUAL(Level::High, group->level(2));
+    TEST_ASSERT_EQUAL(Level::Low, group->level(1));
+}
+
+TEST_CASE("Bounces are filtered", "[DebounceGroup]") {
+    esp_err_t err = ESP_OK;
+    std::vector<DebounceEdge> edges;
+    DebounceGroupPtr group = makeGroup(edges, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    const uint32_t pin5 = 1u << 5;
+    for (size_t i = 0; i < 20; i++) {
+        group->sample(std::vector<uint32_t>{(i % 3) == 0 ? 0 : pin5, 0});
+    }
+    TEST_ASSERT_EQUAL(0, edges.size());
+
+    for (size_t i = 0; i < DebounceGroup::kSamplesToSettle; i++) {
+        group->sample(std::vector<uint32_t>{pin5, 0});
+    }
+    for (size_t i = 0; i < DebounceGroup::kSamplesToSettle; i++) {
+        group->sample(std::vector<uint32_t>{0, 0});
+    }
+    TEST_ASSERT_EQUAL(2, edges.size());
+    TEST_ASSERT_EQUAL(1, edges[1].input);
+    TEST_ASSERT_EQUAL(Level::Low, edges[1].level);
+}
+
+TEST_CASE("Debounce on the timer", "[DebounceGroup]") {
+    esp_err_t err = ESP_OK;
+    std::vector<DebounceEdge> edges;
+    DebounceGroupPtr group = makeGroup(edges, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOPtr gpio5 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_5, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    group->start(std::chrono::milliseconds(1), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio5->setLevel(Level::High, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    vTaskDelay(20 / portTICK_PERIOD_MS);
+    group->stop(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    TEST_ASSERT_EQUAL(1, edges.size());
+    TEST_ASSERT_EQUAL(1, edges[0].input);
+    TEST_ASSERT_EQUAL(Level::High, edges[0].level);
+}
+
+TEST_CASE("Invalid debounce group", "[DebounceGroup]") {
+    esp_err_t err = ESP_OK;
+    DebounceGroupPtr group = ESP32::sharedESP32()->debounceGroup({.inputs = {}}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(group);
+}
@@ -0,0 +1,72 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "DedicatedGPIO.hpp"
+#include "ESP32.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace esp;
+
+TEST_CASE("Write and read back a bundle", "[DedicatedGPIOBundle]") {
+    esp_err_t err = ESP_OK;
+    DedicatedGPIOBundlePtr bundle =
+        ESP32::sharedESP32()->dedicatedGPIOBundle({.pins = {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6}, .input = true, .output = true}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(bundle);
+    TEST_ASSERT_EQUAL(3, bundle->width());
+
+    for (uint32_t value = 0; value < 8; value++) {
+        bundle->write(0b111, value);
+        TEST_ASSERT_EQUAL(value, bundle->read());
+    }
+
+    bundle->write(0b010, 0b000);
+    TEST_ASSERT_EQUAL(0b101, bundle->read());
+}
+
+TEST_CASE("Bundle pins are claimed", "[DedicatedGPIOBundle]") {
+    esp_err_t err = ESP_OK;
+    DedicatedGPIOBundlePtr bundle = ESP32::sharedESP32()->dedicatedGPIOBundle({.pins = {GPIO_NUM_4, GPIO_NUM_5}}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOPtr conflict = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_4, GPIOModeInput), err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_NULL(conflict);
+}
+
+TEST_CASE("Invalid bundle configuration", "[DedicatedGPIOBundle]") {
+    esp_err_t err = ESP_OK;
+    DedicatedGPIOBundlePtr bundle = ESP32::sharedESP32()->dedicatedGPIOBundle({.pins = {GPIO_NUM_4}, .input = false, .output = false}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(bundle);
+}
+
+TEST_CASE("DedicatedGPIOBundle benchmark", "[DedicatedGPIOBundle][benchmark]") {
+    constexpr size_t kIterations = 100'000;
+
+    esp_err_t err = ESP_OK;
+    std::chrono::nanoseconds bundleTime{0};
+    {
+        DedicatedGPIOBundlePtr bundle = ESP32::sharedESP32()->dedicatedGPIOBundle({.pins = {GPIO_NUM_4}}, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kIterations; i++) {
+            bundle->write(1, i & 1);
+        }
+        bundleTime = std::chrono::steady_clock::now() - start;
+    }
+
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_4, GPIOModeOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kIterations; i++) {
+        gpio->setLevel((i & 1) != 0 ? Level::High : Level::Low, err);
+    }
+    const std::chrono::nanoseconds pinTime = std::chrono::steady_clock::now() - start;
+
+    printf("dedicated GPIO: %.1f ns per write, setLevel: %.1f ns per write\n", static_cast<double>(bundleTime.count()) / kIterations,
+           static_cast<double>(pinTime.count()) / kIterations);
+}
@@ -2,10 +2,17 @@ extern "C" {
 #include <unity.h>
 }
 #include <freertos/FreeRTOS.h>
+#include <esp_rom_sys.h>
 
 #include "ESP32.hpp"
+#include "EventLoop.hpp"
 #include "GPIO.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
 using namespace esp;
 
 TEST_CASE("Create and destroy", "[GPIO]") {
@@ -168,3 +175,315 @@ TEST_CASE("Set and get GPIO mode", "[GPIO]") {
     TEST_ASSERT_EQUAL(ESP_OK, err);
     TEST_ASSERT(gpio2->mode() == GPIOModeInput);
 }
+
+TEST_CASE("Capture GPIO edges", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio40 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setLevel(esp::Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    gpio40->startCapture({.capacity = 16, .timestampSource = GPIOTimestampSource::Microseconds}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setInterrupt(GPIOInteruptType::AnyEdge, interruptHandler, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+
+    // 30% duty cycle at 1kHz.
+    for (size_t i = 0; i < 5; i++) {
+        gpio40->setLevel(esp::Level::High, err);
+        esp_rom_delay_us(300);
+        gpio40->setLevel(esp::Level::Low, err);
+        esp_rom_delay_us(700);
+    }
+    gpio40->stopCapture(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(0, gpio40->droppedEdges());
+
+    std::optional<std::chrono::nanoseconds> period = gpio40->period();
+    TEST_ASSERT_TRUE(period.has_value());
+    TEST_ASSERT_INT_WITHIN(50'000, 1'000'000, period->count());
+    std::optional<std::chrono::nanoseconds> highWidth = gpio40->pulseWidth(esp::Level::High);
+    TEST_ASSERT_TRUE(highWidth.has_value());
+    TEST_ASSERT_INT_WITHIN(50'000, 300'000, highWidth->count());
+    TEST_ASSERT_FLOAT_WITHIN(50.0f, 1000.0f, gpio40->frequencyHz().value());
+}
+
+TEST_CASE("Capture ring overflow", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio40 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setLevel(esp::Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    gpio40->startCapture({.capacity = 4, .interuptType = GPIOInteruptType::PositiveEdge}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    for (size_t i = 0; i < 10; i++) {
+        gpio40->setLevel(esp::Level::High, err);
+        esp_rom_delay_us(50);
+        gpio40->setLevel(esp::Level::Low, err);
+        esp_rom_delay_us(50);
+    }
+
+    GPIOEdge edges[8];
+    TEST_ASSERT_EQUAL(4, gpio40->readEdges(edges));
+    TEST_ASSERT_EQUAL(6, gpio40->droppedEdges());
+    TEST_ASSERT_EQUAL(esp::Level::High, edges[0].level);
+    gpio40->stopCapture(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("Configure GPIOs in a batch", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr existing = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_4, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    const std::vector<GPIOConfig> configs = {
+        GPIOConfig(GPIO_NUM_5, GPIOModeOutput),
+        GPIOConfig(GPIO_NUM_4, GPIOModeInputOutput),
+        GPIOConfig(GPIO_NUM_6, GPIOModeInput, PullUp::Enable),
+        GPIOConfig(GPIO_NUM_7, GPIOModeOutput),
+    };
+    std::vector<GPIOPtr> gpios = ESP32::sharedESP32()->gpios(configs, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(configs.size(), gpios.size());
+    TEST_ASSERT_EQUAL(existing.get(), gpios[1].get());
+    for (size_t i = 0; i < configs.size(); i++) {
+        TEST_ASSERT_TRUE(gpios[i]->config() == configs[i]);
+    }
+
+    GPIOPtr gpio6 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_6, GPIOModeInput, PullUp::Enable), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(gpios[2].get(), gpio6.get());
+
+    gpios[0]->setLevel(Level::High, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("Invalid GPIO batches", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    const std::vector<GPIOConfig> repeated = {GPIOConfig(GPIO_NUM_5, GPIOModeOutput), GPIOConfig(GPIO_NUM_5, GPIOModeOutput)};
+    std::vector<GPIOPtr> gpios = ESP32::sharedESP32()->gpios(repeated, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_TRUE(gpios.empty());
+
+    for (gpio_num_t pin : {GPIO_NUM_NC, GPIO_NUM_MAX, static_cast<gpio_num_t>(64)}) {
+        const std::vector<GPIOConfig> invalid = {GPIOConfig(GPIO_NUM_5, GPIOModeOutput), GPIOConfig(pin, GPIOModeOutput)};
+        gpios = ESP32::sharedESP32()->gpios(invalid, err);
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+        TEST_ASSERT_TRUE(gpios.empty());
+    }
+
+    GPIOPtr existing = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_4, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    const std::vector<GPIOConfig> conflicting = {GPIOConfig(GPIO_NUM_5, GPIOModeOutput), GPIOConfig(GPIO_NUM_4, GPIOModeInput)};
+    gpios = ESP32::sharedESP32()->gpios(conflicting, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_TRUE(gpios.empty());
+}
+
+TEST_CASE("GPIO batch configuration benchmark", "[GPIO][benchmark]") {
+    std::vector<GPIOConfig> configs;
+    for (int pin = GPIO_NUM_1; pin <= GPIO_NUM_18; pin++) {
+        configs.push_back(GPIOConfig(static_cast<gpio_num_t>(pin), pin % 2 == 0 ? GPIOModeOutput : GPIOModeInput));
+    }
+    for (int pin = GPIO_NUM_38; pin <= GPIO_NUM_42; pin++) {
+        configs.push_back(GPIOConfig(static_cast<gpio_num_t>(pin), GPIOModeInput, PullUp::Enable));
+    }
+
+    esp_err_t err = ESP_OK;
+    std::chrono::microseconds individualTime{0};
+    {
+        std::vector<GPIOPtr> gpios;
+        const auto start = std::chrono::steady_clock::now();
+        for (const GPIOConfig& config : configs) {
+            gpios.push_back(ESP32::sharedESP32()->gpio(config, err));
+            TEST_ASSERT_EQUAL(ESP_OK, err);
+        }
+        individualTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<GPIOPtr> gpios = ESP32::sharedESP32()->gpios(configs, err);
+    const auto batchTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    printf("%zu pins: gpio %lld us, gpios %lld us\n", configs.size(), static_cast<long long>(individualTime.count()),
+           static_cast<long long>(batchTime.count()));
+}
+
+static void countInterrupt(void* userInfo) {
+    static_cast<std::atomic<uint32_t>*>(userInfo)->fetch_add(1);
+}
+
+TEST_CASE("Interrupt budget throttles a chattering pin", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio40 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setLevel(Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::atomic<uint32_t> transitions = 0;
+    EventHandlerInstancePtr handler = EventLoop::defaultEventLoop()->registerHandler(
+        GPIO_INTERRUPT_BUDGET_EVENT, ESP_EVENT_ANY_ID,
+        [&](esp_event_base_t eventBase, int32_t eventId, void* eventData) {
+            (void)eventBase;
+            (void)eventId;
+            if (*static_cast<gpio_num_t*>(eventData) == GPIO_NUM_40) {
+                transitions++;
+            }
+        },
+        err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::atomic<uint32_t> interrupts = 0;
+    gpio40->setInterrupt(GPIOInteruptType::AnyEdge, countInterrupt, &interrupts, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setInterruptBudget(
+        {.maxEdges = 5, .window = std::chrono::milliseconds(100), .coolDown = std::chrono::milliseconds(20)}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    for (size_t i = 0; i < 20; i++) {
+        gpio40->setLevel((i & 1) == 0 ? Level::High : Level::Low, err);
+        esp_rom_delay_us(50);
+    }
+    TEST_ASSERT_EQUAL(5, interrupts.load());
+    TEST_ASSERT_TRUE(gpio40->interruptThrottled());
+    TEST_ASSERT_EQUAL(1, gpio40->interruptThrottles());
+
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    TEST_ASSERT_FALSE(gpio40->interruptThrottled());
+    TEST_ASSERT_EQUAL(2, transitions.load());
+
+    gpio40->setLevel(Level::High, err);
+    esp_rom_delay_us(50);
+    TEST_ASSERT_EQUAL(6, interrupts.load());
+
+    gpio40->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("Interrupt budget delivers a change missed while throttled", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio40 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setLevel(Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // The sixth edge throttles the pin while it's low, and the seventh leaves it high with the interrupt disabled.
+    auto chatter = [&] {
+        for (size_t i = 0; i < 7; i++) {
+            gpio40->setLevel((i & 1) == 0 ? Level::High : Level::Low, err);
+            esp_rom_delay_us(50);
+        }
+    };
+    const GPIOInterruptBudget budget = {.maxEdges = 5, .window = std::chrono::milliseconds(100), .coolDown = std::chrono::milliseconds(20)};
+
+    // A capture records the missed edge as the pin is restored.
+    gpio40->startCapture({.capacity = 16}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setInterruptBudget(budget, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    chatter();
+    TEST_ASSERT_TRUE(gpio40->interruptThrottled());
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    TEST_ASSERT_FALSE(gpio40->interruptThrottled());
+    GPIOEdge edges[16];
+    TEST_ASSERT_EQUAL(6, gpio40->readEdges(edges));
+    TEST_ASSERT_EQUAL(Level::High, edges[5].level);
+    gpio40->stopCapture(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // A plain callback is only called from the ISR, so not for the missed edge.
+    gpio40->setLevel(Level::Low, err);
+    std::atomic<uint32_t> interrupts = 0;
+    gpio40->setInterrupt(GPIOInteruptType::AnyEdge, countInterrupt, &interrupts, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setInterruptBudget(budget, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    chatter();
+    TEST_ASSERT_EQUAL(5, interrupts.load());
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    TEST_ASSERT_FALSE(gpio40->interruptThrottled());
+    TEST_ASSERT_EQUAL(5, interrupts.load());
+    TEST_ASSERT_EQUAL(0, gpio40->failedBudgetEvents());
+
+    gpio40->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("Invalid interrupt budget", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio40 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setInterruptBudget({.maxEdges = 5}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+}
+
+TEST_CASE("GPIO ISR service configuration", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    // Checked before whether the service is installed, so whatever ran before.
+    ESP32::sharedESP32()->setGPIOISRServiceConfig({.priority = 4}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    ESP32::sharedESP32()->setGPIOISRServiceConfig({.coreId = portNUM_PROCESSORS}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+
+    GPIOPtr gpio40 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // Setting an interrupt installs the service, after which its configuration is fixed.
+    std::atomic<uint32_t> interrupts = 0;
+    gpio40->setInterrupt(GPIOInteruptType::PositiveEdge, countInterrupt, &interrupts, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ESP32::sharedESP32()->setGPIOISRServiceConfig({.priority = 1}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    gpio40->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+struct CoreInterrupts {
+    std::atomic<uint32_t> count = 0;
+    std::atomic<BaseType_t> core = -1;
+};
+
+static void recordCore(void* userInfo) {
+    CoreInterrupts* interrupts = static_cast<CoreInterrupts*>(userInfo);
+    interrupts->core = xPortGetCoreID();
+    interrupts->count++;
+}
+
+#if !CONFIG_FREERTOS_UNICORE
+TEST_CASE("GPIO ISR service installed on first interrupt, on its core", "[GPIO]") {
+    esp_err_t err = ESP_OK;
+    GPIO::_uninstallIsrService();
+    ESP32::sharedESP32()->setGPIOISRServiceConfig({.coreId = 1}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOPtr gpio40 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio40->setLevel(Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    // A pin without an interrupt doesn't install the service, so it can still be configured.
+    ESP32::sharedESP32()->setGPIOISRServiceConfig({.coreId = 1}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    CoreInterrupts interrupts;
+    gpio40->setInterrupt(GPIOInteruptType::PositiveEdge, recordCore, &interrupts, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ESP32::sharedESP32()->setGPIOISRServiceConfig({.coreId = 1}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+
+    gpio40->setLevel(Level::High, err);
+    esp_rom_delay_us(50);
+    TEST_ASSERT_EQUAL(1, interrupts.count.load());
+    TEST_ASSERT_EQUAL(1, interrupts.core.load());
+
+    gpio40->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    // Back to the defaults for the tests after this one.
+    GPIO::_uninstallIsrService();
+    ESP32::sharedESP32()->setGPIOISRServiceConfig({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+#endif
@@ -0,0 +1,117 @@
+extern "C" {
+#include <unity.h>
+}
+
+#include "ESP32.hpp"
+#include "GPIOBus.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace esp;
+
+TEST_CASE("Write and read back a bus", "[GPIOBus]") {
+    esp_err_t err = ESP_OK;
+    GPIOBusPtr bus = ESP32::sharedESP32()->gpioBus({.pins = {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6, GPIO_NUM_7}, .mode = GPIOModeInputOutput}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(bus);
+    TEST_ASSERT_EQUAL(4, bus->width());
+
+    for (uint32_t value = 0; value < 16; value++) {
+        bus->write(value);
+        TEST_ASSERT_EQUAL(value, bus->read());
+    }
+
+    bus->write(0b0110, 0b1111);
+    TEST_ASSERT_EQUAL(0b1111, bus->read());
+    bus->write(0b1001, 0b0000);
+    TEST_ASSERT_EQUAL(0b0110, bus->read());
+}
+
+TEST_CASE("Bus spanning both banks", "[GPIOBus]") {
+    esp_err_t err = ESP_OK;
+    GPIOBusPtr bus = ESP32::sharedESP32()->gpioBus({.pins = {GPIO_NUM_38, GPIO_NUM_2, GPIO_NUM_17}, .mode = GPIOModeInputOutput}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    for (uint32_t value = 0; value < 8; value++) {
+        bus->write(value);
+        TEST_ASSERT_EQUAL(value, bus->read());
+    }
+
+    GPIOPtr gpio38 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_38, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    bus->write(0b001);
+    TEST_ASSERT_TRUE(gpio38->level());
+}
+
+TEST_CASE("Bus pins are claimed", "[GPIOBus]") {
+    esp_err_t err = ESP_OK;
+    GPIOBusPtr bus = ESP32::sharedESP32()->gpioBus({.pins = {GPIO_NUM_4, GPIO_NUM_5}, .mode = GPIOModeInputOutput}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOPtr conflict = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_5, GPIOModeInput), err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_NULL(conflict);
+
+    GPIOBusPtr conflictingBus = ESP32::sharedESP32()->gpioBus({.pins = {GPIO_NUM_5, GPIO_NUM_6}, .mode = GPIOModeOutput}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_NULL(conflictingBus);
+}
+
+TEST_CASE("Invalid bus width", "[GPIOBus]") {
+    esp_err_t err = ESP_OK;
+    GPIOBusPtr bus = ESP32::sharedESP32()->gpioBus({.pins = {}}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(bus);
+
+    std::vector<gpio_num_t> pins(GPIOBus::kMaximumWidth + 1, GPIO_NUM_4);
+    bus = ESP32::sharedESP32()->gpioBus({.pins = pins}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(bus);
+
+    // Nothing was claimed, so the pin is still free to configure differently.
+    GPIOPtr gpio4 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_4, GPIOModeInput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("Repeated bus pins", "[GPIOBus]") {
+    esp_err_t err = ESP_OK;
+    GPIOBusPtr bus = ESP32::sharedESP32()->gpioBus({.pins = {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_4}}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(bus);
+
+    GPIOPtr gpio5 = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_5, GPIOModeInput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("GPIOBus benchmark", "[GPIOBus][benchmark]") {
+    constexpr size_t kIterations = 100'000;
+    const std::vector<gpio_num_t> pins = {GPIO_NUM_4, GPIO_NUM_5, GPIO_NUM_6, GPIO_NUM_7, GPIO_NUM_15, GPIO_NUM_16, GPIO_NUM_17, GPIO_NUM_18};
+
+    esp_err_t err = ESP_OK;
+    std::chrono::nanoseconds busTime{0};
+    {
+        GPIOBusPtr bus = ESP32::sharedESP32()->gpioBus({.pins = pins}, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kIterations; i++) {
+            bus->write((i & 1) != 0 ? 0xFF : 0x00);
+        }
+        busTime = std::chrono::steady_clock::now() - start;
+    }
+
+    std::vector<GPIOPtr> gpios;
+    for (gpio_num_t pin : pins) {
+        gpios.push_back(ESP32::sharedESP32()->gpio(GPIOConfig(pin, GPIOModeOutput), err));
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kIterations; i++) {
+        for (GPIOPtr& gpio : gpios) {
+            gpio->setLevel((i & 1) != 0 ? Level::High : Level::Low, err);
+        }
+    }
+    const std::chrono::nanoseconds pinTime = std::chrono::steady_clock::now() - start;
+
+    printf("8 bit bus: %.0f kHz toggle rate, setLevel per pin: %.0f kHz\n", kIterations * 1e6 / busTime.count(), kIterations * 1e6 / pinTime.count());
+}
@@ -0,0 +1,184 @@
+extern "C" {
+#include <unity.h>
+}
+#include <esp_attr.h>
+#include <esp_cpu.h>
+#include <esp_rom_sys.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "ESP32.hpp"
+#include "GPIOFastInterrupts.hpp"
+
+#include <atomic>
+#include <cstdio>
+
+using namespace esp;
+
+static std::atomic<uint32_t> edgeCount = 0;
+static std::atomic<uint32_t> lastEdgeCycles = 0;
+
+static void IRAM_ATTR onFastEdge(gpio_num_t pin, void* userInfo) {
+    (void)pin;
+    (void)userInfo;
+    lastEdgeCycles.store(esp_cpu_get_cycle_count(), std::memory_order_relaxed);
+    edgeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void IRAM_ATTR onServiceEdge(void* userInfo) {
+    onFastEdge(GPIO_NUM_NC, userInfo);
+}
+
+// Average cycles from setting the pin to its callback starting.
+static uint32_t measureLatency(GPIOPtr gpio) {
+    constexpr size_t kSamples = 100;
+    esp_err_t err = ESP_OK;
+    uint64_t total = 0;
+    for (size_t i = 0; i < kSamples; i++) {
+        gpio->setLevel(Level::Low, err);
+        // Let the falling edge's callback land first.
+        esp_rom_delay_us(20);
+        const uint32_t before = edgeCount.load();
+        const uint32_t start = esp_cpu_get_cycle_count();
+        gpio->setLevel(Level::High, err);
+        while (edgeCount.load() == before) {
+        }
+        total += lastEdgeCycles.load() - start;
+    }
+    return static_cast<uint32_t>(total / kSamples);
+}
+
+// Edges handled out of a burst with the given spacing.
+static uint32_t handledEdges(GPIOPtr gpio, uint32_t spacingUs, uint32_t edges) {
+    esp_err_t err = ESP_OK;
+    edgeCount = 0;
+    for (uint32_t i = 0; i < edges; i++) {
+        gpio->setLevel((i & 1) == 0 ? Level::High : Level::Low, err);
+        esp_rom_delay_us(spacingUs);
+    }
+    vTaskDelay(1);
+    return edgeCount.load();
+}
+
+TEST_CASE("Fast interrupts call back on edges", "[GPIOFastInterrupts]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setLevel(Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOFastInterruptsPtr interrupts = ESP32::sharedESP32()->gpioFastInterrupts({.coreId = 1}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(interrupts);
+
+    interrupts->attach(gpio, GPIOInteruptType::AnyEdge, onFastEdge, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(GPIOInteruptType::AnyEdge, gpio->interruptType());
+    TEST_ASSERT_EQUAL(10, handledEdges(gpio, 50, 10));
+
+    interrupts->detach(gpio, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(GPIOInteruptType::Disable, gpio->interruptType());
+    TEST_ASSERT_EQUAL(0, handledEdges(gpio, 50, 10));
+
+    GPIOFastInterruptsPtr second = ESP32::sharedESP32()->gpioFastInterrupts({}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_NULL(second);
+}
+
+TEST_CASE("Fast interrupts need the ISR service to be unused", "[GPIOFastInterrupts]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setInterrupt(GPIOInteruptType::PositiveEdge, onServiceEdge, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOFastInterruptsPtr interrupts = ESP32::sharedESP32()->gpioFastInterrupts({}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    TEST_ASSERT_NULL(interrupts);
+
+    gpio->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+static std::atomic<bool> inSlowCallback = false;
+
+static void IRAM_ATTR onSlowEdge(gpio_num_t pin, void* userInfo) {
+    inSlowCallback = true;
+    esp_rom_delay_us(20);
+    onFastEdge(pin, userInfo);
+    inSlowCallback = false;
+}
+
+struct Toggler {
+    GPIOPtr gpio;
+    std::atomic<bool> running = true;
+    TaskHandle_t waiting = nullptr;
+};
+
+static void togglerTask(void* userInfo) {
+    Toggler* toggler = static_cast<Toggler*>(userInfo);
+    esp_err_t err = ESP_OK;
+    for (uint32_t i = 0; toggler->running; i++) {
+        toggler->gpio->setLevel((i & 1) == 0 ? Level::High : Level::Low, err);
+        esp_rom_delay_us(5);
+    }
+    xTaskNotifyGive(toggler->waiting);
+    vTaskDelete(nullptr);
+}
+
+TEST_CASE("Fast interrupts detach waits for a callback in flight", "[GPIOFastInterrupts]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    GPIOFastInterruptsPtr interrupts = ESP32::sharedESP32()->gpioFastInterrupts({.coreId = 1}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    interrupts->attach(gpio, GPIOInteruptType::AnyEdge, onSlowEdge, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // Edges come faster than the callback returns, so the ISR on core 1 is nearly always inside it when detach runs on core 0.
+    edgeCount = 0;
+    Toggler toggler = {.gpio = gpio, .waiting = xTaskGetCurrentTaskHandle()};
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(togglerTask, "TestToggler", 2048, &toggler, 1, nullptr, 0));
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+
+    interrupts->detach(gpio, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_FALSE(inSlowCallback.load());
+    const uint32_t edges = edgeCount.load();
+    TEST_ASSERT_GREATER_THAN(0, edges);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(edges, edgeCount.load());
+
+    toggler.running = false;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+TEST_CASE("GPIO interrupt latency benchmark", "[GPIOFastInterrupts][benchmark]") {
+    constexpr uint32_t kEdges = 1000;
+    constexpr uint32_t kSpacingsUs[] = {20, 10, 5, 2, 1};
+
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    gpio->setInterrupt(GPIOInteruptType::AnyEdge, onServiceEdge, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    printf("ISR service: %lu cycles latency\n", static_cast<unsigned long>(measureLatency(gpio)));
+    for (uint32_t spacing : kSpacingsUs) {
+        printf("ISR service: %lu of %lu edges at %lu us\n", static_cast<unsigned long>(handledEdges(gpio, spacing, kEdges)),
+               static_cast<unsigned long>(kEdges), static_cast<unsigned long>(spacing));
+    }
+    gpio->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOFastInterruptsPtr interrupts = ESP32::sharedESP32()->gpioFastInterrupts({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    interrupts->attach(gpio, GPIOInteruptType::AnyEdge, onFastEdge, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    printf("fast: %lu cycles latency\n", static_cast<unsigned long>(measureLatency(gpio)));
+    for (uint32_t spacing : kSpacingsUs) {
+        printf("fast: %lu of %lu edges at %lu us\n", static_cast<unsigned long>(handledEdges(gpio, spacing, kEdges)),
+               static_cast<unsigned long>(kEdges), static_cast<unsigned long>(spacing));
+    }
+}
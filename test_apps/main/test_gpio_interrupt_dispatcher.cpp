@@ -0,0 +1,99 @@
+extern "C" {
+#include <unity.h>
+}
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+
+#include "ESP32.hpp"
+#include "EventLoop.hpp"
+#include "GPIOInterruptDispatcher.hpp"
+
+using namespace esp;
+
+struct DeferredCounts {
+    size_t calls = 0;
+    uint32_t edges = 0;
+    std::chrono::microseconds lastEdgeTime{0};
+};
+
+static void countDeferred(GPIO& gpio, const GPIODeferredInterrupt& interrupt, void* userInfo) {
+    (void)gpio;
+    DeferredCounts* counts = static_cast<DeferredCounts*>(userInfo);
+    counts->calls++;
+    counts->edges += interrupt.edges;
+    counts->lastEdgeTime = interrupt.lastEdgeTime;
+}
+
+static void toggle(GPIOPtr gpio, size_t edges) {
+    esp_err_t err = ESP_OK;
+    for (size_t i = 0; i < edges; i++) {
+        gpio->setLevel((i & 1) == 0 ? Level::High : Level::Low, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+}
+
+TEST_CASE("Bursts are coalesced into one dispatch", "[GPIOInterruptDispatcher]") {
+    esp_err_t err = ESP_OK;
+    // Below the test task, so the whole burst lands before the dispatcher gets to run.
+    GPIOInterruptDispatcherPtr dispatcher =
+        ESP32::sharedESP32()->gpioInterruptDispatcher({.taskInfo = TaskInfo{.name = "TestGPIODispatch", .priority = 1, .stackSize = 4096}}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(dispatcher);
+
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setLevel(Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    DeferredCounts counts;
+    gpio->setDeferredInterrupt(GPIOInteruptType::AnyEdge, dispatcher, countDeferred, &counts, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    const int64_t start = esp_timer_get_time();
+    toggle(gpio, 10);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(1, counts.calls);
+    TEST_ASSERT_EQUAL(10, counts.edges);
+    TEST_ASSERT_GREATER_OR_EQUAL(start, counts.lastEdgeTime.count());
+
+    toggle(gpio, 2);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(2, counts.calls);
+    TEST_ASSERT_EQUAL(12, counts.edges);
+
+    gpio->setInterrupt(GPIOInteruptType::Disable, nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    toggle(gpio, 2);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(2, counts.calls);
+}
+
+TEST_CASE("Dispatch on an event loop", "[GPIOInterruptDispatcher]") {
+    esp_err_t err = ESP_OK;
+    EventLoopPtr loop = EventLoop::eventLoop(EventLoopConfig{.queueSize = 10, .taskInfo = TaskInfo{.name = "TestGPIODispatchLoop"}}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    GPIOInterruptDispatcherPtr dispatcher = ESP32::sharedESP32()->gpioInterruptDispatcher({.eventLoop = loop}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setLevel(Level::Low, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    DeferredCounts counts;
+    gpio->setDeferredInterrupt(GPIOInteruptType::PositiveEdge, dispatcher, countDeferred, &counts, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    toggle(gpio, 6);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, counts.calls);
+    TEST_ASSERT_EQUAL(3, counts.edges);
+    TEST_ASSERT_EQUAL(0, dispatcher->failedWakes());
+}
+
+TEST_CASE("Invalid dispatcher configuration", "[GPIOInterruptDispatcher]") {
+    esp_err_t err = ESP_OK;
+    GPIOInterruptDispatcherPtr dispatcher = ESP32::sharedESP32()->gpioInterruptDispatcher({}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(dispatcher);
+}
@@ -1,9 +1,13 @@
 extern "C" {
 #include <unity.h>
 }
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 #include "GPTimer.hpp"
 
+#include <atomic>
+
 using namespace esp;
 
 InterruptResult gpTimerCallback(GPTimer& timer, const gptimer_alarm_event_data_t& eventData, void* userInfo) {
@@ -13,10 +17,88 @@ InterruptResult gpTimerCallback(GPTimer& timer, const gptimer_alarm_event_data_t
 TEST_CASE("Create and destroy", "[GPTimer]") {
     esp_err_t err = ESP_OK;
     const GPTimerConfig timerConfig = {
-        .durationMicroseconds = 1'000,
-        .callback = gpTimerCallback
+        .callback = gpTimerCallback,
+        .alarm = GPTimerAlarm{.alarmCount = 1'000}
     };
     GPTimerPtr timer = std::make_shared<GPTimer>(timerConfig, nullptr, err);
     TEST_ASSERT_EQUAL(err, ESP_OK);
     TEST_ASSERT_NOT_NULL(timer);
 }
+
+struct Alarms {
+    std::atomic<uint32_t> count = 0;
+    // Alarm counts to switch to, one per alarm, for varying the period at runtime.
+    const uint64_t* schedule = nullptr;
+    size_t scheduleLength = 0;
+};
+
+static IRAM_ATTR InterruptResult countAlarm(GPTimer& timer, const gptimer_alarm_event_data_t& eventData, void* userInfo) {
+    Alarms* alarms = static_cast<Alarms*>(userInfo);
+    const uint32_t count = alarms->count++;
+    if (count < alarms->scheduleLength) {
+        esp_err_t err = ESP_OK;
+        timer.setAlarm({.alarmCount = eventData.alarm_value + alarms->schedule[count], .autoReload = false}, err);
+    }
+    return InterruptResult::NoHighPriorityTaskWoken;
+}
+
+TEST_CASE("High resolution GPTimer ticks at 100kHz", "[GPTimer]") {
+    esp_err_t err = ESP_OK;
+    Alarms alarms;
+    // 10MHz, so each alarm is 100 ticks of 100ns.
+    GPTimerPtr timer = std::make_shared<GPTimer>(
+        GPTimerConfig{.callback = countAlarm, .resolutionHz = 10'000'000, .alarm = GPTimerAlarm{.alarmCount = 100}}, &alarms, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(10'000'000, timer->resolution(err));
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    timer->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+    timer->stop(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    TEST_ASSERT_UINT32_WITHIN(1000, 10'000, alarms.count.load());
+}
+
+TEST_CASE("GPTimer alarm changed from its callback", "[GPTimer]") {
+    esp_err_t err = ESP_OK;
+    static constexpr uint64_t kSchedule[] = {200, 300, 400};
+    Alarms alarms = {.schedule = kSchedule, .scheduleLength = std::size(kSchedule)};
+    GPTimerPtr timer = std::make_shared<GPTimer>(
+        GPTimerConfig{.callback = countAlarm, .alarm = GPTimerAlarm{.alarmCount = 100, .autoReload = false}}, &alarms, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    timer->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    vTaskDelay(20 / portTICK_PERIOD_MS);
+    timer->stop(err);
+
+    // The last alarm was at 100 + 200 + 300 + 400 without reloading, and nothing was set after it.
+    TEST_ASSERT_EQUAL(4, alarms.count.load());
+    TEST_ASSERT_GREATER_OR_EQUAL(1000, timer->count(err));
+}
+
+TEST_CASE("GPTimer count", "[GPTimer]") {
+    esp_err_t err = ESP_OK;
+    GPTimerPtr timer = std::make_shared<GPTimer>(GPTimerConfig{.callback = nullptr, .direction = GPTimerDirection::Down}, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    timer->setCount(1'000'000, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(1'000'000, timer->count(err));
+
+    timer->start(err);
+    vTaskDelay(10 / portTICK_PERIOD_MS);
+    timer->stop(err);
+    // Counting down at 1MHz.
+    const uint64_t count = timer->count(err);
+    TEST_ASSERT_LESS_THAN(1'000'000, count);
+    TEST_ASSERT_GREATER_THAN(900'000, count);
+}
+
+TEST_CASE("GPTimer resolution beyond its clock", "[GPTimer]") {
+    esp_err_t err = ESP_OK;
+    GPTimerPtr timer = std::make_shared<GPTimer>(GPTimerConfig{.callback = nullptr, .resolutionHz = 1'000'000'000}, nullptr, err);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, err);
+}
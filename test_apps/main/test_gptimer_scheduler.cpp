@@ -0,0 +1,235 @@
+extern "C" {
+#include <unity.h>
+}
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "ESP32.hpp"
+#include "GPTimerScheduler.hpp"
+
+#include <atomic>
+#include <cstdio>
+
+using namespace esp;
+
+struct Dispatches {
+    std::atomic<uint32_t> count = 0;
+    uint64_t scheduled[32] = {};
+    uint64_t dispatched[32] = {};
+    // Scheduled from the callback for this many ticks after the event that had it, or 0 for none.
+    uint64_t followUp = 0;
+};
+
+static IRAM_ATTR InterruptResult onEvent(GPTimerScheduler& scheduler, uint64_t count, void* userInfo) {
+    Dispatches* dispatches = static_cast<Dispatches*>(userInfo);
+    const uint32_t i = dispatches->count;
+    if (i < std::size(dispatches->scheduled)) {
+        dispatches->scheduled[i] = count;
+        dispatches->dispatched[i] = scheduler.count();
+    }
+    dispatches->count = i + 1;
+
+    if (dispatches->followUp != 0) {
+        esp_err_t err = ESP_OK;
+        scheduler.scheduleAt(count + dispatches->followUp, onEvent, dispatches, err);
+        dispatches->followUp = 0;
+    }
+    return InterruptResult::NoHighPriorityTaskWoken;
+}
+
+// A counter that only moves when told to, taking setAlarmTicks to program each alarm.  As with the hardware, an alarm only fires when
+// the counter reaches it, so one set for a count that has already passed never does.
+struct FakeCounter {
+    GPTimerScheduler* scheduler = nullptr;
+    uint64_t now = 0;
+    uint64_t alarm = UINT64_MAX;
+    uint64_t setAlarmTicks = 0;
+    uint32_t alarmsSet = 0;
+    uint32_t alarmsFired = 0;
+
+    explicit FakeCounter(GPTimerScheduler& scheduler) : scheduler(&scheduler) {
+        scheduler.setPort({.count = count, .setAlarm = setAlarm, .context = this});
+    }
+
+    static uint64_t IRAM_ATTR count(void* context) { return static_cast<FakeCounter*>(context)->now; }
+
+    static void IRAM_ATTR setAlarm(void* context, uint64_t alarmCount) {
+        FakeCounter* fake = static_cast<FakeCounter*>(context);
+        fake->now += fake->setAlarmTicks;
+        fake->alarm = alarmCount;
+        fake->alarmsSet++;
+    }
+
+    void advance(uint64_t count) {
+        while (now < count) {
+            now++;
+            if (now == alarm) {
+                alarmsFired++;
+                scheduler->fireAlarm();
+            }
+        }
+    }
+};
+
+TEST_CASE("GPTimer scheduler on a fake counter", "[GPTimerScheduler]") {
+    esp_err_t err = ESP_OK;
+    GPTimerSchedulerPtr scheduler = ESP32::sharedESP32()->gpTimerScheduler({.capacity = 4}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    FakeCounter fake(*scheduler);
+
+    Dispatches dispatches;
+    scheduler->scheduleAt(100, onEvent, &dispatches, err);
+    scheduler->scheduleAt(50, onEvent, &dispatches, err);
+    scheduler->scheduleAt(300, onEvent, &dispatches, err);
+    const GPTimerEventHandle cancelled = scheduler->scheduleAt(200, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    scheduler->scheduleAt(400, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, err);
+    TEST_ASSERT_EQUAL(50, fake.alarm);
+
+    TEST_ASSERT_TRUE(scheduler->cancel(cancelled));
+    TEST_ASSERT_FALSE(scheduler->cancel(cancelled));
+    TEST_ASSERT_EQUAL(3, scheduler->pendingEvents());
+
+    fake.advance(99);
+    TEST_ASSERT_EQUAL(1, dispatches.count.load());
+    TEST_ASSERT_EQUAL(50, dispatches.scheduled[0]);
+    TEST_ASSERT_EQUAL(100, fake.alarm);
+    fake.advance(100);
+    TEST_ASSERT_EQUAL(2, dispatches.count.load());
+    TEST_ASSERT_EQUAL(100, dispatches.scheduled[1]);
+
+    // Nothing dispatched for the cancelled event at 200.
+    fake.advance(250);
+    TEST_ASSERT_EQUAL(2, dispatches.count.load());
+    fake.advance(1000);
+    TEST_ASSERT_EQUAL(3, dispatches.count.load());
+    TEST_ASSERT_EQUAL(300, dispatches.scheduled[2]);
+    TEST_ASSERT_EQUAL(0, scheduler->pendingEvents());
+
+    GPTimerSchedulerStats stats = scheduler->stats();
+    TEST_ASSERT_EQUAL(3, stats.dispatched);
+    TEST_ASSERT_EQUAL(0, stats.scheduledLate);
+    TEST_ASSERT_EQUAL(0, stats.totalLatency);
+
+    // Scheduled in the past, and a follow up already due by the time its callback schedules it, both go out with the next alarm.
+    scheduler->resetStats();
+    dispatches.followUp = 1;
+    scheduler->scheduleAt(500, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(1002, fake.alarm);
+    fake.advance(1010);
+    TEST_ASSERT_EQUAL(5, dispatches.count.load());
+    TEST_ASSERT_EQUAL(1002, dispatches.dispatched[3]);
+    TEST_ASSERT_EQUAL(1002, dispatches.dispatched[4]);
+    TEST_ASSERT_EQUAL(0, scheduler->pendingEvents());
+    stats = scheduler->stats();
+    TEST_ASSERT_EQUAL(2, stats.dispatched);
+    TEST_ASSERT_EQUAL(2, stats.scheduledLate);
+    TEST_ASSERT_EQUAL(502 + 501, stats.totalLatency);
+}
+
+TEST_CASE("GPTimer scheduler moves the alarm for an earlier event", "[GPTimerScheduler]") {
+    esp_err_t err = ESP_OK;
+    GPTimerSchedulerPtr scheduler = ESP32::sharedESP32()->gpTimerScheduler({.capacity = 4}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    FakeCounter fake(*scheduler);
+
+    Dispatches dispatches;
+    scheduler->scheduleAt(1000, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(1000, fake.alarm);
+    fake.advance(400);
+
+    // Earlier than the alarm already set, so the alarm moves.  A later one leaves it alone.
+    scheduler->scheduleAt(600, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(600, fake.alarm);
+    scheduler->scheduleAt(800, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(600, fake.alarm);
+    TEST_ASSERT_EQUAL(2, fake.alarmsSet);
+
+    // Only just ahead of the counter, so the alarm is set no closer than the minimum lead and the event goes out a tick late.
+    scheduler->scheduleAt(401, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(402, fake.alarm);
+
+    fake.advance(2000);
+    TEST_ASSERT_EQUAL(4, dispatches.count.load());
+    const uint64_t expected[][2] = {{401, 402}, {600, 600}, {800, 800}, {1000, 1000}};
+    for (size_t i = 0; i < std::size(expected); i++) {
+        TEST_ASSERT_EQUAL(expected[i][0], dispatches.scheduled[i]);
+        TEST_ASSERT_EQUAL(expected[i][1], dispatches.dispatched[i]);
+    }
+    TEST_ASSERT_EQUAL(4, fake.alarmsFired);
+}
+
+TEST_CASE("GPTimer scheduler dispatches an event that comes due while setting the alarm", "[GPTimerScheduler]") {
+    esp_err_t err = ESP_OK;
+    GPTimerSchedulerPtr scheduler = ESP32::sharedESP32()->gpTimerScheduler({.capacity = 4}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    FakeCounter fake(*scheduler);
+    fake.setAlarmTicks = 5;
+
+    Dispatches dispatches;
+    scheduler->scheduleAt(100, onEvent, &dispatches, err);
+    scheduler->scheduleAt(103, onEvent, &dispatches, err);
+    scheduler->scheduleAt(200, onEvent, &dispatches, err);
+    TEST_ASSERT_EQUAL(1, fake.alarmsSet);
+
+    // After the event at 100 the alarm for 103 is passed while it's being set, and so is the one 4 ticks ahead.  The alarm 8 ticks
+    // ahead holds, by when 103 is due, so it goes out from the same interrupt, and the alarm is set again for 200.
+    fake.advance(100);
+    TEST_ASSERT_EQUAL(1, fake.alarmsFired);
+    TEST_ASSERT_EQUAL(2, dispatches.count.load());
+    TEST_ASSERT_EQUAL(100, dispatches.dispatched[0]);
+    TEST_ASSERT_EQUAL(103, dispatches.scheduled[1]);
+    TEST_ASSERT_EQUAL(115, dispatches.dispatched[1]);
+    TEST_ASSERT_EQUAL(5, fake.alarmsSet);
+    TEST_ASSERT_EQUAL(200, fake.alarm);
+    TEST_ASSERT_EQUAL(1, scheduler->pendingEvents());
+
+    fake.advance(300);
+    TEST_ASSERT_EQUAL(2, fake.alarmsFired);
+    TEST_ASSERT_EQUAL(3, dispatches.count.load());
+    TEST_ASSERT_EQUAL(200, dispatches.dispatched[2]);
+}
+
+TEST_CASE("GPTimer scheduler dispatches events close together", "[GPTimerScheduler][benchmark]") {
+    esp_err_t err = ESP_OK;
+    // 10MHz, so events 100ns apart.
+    GPTimerSchedulerPtr scheduler = ESP32::sharedESP32()->gpTimerScheduler({.resolutionHz = 10'000'000}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    scheduler->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // Scheduled out of order, some a few ticks apart and some well apart.
+    Dispatches dispatches;
+    static constexpr uint64_t kOffsets[] = {5'000, 1'000, 1'003, 20'000, 1'001, 50'000, 5'010, 1'002, 100'000, 20'100};
+    const uint64_t start = scheduler->count();
+    for (uint64_t offset : kOffsets) {
+        scheduler->scheduleAt(start + offset, onEvent, &dispatches, err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    scheduler->stop(err);
+
+    TEST_ASSERT_EQUAL(std::size(kOffsets), dispatches.count.load());
+    for (size_t i = 0; i < std::size(kOffsets); i++) {
+        TEST_ASSERT_GREATER_OR_EQUAL(dispatches.scheduled[i], dispatches.dispatched[i]);
+        if (i > 0) {
+            TEST_ASSERT_GREATER_OR_EQUAL(dispatches.scheduled[i - 1], dispatches.scheduled[i]);
+        }
+    }
+
+    const GPTimerSchedulerStats stats = scheduler->stats();
+    TEST_ASSERT_EQUAL(std::size(kOffsets), stats.dispatched);
+    printf("GPTimer scheduler latency at 10MHz: mean %llu ticks, worst %llu ticks\n",
+           static_cast<unsigned long long>(stats.totalLatency / stats.dispatched), static_cast<unsigned long long>(stats.worstLatency));
+    // Within 20us of every event, even those a tick apart.
+    TEST_ASSERT_LESS_THAN(200, stats.worstLatency);
+}
+
+TEST_CASE("GPTimer scheduler with no capacity", "[GPTimerScheduler]") {
+    esp_err_t err = ESP_OK;
+    GPTimerSchedulerPtr scheduler = ESP32::sharedESP32()->gpTimerScheduler({.capacity = 0}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(scheduler);
+}
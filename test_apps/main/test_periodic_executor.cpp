@@ -0,0 +1,132 @@
+extern "C" {
+#include <unity.h>
+}
+#include <esp_rom_sys.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "ESP32.hpp"
+#include "PeriodicExecutor.hpp"
+
+#include <atomic>
+#include <chrono>
+
+using namespace esp;
+using namespace std::chrono_literals;
+
+struct Runs {
+    std::atomic<uint32_t> count = 0;
+    std::atomic<uint32_t> periods = 0;
+    std::atomic<int64_t> firstTime = 0;
+    std::atomic<int64_t> lastTime = 0;
+    // Busy waits this long in the run that takes count to overrunAt.
+    uint32_t overrunAt = 0;
+    uint32_t overrunMicros = 0;
+};
+
+static void onRun(PeriodicExecutor& executor, uint32_t periods, void* userInfo) {
+    (void)executor;
+    Runs* runs = static_cast<Runs*>(userInfo);
+    const int64_t now = Timer::now().count();
+    if (runs->count == 0) {
+        runs->firstTime = now;
+    }
+    runs->lastTime = now;
+    runs->periods += periods;
+    if (++runs->count == runs->overrunAt) {
+        esp_rom_delay_us(runs->overrunMicros);
+    }
+}
+
+TEST_CASE("Periodic executor keeps to absolute deadlines", "[PeriodicExecutor]") {
+    esp_err_t err = ESP_OK;
+    Runs runs;
+    PeriodicExecutorPtr executor = ESP32::sharedESP32()->periodicExecutor({.period = 5ms, .callback = onRun, .userInfo = &runs}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(executor);
+
+    executor->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    executor->start(err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+
+    vTaskDelay(200 / portTICK_PERIOD_MS);
+    executor->stop();
+    TEST_ASSERT_FALSE(executor->isRunning());
+
+    // However late individual runs are, the last stays on the grid started by the first.
+    const uint32_t count = runs.count;
+    TEST_ASSERT_UINT32_WITHIN(2, 40, count);
+    const int64_t drift = runs.lastTime - runs.firstTime - int64_t(count - 1) * 5000;
+    TEST_ASSERT_INT_WITHIN(1000, 0, static_cast<int>(drift));
+    TEST_ASSERT_EQUAL(0, executor->stats().missedDeadlines);
+}
+
+static PeriodicExecutorStats overrun(OverrunPolicy policy, Runs& runs) {
+    esp_err_t err = ESP_OK;
+    runs.overrunAt = 3;
+    // Passes the next two deadlines.
+    runs.overrunMicros = 5500;
+    PeriodicExecutorPtr executor =
+        ESP32::sharedESP32()->periodicExecutor({.period = 2ms, .callback = onRun, .userInfo = &runs, .overrunPolicy = policy}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    executor->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    executor->stop();
+    return executor->stats();
+}
+
+TEST_CASE("Periodic executor overrun policies", "[PeriodicExecutor]") {
+    Runs skipped;
+    PeriodicExecutorStats stats = overrun(OverrunPolicy::Skip, skipped);
+    TEST_ASSERT_GREATER_OR_EQUAL(2, stats.missedDeadlines);
+    TEST_ASSERT_GREATER_OR_EQUAL(2000, stats.worstLateness.count());
+    TEST_ASSERT_EQUAL(skipped.count.load(), skipped.periods.load());
+
+    Runs caughtUp;
+    stats = overrun(OverrunPolicy::CatchUp, caughtUp);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, stats.missedDeadlines);
+    // Every deadline got its run.
+    TEST_ASSERT_GREATER_THAN(skipped.count.load(), caughtUp.count.load());
+
+    Runs coalesced;
+    stats = overrun(OverrunPolicy::Coalesce, coalesced);
+    TEST_ASSERT_GREATER_OR_EQUAL(2, stats.missedDeadlines);
+    // The periods passed to the callback account for the missed deadlines.
+    TEST_ASSERT_GREATER_THAN(coalesced.count.load(), coalesced.periods.load());
+}
+
+TEST_CASE("Harmonic executors share a clock", "[PeriodicExecutor]") {
+    esp_err_t err = ESP_OK;
+    PeriodicClockPtr clock = ESP32::sharedESP32()->periodicClock({.basePeriod = 5ms}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    Runs fast;
+    Runs slow;
+    PeriodicExecutorPtr fastExecutor =
+        ESP32::sharedESP32()->periodicExecutor({.period = 5ms, .callback = onRun, .userInfo = &fast, .clock = clock}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    PeriodicExecutorPtr slowExecutor =
+        ESP32::sharedESP32()->periodicExecutor({.period = 20ms, .callback = onRun, .userInfo = &slow, .clock = clock}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    PeriodicExecutorPtr invalid = ESP32::sharedESP32()->periodicExecutor({.period = 7ms, .callback = onRun, .userInfo = &slow, .clock = clock}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(invalid);
+
+    fastExecutor->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    esp_rom_delay_us(2000);
+    slowExecutor->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    // Both on the clock's grid, so the slow executor's deadlines are among the fast one's.
+    TEST_ASSERT_EQUAL(0, (slowExecutor->nextDeadline() - fastExecutor->nextDeadline()).count() % 5000);
+
+    vTaskDelay(100 / portTICK_PERIOD_MS);
+    fastExecutor->stop();
+    slowExecutor->stop();
+    TEST_ASSERT_UINT32_WITHIN(2, 20, fast.count.load());
+    TEST_ASSERT_UINT32_WITHIN(1, 5, slow.count.load());
+}
@@ -0,0 +1,201 @@
+extern "C" {
+#include <unity.h>
+}
+#include <esp_attr.h>
+#include <esp_rom_sys.h>
+
+#include "ESP32.hpp"
+#include "PCNT/PulseCounter.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+using namespace esp;
+using namespace esp::pcnt;
+
+static std::atomic<int64_t> watchedPosition = 0;
+
+static InterruptResult IRAM_ATTR onWatchPoint(int watchPoint, int64_t position, void* userInfo) {
+    (void)watchPoint;
+    (void)userInfo;
+    watchedPosition = position;
+    return InterruptResult::NoHighPriorityTaskWoken;
+}
+
+static void pulse(GPIOPtr gpio, size_t pulses) {
+    esp_err_t err = ESP_OK;
+    for (size_t i = 0; i < pulses; i++) {
+        gpio->setLevel(Level::High, err);
+        esp_rom_delay_us(5);
+        gpio->setLevel(Level::Low, err);
+        esp_rom_delay_us(5);
+    }
+}
+
+TEST_CASE("Pulse counter extends past its limits", "[PulseCounter]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setLevel(Level::Low, err);
+
+    PulseCounterPtr counter = ESP32::sharedESP32()->pulseCounter({.lowLimit = -10, .highLimit = 10}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(counter);
+    ChannelPtr channel = counter->addChannel({.edgeGPIO = GPIO_NUM_40}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    channel->setEdgeAction(EdgeAction::Increase, EdgeAction::Hold, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    counter->addWatchPoint(5, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    counter->addWatchPoint(10, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    counter->setWatchPointCallback(onWatchPoint, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    counter->enable(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    counter->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    pulse(gpio, 37);
+    TEST_ASSERT_EQUAL(37, counter->position());
+    TEST_ASSERT_EQUAL(35, watchedPosition.load());
+
+    channel->setEdgeAction(EdgeAction::Decrease, EdgeAction::Hold, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    pulse(gpio, 60);
+    TEST_ASSERT_EQUAL(-23, counter->position());
+
+    counter->clear(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(0, counter->position());
+
+    counter->setWatchPointCallback(nullptr, nullptr, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    counter->setGlitchFilter(1000, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, err);
+    counter->disable(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+}
+
+TEST_CASE("Pulse counter position with a limit interrupt pending", "[PulseCounter]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setLevel(Level::Low, err);
+
+    PulseCounterPtr counter = ESP32::sharedESP32()->pulseCounter({.lowLimit = -10, .highLimit = 10}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ChannelPtr channel = counter->addChannel({.edgeGPIO = GPIO_NUM_40}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    channel->setEdgeAction(EdgeAction::Increase, EdgeAction::Hold, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    counter->enable(err);
+    counter->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    pulse(gpio, 9);
+    TEST_ASSERT_EQUAL(9, counter->position());
+
+    // With interrupts held off on this core, the core the unit's interrupt was allocated on, the count wraps at 10 and the
+    // extension stays behind.
+    portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+    portENTER_CRITICAL(&lock);
+    pulse(gpio, 3);
+    const int64_t pending = counter->position();
+    const int64_t pendingAgain = counter->position();
+    portEXIT_CRITICAL(&lock);
+    TEST_ASSERT_EQUAL(12, pending);
+    TEST_ASSERT_EQUAL(12, pendingAgain);
+    TEST_ASSERT_EQUAL(12, counter->position());
+
+    // From -9 the count wraps at -10 to 0 and goes on to -2.
+    counter->clear(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    channel->setEdgeAction(EdgeAction::Decrease, EdgeAction::Hold, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    pulse(gpio, 9);
+    TEST_ASSERT_EQUAL(-9, counter->position());
+    portENTER_CRITICAL(&lock);
+    pulse(gpio, 3);
+    const int64_t pendingLow = counter->position();
+    portEXIT_CRITICAL(&lock);
+    TEST_ASSERT_EQUAL(-12, pendingLow);
+    TEST_ASSERT_EQUAL(-12, counter->position());
+}
+
+TEST_CASE("Pulse counter position after reversing between reads", "[PulseCounter]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setLevel(Level::Low, err);
+
+    PulseCounterPtr counter = ESP32::sharedESP32()->pulseCounter({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ChannelPtr channel = counter->addChannel({.edgeGPIO = GPIO_NUM_40}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    channel->setEdgeAction(EdgeAction::Increase, EdgeAction::Hold, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    counter->enable(err);
+    counter->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // Back by more than half the high limit without reaching the low one, as an encoder reversing does.
+    pulse(gpio, 20000);
+    TEST_ASSERT_EQUAL(20000, counter->position());
+    channel->setEdgeAction(EdgeAction::Decrease, EdgeAction::Hold, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    pulse(gpio, 17000);
+    TEST_ASSERT_EQUAL(3000, counter->position());
+}
+
+TEST_CASE("Pulse counter glitch filter", "[PulseCounter]") {
+    esp_err_t err = ESP_OK;
+    GPIOPtr gpio = ESP32::sharedESP32()->gpio(GPIOConfig(GPIO_NUM_40, GPIOModeInputOutput), err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    gpio->setLevel(Level::Low, err);
+
+    PulseCounterPtr counter = ESP32::sharedESP32()->pulseCounter({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    ChannelPtr channel = counter->addChannel({.edgeGPIO = GPIO_NUM_40}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    channel->setEdgeAction(EdgeAction::Increase, EdgeAction::Hold, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    counter->setGlitchFilter(1000, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    counter->enable(err);
+    counter->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    // Pulses a few hundred nanoseconds wide are filtered out, 5 microsecond ones are counted.
+    for (size_t i = 0; i < 10; i++) {
+        gpio->setLevel(Level::High, err);
+        gpio->setLevel(Level::Low, err);
+    }
+    TEST_ASSERT_EQUAL(0, counter->position());
+    pulse(gpio, 10);
+    TEST_ASSERT_EQUAL(10, counter->position());
+}
+
+TEST_CASE("Pulse counter position benchmark", "[PulseCounter][benchmark]") {
+    constexpr size_t kReads = 10000;
+
+    esp_err_t err = ESP_OK;
+    PulseCounterPtr counter = ESP32::sharedESP32()->pulseCounter({}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    counter->enable(err);
+    counter->start(err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    int64_t sum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kReads; i++) {
+        sum += counter->position();
+    }
+    const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    TEST_ASSERT_EQUAL(0, sum);
+
+    printf("position: %lld ns per read\n", static_cast<long long>(elapsed.count() / kReads));
+}
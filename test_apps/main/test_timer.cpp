@@ -0,0 +1,226 @@
+extern "C" {
+#include <unity.h>
+}
+#include <esp_rom_sys.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "ESP32.hpp"
+#include "Timer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+using namespace esp;
+using namespace std::chrono_literals;
+
+static void busyCallback(Timer& timer, void* userInfo) {
+    (void)timer;
+    (void)userInfo;
+    esp_rom_delay_us(200);
+}
+
+TEST_CASE("Timer histogram buckets", "[Timer]") {
+    TimerHistogram histogram;
+    TEST_ASSERT_EQUAL(0, histogram.mean().count());
+
+    histogram.record(0us);
+    histogram.record(1us);
+    histogram.record(3us);
+    histogram.record(100us);
+    TEST_ASSERT_EQUAL(4, histogram.count);
+    TEST_ASSERT_EQUAL(1, histogram.buckets[0]);
+    TEST_ASSERT_EQUAL(1, histogram.buckets[1]);
+    TEST_ASSERT_EQUAL(1, histogram.buckets[2]);
+    TEST_ASSERT_EQUAL(1, histogram.buckets[7]);
+    TEST_ASSERT_EQUAL(0, histogram.min.count());
+    TEST_ASSERT_EQUAL(100, histogram.max.count());
+    TEST_ASSERT_EQUAL(26, histogram.mean().count());
+    TEST_ASSERT_EQUAL(3, histogram.percentile(0.75f).count());
+    TEST_ASSERT_EQUAL(100, histogram.percentile(1.0f).count());
+
+    // Too large for any bucket but the last.
+    histogram.record(std::chrono::hours(1));
+    TEST_ASSERT_EQUAL(1, histogram.buckets[TimerHistogram::kBuckets - 1]);
+}
+
+TEST_CASE("Timer stats", "[Timer]") {
+    std::expected<TimerPtr, esp_err_t> plain = ESP32::sharedESP32()->timer(
+        {.callback = busyCallback, .userInfo = nullptr, .dispatchMethod = TimerDispatchMethod::Task, .name = "plain", .skipUnhandledEvents = true});
+    TEST_ASSERT_TRUE(plain.has_value());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, (*plain)->stats().error());
+
+    std::expected<TimerPtr, esp_err_t> timer = ESP32::sharedESP32()->timer({.callback = busyCallback,
+                                                                             .userInfo = nullptr,
+                                                                             .dispatchMethod = TimerDispatchMethod::Task,
+                                                                             .name = "instrumented",
+                                                                             .skipUnhandledEvents = true,
+                                                                             .collectStats = true});
+    TEST_ASSERT_TRUE(timer.has_value());
+    TEST_ASSERT_EQUAL(ESP_OK, (*timer)->startPeriodic(2ms));
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    (*timer)->stop();
+
+    std::expected<TimerStats, esp_err_t> stats = (*timer)->stats();
+    TEST_ASSERT_TRUE(stats.has_value());
+    TEST_ASSERT_GREATER_OR_EQUAL(20, stats->lateness.count);
+    TEST_ASSERT_EQUAL(stats->lateness.count, stats->duration.count);
+    TEST_ASSERT_GREATER_OR_EQUAL(200, stats->duration.min.count());
+    // Nothing else is loading the esp_timer task.
+    TEST_ASSERT_LESS_THAN(2000, stats->lateness.percentile(0.5f).count());
+
+    const auto all = Timer::allStats();
+    TEST_ASSERT_EQUAL(1, std::count_if(all.begin(), all.end(), [](const auto& entry) { return entry.first == "instrumented"; }));
+    TEST_ASSERT_EQUAL(0, std::count_if(all.begin(), all.end(), [](const auto& entry) { return entry.first == "plain"; }));
+    Timer::logStats();
+
+    (*timer)->resetStats();
+    TEST_ASSERT_EQUAL(0, (*timer)->stats()->lateness.count);
+
+    timer->reset();
+    const auto remaining = Timer::allStats();
+    TEST_ASSERT_EQUAL(0, std::count_if(remaining.begin(), remaining.end(), [](const auto& entry) { return entry.first == "instrumented"; }));
+}
+
+TEST_CASE("Timer with an inline callable", "[Timer]") {
+    std::atomic<uint32_t> fires = 0;
+    uint32_t step = 3;
+    std::expected<TimerPtr, esp_err_t> timer = ESP32::sharedESP32()->timer(
+        {.dispatchMethod = TimerDispatchMethod::Task, .name = "inline", .skipUnhandledEvents = true}, [&fires, step](Timer& timer) {
+            fires += step;
+            if (fires >= 3 * step) {
+                timer.stop();
+            }
+        });
+    TEST_ASSERT_TRUE(timer.has_value());
+    TEST_ASSERT_EQUAL(ESP_OK, (*timer)->startPeriodic(2ms));
+
+    vTaskDelay(20 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(9, fires.load());
+    TEST_ASSERT_FALSE((*timer)->isActive());
+}
+
+TEST_CASE("Timer keeps firing after being moved", "[Timer]") {
+    std::atomic<uint32_t> fires = 0;
+    std::expected<TimerPtr, esp_err_t> timer = ESP32::sharedESP32()->timer(
+        {.dispatchMethod = TimerDispatchMethod::Task, .name = "moved", .skipUnhandledEvents = true}, [&fires](Timer&) { fires++; });
+    TEST_ASSERT_TRUE(timer.has_value());
+    TEST_ASSERT_EQUAL(ESP_OK, (*timer)->startPeriodic(2ms));
+
+    // The source is destroyed, so any fire still reaching it would be a use after free.
+    Timer moved(std::move(**timer));
+    timer->reset();
+    vTaskDelay(20 / portTICK_PERIOD_MS);
+    const uint32_t afterConstruct = fires.load();
+    TEST_ASSERT_GREATER_OR_EQUAL(5, afterConstruct);
+
+    std::expected<TimerPtr, esp_err_t> target = ESP32::sharedESP32()->timer(
+        {.callback = busyCallback, .userInfo = nullptr, .dispatchMethod = TimerDispatchMethod::Task, .name = "target", .skipUnhandledEvents = true});
+    TEST_ASSERT_TRUE(target.has_value());
+    **target = std::move(moved);
+    vTaskDelay(20 / portTICK_PERIOD_MS);
+    TEST_ASSERT_GREATER_OR_EQUAL(afterConstruct + 5, fires.load());
+    TEST_ASSERT_TRUE((*target)->isActive());
+    TEST_ASSERT_EQUAL(ESP_OK, (*target)->stop());
+}
+
+struct Tracked {
+    explicit Tracked(int* alive) : alive(alive) { (*alive)++; }
+    Tracked(Tracked&& other) noexcept : alive(other.alive) { (*alive)++; }
+    ~Tracked() { (*alive)--; }
+    int operator()(int value) const { return value * 2; }
+
+    int* alive;
+};
+
+TEST_CASE("InplaceFunction moves and destroys its callable", "[Timer]") {
+    int alive = 0;
+    {
+        InplaceFunction<int(int), 16> function = Tracked(&alive);
+        TEST_ASSERT_EQUAL(1, alive);
+        TEST_ASSERT_EQUAL(42, function(21));
+
+        InplaceFunction<int(int), 16> moved = std::move(function);
+        TEST_ASSERT_EQUAL(1, alive);
+        TEST_ASSERT_FALSE(static_cast<bool>(function));
+        TEST_ASSERT_EQUAL(10, moved(5));
+
+        moved = nullptr;
+        TEST_ASSERT_EQUAL(0, alive);
+        moved = Tracked(&alive);
+    }
+    TEST_ASSERT_EQUAL(0, alive);
+}
+
+static void countCallback(Timer& timer, void* userInfo) {
+    (void)timer;
+    (*static_cast<std::atomic<uint32_t>*>(userInfo))++;
+}
+
+TEST_CASE("Timers with slack share wakeups", "[Timer]") {
+    constexpr size_t kTimers = 3;
+    std::atomic<uint32_t> fires[kTimers] = {};
+    TimerPtr timers[kTimers];
+    const TimerCoalescingStats before = Timer::coalescingStats();
+
+    for (size_t i = 0; i < kTimers; i++) {
+        std::expected<TimerPtr, esp_err_t> timer = ESP32::sharedESP32()->timer(
+            {.callback = countCallback, .userInfo = &fires[i], .dispatchMethod = TimerDispatchMethod::Task, .name = "slack", .skipUnhandledEvents = false});
+        TEST_ASSERT_TRUE(timer.has_value());
+        timers[i] = *timer;
+        // Deadlines a millisecond apart, well inside each other's slack.
+        TEST_ASSERT_EQUAL(ESP_OK, timers[i]->startPeriodic(10ms, 3ms));
+        TEST_ASSERT_EQUAL(10000, timers[i]->duration()->count());
+        esp_rom_delay_us(1000);
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, timers[0]->startPeriodic(10ms, 3ms));
+
+    vTaskDelay(105 / portTICK_PERIOD_MS);
+    for (TimerPtr& timer : timers) {
+        TEST_ASSERT_EQUAL(ESP_OK, timer->stop());
+    }
+
+    const TimerCoalescingStats after = Timer::coalescingStats();
+    const uint32_t arms = after.arms - before.arms;
+    const uint32_t slackFires = after.fires - before.fires;
+    const uint32_t coalesced = after.coalesced - before.coalesced;
+    printf("%lu arms, %lu fires, %lu coalesced\n", static_cast<unsigned long>(arms), static_cast<unsigned long>(slackFires),
+           static_cast<unsigned long>(coalesced));
+    for (std::atomic<uint32_t>& count : fires) {
+        TEST_ASSERT_UINT32_WITHIN(1, 10, count.load());
+    }
+    // All but the first timer each period should fire on its alarm.
+    TEST_ASSERT_GREATER_OR_EQUAL(slackFires / 2, coalesced);
+}
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+TEST_CASE("Slack needs task dispatch", "[Timer]") {
+    std::atomic<uint32_t> fires = 0;
+    std::expected<TimerPtr, esp_err_t> timer = ESP32::sharedESP32()->timer(
+        {.callback = countCallback, .userInfo = &fires, .dispatchMethod = TimerDispatchMethod::ISR, .name = "isr_slack", .skipUnhandledEvents = false});
+    TEST_ASSERT_TRUE(timer.has_value());
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, (*timer)->startOneshot(1ms, 1ms));
+}
+
+static IRAM_ATTR void rearmCallback(Timer& timer, void* userInfo) {
+    std::atomic<uint32_t>& fires = *static_cast<std::atomic<uint32_t>*>(userInfo);
+    if (++fires < 5) {
+        timer.startOneshot(1ms);
+    }
+}
+
+TEST_CASE("Timer without slack restarted from an ISR dispatched callback", "[Timer]") {
+    std::atomic<uint32_t> fires = 0;
+    std::expected<TimerPtr, esp_err_t> timer = ESP32::sharedESP32()->timer(
+        {.callback = rearmCallback, .userInfo = &fires, .dispatchMethod = TimerDispatchMethod::ISR, .name = "isr_rearm", .skipUnhandledEvents = false});
+    TEST_ASSERT_TRUE(timer.has_value());
+
+    // Starting without slack takes no lock, so it's fine from the ISR.
+    TEST_ASSERT_EQUAL(ESP_OK, (*timer)->startOneshot(1ms));
+    vTaskDelay(20 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(5, fires.load());
+    TEST_ASSERT_FALSE((*timer)->isActive());
+}
+#endif
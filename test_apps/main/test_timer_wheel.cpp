@@ -0,0 +1,157 @@
+extern "C" {
+#include <unity.h>
+}
+#include <freertos/FreeRTOS.h>
+
+#include "ESP32.hpp"
+#include "TimerWheel.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace esp;
+using namespace std::chrono_literals;
+
+struct Fired {
+    std::atomic<size_t> count = 0;
+    std::atomic<int64_t> lastTime = 0;
+};
+
+static void onFire(TimerWheel& wheel, void* userInfo) {
+    (void)wheel;
+    Fired* fired = static_cast<Fired*>(userInfo);
+    fired->lastTime = Timer::now().count();
+    fired->count++;
+}
+
+static void onTimeout(Timer& timer, void* userInfo) {
+    (void)timer;
+    (void)userInfo;
+}
+
+TEST_CASE("Wheel timers fire after their duration", "[TimerWheel]") {
+    esp_err_t err = ESP_OK;
+    TimerWheelPtr wheel = ESP32::sharedESP32()->timerWheel({.tick = 1ms, .capacity = 8}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_NOT_NULL(wheel);
+
+    Fired shortFired;
+    Fired longFired;
+    const int64_t start = Timer::now().count();
+    wheel->start(5ms, onFire, &shortFired, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    // Past the first level, so it has to cascade down.
+    wheel->start(150ms, onFire, &longFired, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(2, wheel->activeTimers());
+
+    vTaskDelay(200 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(1, shortFired.count.load());
+    TEST_ASSERT_EQUAL(1, longFired.count.load());
+    TEST_ASSERT_GREATER_OR_EQUAL(start + 5000, shortFired.lastTime.load());
+    TEST_ASSERT_GREATER_OR_EQUAL(start + 150000, longFired.lastTime.load());
+    TEST_ASSERT_LESS_THAN(start + 170000, longFired.lastTime.load());
+    TEST_ASSERT_EQUAL(0, wheel->activeTimers());
+}
+
+TEST_CASE("Cancelled and stale wheel handles", "[TimerWheel]") {
+    esp_err_t err = ESP_OK;
+    TimerWheelPtr wheel = ESP32::sharedESP32()->timerWheel({.tick = 1ms, .capacity = 2}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    Fired fired;
+    TimerWheelHandle cancelled = wheel->start(10ms, onFire, &fired, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_TRUE(wheel->isActive(cancelled));
+    TEST_ASSERT_TRUE(wheel->cancel(cancelled));
+    TEST_ASSERT_FALSE(wheel->cancel(cancelled));
+    TEST_ASSERT_FALSE(wheel->isActive(cancelled));
+
+    // Reuses the cancelled timer's node, which the stale handle must not reach.
+    TimerWheelHandle reused = wheel->start(10ms, onFire, &fired, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    TEST_ASSERT_EQUAL(cancelled.index, reused.index);
+    TEST_ASSERT_FALSE(wheel->cancel(cancelled));
+    TEST_ASSERT_TRUE(wheel->isActive(reused));
+
+    wheel->start(10ms, onFire, &fired, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+    wheel->start(10ms, onFire, &fired, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, err);
+
+    vTaskDelay(50 / portTICK_PERIOD_MS);
+    TEST_ASSERT_EQUAL(2, fired.count.load());
+    TEST_ASSERT_FALSE(wheel->cancel(reused));
+}
+
+TEST_CASE("Wheel timers beyond the top level", "[TimerWheel]") {
+    esp_err_t err = ESP_OK;
+    // Ticks too long to pass during the test, so advance drives the wheel alone.
+    TimerWheelPtr wheel = ESP32::sharedESP32()->timerWheel({.tick = std::chrono::hours(1), .capacity = 4}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    constexpr uint64_t kTicks[] = {1, 64, 5000, (uint64_t(1) << 24) + 100};
+    Fired fired[std::size(kTicks)];
+    TimerWheelHandle handles[std::size(kTicks)];
+    for (size_t i = 0; i < std::size(kTicks); i++) {
+        handles[i] = wheel->start(std::chrono::hours(kTicks[i]), onFire, &fired[i], err);
+        TEST_ASSERT_EQUAL(ESP_OK, err);
+    }
+    // The first start is on tick 0 exactly.  The rest are a little into it, so round up to the next tick rather than fire early.
+    TEST_ASSERT_EQUAL(kTicks[0], handles[0].expiry);
+    for (size_t i = 1; i < std::size(kTicks); i++) {
+        TEST_ASSERT_TRUE(handles[i].expiry == kTicks[i] || handles[i].expiry == kTicks[i] + 1);
+    }
+
+    for (size_t i = 0; i < std::size(kTicks); i++) {
+        wheel->advance(handles[i].expiry - 1);
+        TEST_ASSERT_EQUAL(0, fired[i].count.load());
+        TEST_ASSERT_TRUE(wheel->isActive(handles[i]));
+        wheel->advance(handles[i].expiry);
+        TEST_ASSERT_EQUAL(1, fired[i].count.load());
+    }
+}
+
+TEST_CASE("Invalid timer wheel", "[TimerWheel]") {
+    esp_err_t err = ESP_OK;
+    TimerWheelPtr wheel = ESP32::sharedESP32()->timerWheel({.capacity = 0}, err);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, err);
+    TEST_ASSERT_NULL(wheel);
+}
+
+TEST_CASE("TimerWheel benchmark", "[TimerWheel][benchmark]") {
+    // As many native timers as fit in internal RAM alongside the test app.
+    constexpr size_t kTimers = 2000;
+
+    esp_err_t err = ESP_OK;
+    TimerWheelPtr wheel = ESP32::sharedESP32()->timerWheel({.tick = 1ms, .capacity = kTimers}, err);
+    TEST_ASSERT_EQUAL(ESP_OK, err);
+
+    std::vector<TimerWheelHandle> handles(kTimers);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kTimers; i++) {
+        handles[i] = wheel->start(std::chrono::milliseconds(1000 + i), onFire, nullptr, err);
+    }
+    for (TimerWheelHandle handle : handles) {
+        wheel->cancel(handle);
+    }
+    const auto wheelTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    std::vector<TimerPtr> timers;
+    timers.reserve(kTimers);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < kTimers; i++) {
+        std::expected<TimerPtr, esp_err_t> timer = ESP32::sharedESP32()->timer(
+            {.callback = onTimeout, .userInfo = nullptr, .dispatchMethod = TimerDispatchMethod::Task, .name = "bench", .skipUnhandledEvents = true});
+        TEST_ASSERT_TRUE(timer.has_value());
+        (*timer)->startOneshot(std::chrono::milliseconds(1000 + i));
+        timers.push_back(*timer);
+    }
+    timers.clear();
+    const auto nativeTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    printf("%zu timers started and cancelled: wheel %lld us, esp::Timer %lld us\n", kTimers, static_cast<long long>(wheelTime.count()),
+           static_cast<long long>(nativeTime.count()));
+}